@@ -42,6 +42,9 @@ PHP_ARG_ENABLE(coroutine-postgresql, enable coroutine postgresql support,
 PHP_ARG_ENABLE(cares, enable c-ares support,
 [  --enable-cares            Use cares?], no, no)
 
+PHP_ARG_ENABLE(iouring, enable io_uring support,
+[  --enable-iouring          Use io_uring for coroutine file operations?], no, no)
+
 PHP_ARG_WITH(cares_dir, dir of c-ares,
 [  --with-cares-dir[=DIR]      Include c-ares support], no, no)
 
@@ -226,6 +229,8 @@ if test "$PHP_SWOOLE" != "no"; then
     AC_CHECK_LIB(c, epoll_create, AC_DEFINE(HAVE_EPOLL, 1, [have epoll]))
     AC_CHECK_LIB(c, poll, AC_DEFINE(HAVE_POLL, 1, [have poll]))
     AC_CHECK_LIB(c, sendfile, AC_DEFINE(HAVE_SENDFILE, 1, [have sendfile]))
+    AC_CHECK_LIB(c, recvmmsg, AC_DEFINE(HAVE_RECVMMSG, 1, [have recvmmsg]))
+    AC_CHECK_LIB(c, sendmmsg, AC_DEFINE(HAVE_SENDMMSG, 1, [have sendmmsg]))
     AC_CHECK_LIB(c, kqueue, AC_DEFINE(HAVE_KQUEUE, 1, [have kqueue]))
     AC_CHECK_LIB(c, backtrace, AC_DEFINE(HAVE_EXECINFO, 1, [have execinfo]))
     AC_CHECK_LIB(c, daemon, AC_DEFINE(HAVE_DAEMON, 1, [have daemon]))
@@ -418,6 +423,7 @@ if test "$PHP_SWOOLE" != "no"; then
         src/coroutine/context.cc \
         src/coroutine/hook.cc \
         src/coroutine/socket.cc \
+        src/coroutine/stack.cc \
         src/coroutine/ucontext.cc \
         src/factory/base.c \
         src/factory/process.c \
@@ -435,6 +441,7 @@ if test "$PHP_SWOOLE" != "no"; then
         src/memory/ring_buffer.c \
         src/memory/shared_memory.c \
         src/memory/table.c \
+        src/network/async_iouring.cc \
         src/network/async_thread.cc \
         src/network/cares.cc \
         src/network/client.c \
@@ -485,6 +492,7 @@ if test "$PHP_SWOOLE" != "no"; then
         swoole_channel_coro.cc \
         swoole_client.cc \
         swoole_client_coro.cc \
+        swoole_connection_pool_coro.cc \
         swoole_coroutine.cc \
         swoole_coroutine_util.cc \
         swoole_event.c \
@@ -609,6 +617,19 @@ if test "$PHP_SWOOLE" != "no"; then
         PHP_ADD_LIBRARY(cares, 1, SWOOLE_SHARED_LIBADD)
     fi
 
+    if test "$PHP_IOURING" = "yes"; then
+        AC_CHECK_HEADER(linux/io_uring.h, [], [
+            AC_MSG_ERROR([linux/io_uring.h not found, kernel headers 5.15 or later are required])
+        ])
+        dnl the ops hooked by the io_uring file system backend, IORING_OP_MKDIRAT is the newest one (5.15)
+        m4_foreach_w([sw_iouring_op], [IORING_OP_READ IORING_OP_WRITE IORING_OP_OPENAT IORING_OP_STATX IORING_OP_RENAMEAT IORING_OP_UNLINKAT IORING_OP_MKDIRAT], [
+            AC_CHECK_DECL(sw_iouring_op, [], [
+                AC_MSG_ERROR([sw_iouring_op not found in linux/io_uring.h, kernel headers 5.15 or later are required])
+            ], [#include <linux/io_uring.h>])
+        ])
+        AC_DEFINE(SW_USE_IOURING, 1, [enable io_uring support])
+    fi
+
     PHP_NEW_EXTENSION(swoole, $swoole_source_file, $ext_shared,,, cxx)
 
     PHP_ADD_INCLUDE([$ext_srcdir])
@@ -0,0 +1,34 @@
+<?php
+/**
+ * AIO thread pool throughput, ops/sec versus thread count
+ * php benchmark.php [thread_num] [concurrency] [requests]
+ */
+$concurrency = intval($argv[2] ?? 256);
+$requests = intval($argv[3] ?? 200000);
+
+if (!isset($argv[1])) {
+    foreach ([1, 2, 4, 8, 16, 32] as $thread_num) {
+        passthru(PHP_BINARY . ' ' . __FILE__ . " {$thread_num} {$concurrency} {$requests}");
+    }
+    exit;
+}
+
+$thread_num = intval($argv[1]);
+swoole_async_set(['thread_num' => $thread_num]);
+
+$done = 0;
+$s = microtime(true);
+for ($c = 0; $c < $concurrency; $c++) {
+    go(function () use ($concurrency, $requests, &$done) {
+        $fp = fopen(__FILE__, 'r');
+        for ($i = 0; $i < $requests / $concurrency; $i++) {
+            co::fread($fp, 512);
+            fseek($fp, 0);
+            $done++;
+        }
+        fclose($fp);
+    });
+}
+swoole_event_wait();
+$use = microtime(true) - $s;
+printf("thread_num=%-3d ops=%d time=%.3fs ops/sec=%d\n", $thread_num, $done, $use, $done / $use);
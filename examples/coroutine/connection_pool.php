@@ -0,0 +1,36 @@
+<?php
+$http = new swoole_http_server("127.0.0.1", 9501, SWOOLE_BASE);
+$http->set(array(
+    'log_file' => '/dev/null'
+));
+
+$http->on('WorkerStart', function (swoole_http_server $serv, $worker_id) {
+    //each worker owns its connections
+    $serv->redis = new Co\ConnectionPool(function () {
+        $redis = new Co\Redis;
+        return $redis->connect('127.0.0.1', 6379) ? $redis : false;
+    }, 32);
+    $serv->redis->set([
+        'min_size' => 4,
+        'idle_time' => 30,
+        'wait_timeout' => 3,
+    ]);
+    go(function () use ($serv) {
+        $serv->redis->fill();
+    });
+});
+
+$http->on('request', function (swoole_http_request $request, swoole_http_response $response) use ($http) {
+    $redis = $http->redis->get();
+    if ($redis === false) {
+        $response->status(503);
+        $response->end(json_encode($http->redis->stats()));
+        return;
+    }
+    $value = $redis->incr('counter');
+    //give back the slot rather than the connection if it failed
+    $http->redis->put($value === false ? null : $redis);
+    $response->end("counter: $value\n");
+});
+
+$http->start();
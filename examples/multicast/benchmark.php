@@ -0,0 +1,49 @@
+<?php
+/**
+ * udp echo throughput, packets/sec versus client process count
+ * php benchmark.php [packets per client] [window] [base|process]
+ */
+$requests = intval($argv[1] ?? 200000);
+$window = intval($argv[2] ?? 64);
+$mode = ($argv[3] ?? 'base') == 'process' ? SWOOLE_PROCESS : SWOOLE_BASE;
+$port = 9905;
+
+$server = new swoole_process(function () use ($port, $mode) {
+    $serv = new swoole_server('127.0.0.1', $port, $mode, SWOOLE_SOCK_UDP);
+    $serv->set(['worker_num' => 1, 'log_level' => SWOOLE_LOG_WARNING]);
+    $serv->on('Packet', function (swoole_server $serv, $data, $addr) {
+        $serv->sendto($addr['address'], $addr['port'], $data);
+    });
+    $serv->start();
+});
+$server->start();
+usleep(500000);
+
+foreach ([1, 2, 4, 8] as $client_num) {
+    $s = microtime(true);
+    for ($n = 0; $n < $client_num; $n++) {
+        (new swoole_process(function () use ($port, $requests, $window) {
+            $client = new swoole_client(SWOOLE_SOCK_UDP, SWOOLE_SOCK_SYNC);
+            $client->set(['socket_buffer_size' => 4 * 1024 * 1024]);
+            $client->connect('127.0.0.1', $port, 1);
+            $sent = $recv = 0;
+            //keep [window] packets in flight, a lost one shows up as a one second stall
+            while ($recv < $requests) {
+                for (; $sent < $requests and $sent - $recv < $window; $sent++) {
+                    $client->send("packet-{$sent}");
+                }
+                $client->recv();
+                $recv++;
+            }
+        }))->start();
+    }
+    for ($n = 0; $n < $client_num; $n++) {
+        swoole_process::wait();
+    }
+    $use = microtime(true) - $s;
+    printf("clients=%-2d packets=%d time=%.3fs packets/sec=%d\n", $client_num, $client_num * $requests, $use,
+        $client_num * $requests / $use);
+}
+
+swoole_process::kill($server->pid, SIGTERM);
+swoole_process::wait();
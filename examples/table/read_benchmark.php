@@ -0,0 +1,43 @@
+<?php
+/**
+ * hot key read contention, reads/sec versus reader process count, with one writer updating the same keys
+ * php read_benchmark.php [requests per reader] [hot keys]
+ */
+$requests = intval($argv[1] ?? 1000000);
+$key_num = intval($argv[2] ?? 8);
+
+$table = new swoole_table(1024);
+$table->column('tokens', swoole_table::TYPE_INT);
+$table->column('updated', swoole_table::TYPE_FLOAT);
+$table->create();
+for ($i = 0; $i < $key_num; $i++) {
+    $table->set("user_{$i}", ['tokens' => 100, 'updated' => microtime(true)]);
+}
+
+foreach ([1, 2, 4, 8, 16, 32, 48] as $reader_num) {
+    $writer = new swoole_process(function () use ($table, $key_num) {
+        for ($i = 0; ; $i++) {
+            $table->set('user_' . ($i % $key_num), ['tokens' => $i, 'updated' => microtime(true)]);
+            usleep(10);
+        }
+    });
+    $writer->start();
+
+    $s = microtime(true);
+    for ($n = 0; $n < $reader_num; $n++) {
+        (new swoole_process(function () use ($table, $requests, $key_num) {
+            for ($i = 0; $i < $requests; $i++) {
+                $table->get('user_' . ($i % $key_num), 'tokens');
+            }
+        }))->start();
+    }
+    for ($n = 0; $n < $reader_num; $n++) {
+        swoole_process::wait();
+    }
+    $use = microtime(true) - $s;
+
+    swoole_process::kill($writer->pid, SIGKILL);
+    swoole_process::wait();
+    printf("readers=%-3d reads=%d time=%.3fs reads/sec=%d\n", $reader_num, $reader_num * $requests, $use,
+        $reader_num * $requests / $use);
+}
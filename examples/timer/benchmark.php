@@ -0,0 +1,39 @@
+<?php
+/**
+ * php benchmark.php [wheel|heap] [timer_num]
+ */
+$backend = $argv[1] ?? 'wheel';
+$n = intval($argv[2] ?? 1000000);
+
+swoole_async_set([
+    'use_timer_wheel' => $backend == 'wheel',
+]);
+
+$fired = 0;
+$callback = function () use (&$fired) {
+    $fired++;
+};
+
+$s = microtime(true);
+$timers = [];
+for ($i = 0; $i < $n; $i++) {
+    $timers[] = swoole_timer_after(1000 + mt_rand(0, 2000), $callback);
+}
+echo "[$backend] add $n timers: " . round(microtime(true) - $s, 3) . "s\n";
+
+$s = microtime(true);
+for ($i = 0; $i < $n; $i += 2) {
+    swoole_timer_clear($timers[$i]);
+}
+echo "[$backend] clear " . ($n / 2) . " timers: " . round(microtime(true) - $s, 3) . "s\n";
+
+function cpu_time()
+{
+    $r = getrusage();
+    return $r['ru_utime.tv_sec'] + $r['ru_utime.tv_usec'] / 1000000 + $r['ru_stime.tv_sec'] + $r['ru_stime.tv_usec'] / 1000000;
+}
+
+//timers are spread over 1~3 seconds, so compare the cpu time spent rather than the wall time
+$s = cpu_time();
+swoole_event_wait();
+echo "[$backend] fire $fired timers: " . round(cpu_time() - $s, 3) . "s cpu\n";
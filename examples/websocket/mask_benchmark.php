@@ -0,0 +1,30 @@
+<?php
+/**
+ * masked frame pack/unpack throughput, MB/sec versus frame size
+ * php mask_benchmark.php [total_mb]
+ */
+use swoole_websocket_frame as f;
+
+$total = intval($argv[1] ?? 1024) * 1024 * 1024;
+
+foreach ([64, 256, 1024, 4096, 16384, 65536, 262144, 1048576] as $size) {
+    $data = str_repeat('A', $size);
+    assert(f::unpack(f::pack($data, WEBSOCKET_OPCODE_BINARY, true, true))->data === $data);
+    $n = max(1, intval($total / $size));
+
+    $s = microtime(true);
+    for ($i = 0; $i < $n; $i++) {
+        $packed = f::pack($data, WEBSOCKET_OPCODE_BINARY, true, true);
+    }
+    $pack_use = microtime(true) - $s;
+
+    $s = microtime(true);
+    for ($i = 0; $i < $n; $i++) {
+        //unpack unmasks the payload in place, every round flips the same buffer back and forth
+        f::unpack($packed);
+    }
+    $unpack_use = microtime(true) - $s;
+
+    printf("size=%-8d frames=%-9d pack=%8.1fMB/s unpack=%8.1fMB/s\n", $size, $n,
+        $n * $size / $pack_use / 1048576, $n * $size / $unpack_use / 1048576);
+}
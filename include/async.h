@@ -37,6 +37,13 @@ enum swAioOpcode
     SW_AIO_FGETS,
     SW_AIO_READ_FILE,
     SW_AIO_WRITE_FILE,
+    SW_AIO_OPEN,
+    SW_AIO_FSTAT,
+    SW_AIO_UNLINK,
+    SW_AIO_MKDIR,
+    SW_AIO_RMDIR,
+    SW_AIO_RENAME,
+    SW_AIO_OPCODE_MAX,
 };
 
 enum swAioFlag
@@ -69,6 +76,8 @@ typedef void (*swAio_handler)(swAio_event *event);
 typedef struct
 {
     uint8_t init;
+    uint8_t iouring_init;
+    uint8_t use_iouring;
     uint16_t min_thread_count;
     uint16_t max_thread_count;
     uint32_t task_num;
@@ -82,6 +91,12 @@ int swAio_dispatch(const swAio_event *request);
 swAio_event* swAio_dispatch2(const swAio_event *request);
 int swAio_cancel(int task_id);
 
+#ifdef SW_USE_IOURING
+int swAio_iouring_init(void);
+int swAio_iouring_dispatch(swAio_event *event);
+void swAio_iouring_free(void);
+#endif
+
 void swAio_handler_read(swAio_event *event);
 void swAio_handler_write(swAio_event *event);
 void swAio_handler_gethostbyname(swAio_event *event);
@@ -32,51 +32,32 @@ typedef void (*coroutine_func_t)(void*);
 namespace swoole
 {
 //namespace start
-static uint32_t& get_protect_stack_page()
+/**
+ * mmap'd coroutine stacks with a permanent guard page below them, recycled per thread
+ */
+class StackPool
 {
-    static uint32_t protect_stack_page = 0;
-    return protect_stack_page;
-}
+public:
+    static char* alloc(size_t stack_size);
+    static void free(char *stack, size_t stack_size);
 
-static bool protect_stack(void *top, size_t stack_size, uint32_t page)
-{
-    if (stack_size <= SwooleG.pagesize * (page + 1))
-    {
-        swoole_error_log(SW_LOG_ERROR, SW_ERROR_CO_PROTECT_STACK_FAILED, "getpagesize() failed.");
-        return false;
-    }
-#ifdef PROT_NONE
-    void *protect_page_addr = ((size_t) top & 0xfff) ? (void*) (((size_t) top & ~(size_t) 0xfff) + 0x1000) : top;
-    if (-1 == mprotect(protect_page_addr, SwooleG.pagesize * page, PROT_NONE))
-    {
-        swSysError("mprotect() failed: origin_addr:%p, align_addr:%p, page_size:%d, protect_page:%u.", top,
-                protect_page_addr, SwooleG.pagesize, page);
-        return false;
-    }
-    else
-    {
-        swDebug("origin_addr:%p, align_addr:%p, page_size:%d, protect_page:%u", top, protect_page_addr, page, SwooleG.pagesize);
-        return true;
-    }
-#endif
-}
-static bool unprotect_stack(void *top, uint32_t page)
-{
-    void *protect_page_addr = ((size_t) top & 0xfff) ? (void*) (((size_t) top & ~(size_t) 0xfff) + 0x1000) : top;
-#ifdef PROT_READ
-    if (-1 == mprotect(protect_page_addr, SwooleG.pagesize * page, PROT_READ | PROT_WRITE))
+    static inline uint64_t get_hit()
     {
-        swSysError("mprotect() failed: origin_addr:%p, align_addr:%p, page_size:%d, protect_page:%u.", top,
-                protect_page_addr, SwooleG.pagesize, page);
-        return false;
+        return hit;
     }
-    else
+
+    static inline uint64_t get_miss()
     {
-        swDebug("origin_addr:%p, align_addr:%p, page_size:%d, protect_page:%u.", top, protect_page_addr, page, SwooleG.pagesize);
-        return true;
+        return miss;
     }
-#endif
-}
+
+    static size_t count();
+
+private:
+    static thread_local uint64_t hit;
+    static thread_local uint64_t miss;
+};
+
 class Context
 {
 public:
@@ -102,7 +83,6 @@ private:
     coroutine_func_t fn_;
     char* stack_;
     uint32_t stack_size_;
-    uint32_t protect_page_;
 #ifdef USE_VALGRIND
     uint32_t valgrind_stack_id;
 #endif
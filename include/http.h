@@ -91,6 +91,12 @@ enum swHttpStatusCode
     SW_HTTP_INSUFFICIENT_STORAGE = 507
 };
 
+enum swHttp_accept_encoding
+{
+    SW_HTTP_ACCEPT_GZIP = 1u << 0,
+    SW_HTTP_ACCEPT_BR   = 1u << 1,
+};
+
 typedef struct _swHttpRequest
 {
     uint8_t method;
@@ -99,11 +105,15 @@ typedef struct _swHttpRequest
     uint8_t opcode;
     uint8_t excepted;
     uint8_t keep_alive;
+    uint8_t accept_encoding;
+    uint8_t expect_continue;
+    uint8_t header_parsed;
 
     uint32_t url_offset;
     uint32_t url_length;
 
     uint32_t header_length;
+    uint32_t header_scan_offset;
     uint32_t content_length;
     swString *buffer;
 
@@ -91,6 +91,12 @@ enum swTaskIPCMode
     SW_TASK_IPC_STREAM      = 4,
 };
 
+enum swReactorDispatchMode
+{
+    SW_REACTOR_DISPATCH_FDMOD      = 1,
+    SW_REACTOR_DISPATCH_LEAST_CONN = 2,
+};
+
 enum swResponseType
 {
     SW_RESPONSE_SMALL = 0,
@@ -118,13 +124,37 @@ enum swTaskType
     SW_TASK_WAITALL    = 16, //for taskWaitAll
     SW_TASK_COROUTINE  = 32, //coroutine
     SW_TASK_PEEK       = 64, //peek
+    SW_TASK_NOSTEAL    = 128, //sent to the given task worker, never stolen
 };
 
+typedef struct
+{
+    int fd;
+    uint32_t session_id;
+    uint16_t worker_id;
+} swPausedConnection;
+
 typedef struct _swReactorThread
 {
     pthread_t thread_id;
     swReactor reactor;
     int notify_pipe;
+    /**
+     * live connections of the reactor thread
+     */
+    sw_atomic_t connection_num;
+    /**
+     * idle wheel, the first fd of each slot, a slot is heartbeat_check_interval wide
+     */
+    int *idle_slots;
+    uint32_t idle_slot_num;
+    time_t idle_tick;
+    /**
+     * connections paused while the worker they were dispatched to is over the pipe backlog budget
+     */
+    swPausedConnection *paused_list;
+    uint32_t paused_num;
+    uint32_t paused_size;
 } swReactorThread;
 
 typedef struct _swListenPort
@@ -158,6 +188,11 @@ typedef struct _swListenPort
     uint8_t ssl;
     int port;
     int sock;
+    /**
+     * SO_REUSEPORT, a listen socket for each reactor thread, sock is the first one
+     */
+    int *reactor_socks;
+    uint16_t reactor_sock_num;
     pthread_t thread_id;
     char host[SW_HOST_MAXSIZE];
 
@@ -290,6 +325,11 @@ struct _swFactory
 typedef struct _swFactoryProcess
 {
     swPipe *pipes;
+    /**
+     * worker of each pipe, indexed by pipe_master
+     */
+    swWorker **pipe_workers;
+    int pipe_workers_size;
 } swFactoryProcess;
 
 typedef int (*swServer_dispatch_function)(swServer *, swConnection *, swEventData *);
@@ -383,6 +423,11 @@ struct _swServer
      */
     uint8_t dispatch_mode;
 
+    /**
+     * the reactor thread of a connection accepted by the master thread
+     */
+    uint8_t reactor_dispatch_mode;
+
     /**
      * No idle work process is available.
      */
@@ -430,7 +475,7 @@ struct _swServer
      */
     uint32_t open_cpu_affinity :1;
     /**
-     * disable notice when use SW_DISPATCH_ROUND and SW_DISPATCH_QUEUE
+     * disable notice when use SW_DISPATCH_ROUND, SW_DISPATCH_QUEUE and SW_DISPATCH_LEAST_LOAD
      */
     uint32_t disable_notify :1;
     /**
@@ -465,6 +510,10 @@ struct _swServer
      * enable coroutine in task worker
      */
     uint32_t task_enable_coroutine :1;
+    /**
+     * idle task workers steal the tasks queued on the busy ones
+     */
+    uint32_t task_enable_steal :1;
     /**
      * slowlog
      */
@@ -481,6 +530,10 @@ struct _swServer
      * disable multi-threads
      */
     uint32_t single_thread :1;
+    /**
+     * every reactor thread accepts on a SO_REUSEPORT listen socket of its own
+     */
+    uint32_t enable_reuse_port :1;
     /**
      *  heartbeat check time
      */
@@ -499,6 +552,11 @@ struct _swServer
     /* buffer output/input setting*/
     uint32_t buffer_output_size;
     uint32_t buffer_input_size;
+    /* ring of each worker for the big packages, 0 is off */
+    uint32_t dispatch_shm_size;
+    /* pipe backlog budget of a worker, 0 is unlimited */
+    uint32_t pipe_backlog_size;
+    uint32_t pipe_backlog_num;
 
     void *ptr2;
     void *private_data_3;
@@ -515,6 +573,8 @@ struct _swServer
     uint16_t task_max_request;
     swPipe *task_notify;
     swEventData *task_result;
+    uint32_t task_shm_size;
+    struct _swTaskShm *task_shm;
 
     /**
      * user process
@@ -548,6 +608,10 @@ struct _swServer
      * http compression level for gzip/br
      */
     uint8_t http_compression_level;
+    /**
+     * bodies kept compressed by each worker
+     */
+    uint32_t http_compression_cache;
 
     /**
      * http static file directory
@@ -626,6 +690,10 @@ struct _swServer
 typedef struct
 {
     size_t length;
+    /**
+     * the payload is in the slot of serv->task_shm if tmpfile is empty
+     */
+    uint32_t shm_slot;
     char tmpfile[SW_TASK_TMPDIR_SIZE + sizeof(SW_TASK_TMP_FILE)];
 } swPackage_task;
 
@@ -689,6 +757,7 @@ static sw_inline swListenPort* swServer_get_port(swServer *serv, int fd)
 }
 
 int swServer_udp_send(swServer *serv, swSendData *resp);
+int swServer_udp_sendto(swServer *serv, int server_sock, swSocketAddress *sa, char *data, uint32_t length);
 int swServer_tcp_send(swServer *serv, int fd, void *data, uint32_t length);
 int swServer_tcp_sendwait(swServer *serv, int fd, void *data, uint32_t length);
 int swServer_tcp_close(swServer *serv, int fd, int reset);
@@ -711,6 +780,28 @@ static sw_inline int swEventData_is_dgram(uint8_t type)
     }
 }
 
+/**
+ * the message which completes a request, the chunks of SW_EVENT_PACKAGE_START are not counted
+ */
+static sw_inline int swEventData_is_request(uint8_t type)
+{
+    switch (type)
+    {
+    case SW_EVENT_TCP:
+    case SW_EVENT_TCP6:
+    case SW_EVENT_UNIX_STREAM:
+    case SW_EVENT_PACKAGE:
+    case SW_EVENT_PACKAGE_PTR:
+    case SW_EVENT_PACKAGE_END:
+    case SW_EVENT_UDP:
+    case SW_EVENT_UDP6:
+    case SW_EVENT_UNIX_DGRAM:
+        return SW_TRUE;
+    default:
+        return SW_FALSE;
+    }
+}
+
 static sw_inline int swEventData_is_stream(uint8_t type)
 {
     switch (type)
@@ -755,6 +846,8 @@ int swTaskWorker_onFinish(swReactor *reactor, swEvent *event);
 void swTaskWorker_onStart(swProcessPool *pool, int worker_id);
 void swTaskWorker_onStop(swProcessPool *pool, int worker_id);
 int swTaskWorker_large_pack(swEventData *task, void *data, int data_len);
+int swTaskWorker_shm_create(swServer *serv);
+swString* swTaskWorker_shm_unpack(swPackage_task *pkg, int peek);
 int swTaskWorker_finish(swServer *serv, char *data, int data_len, int flags, swEventData *current_task);
 
 #define swTask_type(task)                  ((task)->info.from_fd)
@@ -764,6 +857,11 @@ static sw_inline swString* swTaskWorker_large_unpack(swEventData *task_result)
     swPackage_task _pkg;
     memcpy(&_pkg, task_result->data, sizeof(_pkg));
 
+    if (_pkg.tmpfile[0] == '\0')
+    {
+        return swTaskWorker_shm_unpack(&_pkg, swTask_type(task_result) & SW_TASK_PEEK);
+    }
+
     int tmp_file_fd = open(_pkg.tmpfile, O_RDONLY);
     if (tmp_file_fd < 0)
     {
@@ -904,6 +1002,22 @@ static sw_inline int swServer_worker_schedule(swServer *serv, int fd, swEventDat
             key = conn->uid;
         }
     }
+    //power of two choices, the one of two workers with less requests in flight
+    else if (serv->dispatch_mode == SW_DISPATCH_LEAST_LOAD)
+    {
+        uint32_t round = sw_atomic_fetch_add(&serv->worker_round_id, 1);
+        uint32_t first = round % serv->worker_num;
+        uint32_t second = ((round * 2654435761u) >> 16) % serv->worker_num;
+        if (second == first)
+        {
+            second = (first + 1) % serv->worker_num;
+        }
+        if ((int) serv->workers[second].inflight_num < (int) serv->workers[first].inflight_num)
+        {
+            return second;
+        }
+        return first;
+    }
     //schedule by dispatch function
     else if (serv->dispatch_mode == SW_DISPATCH_USERFUNC)
     {
@@ -967,6 +1081,13 @@ static sw_inline size_t swWorker_get_recv_data(swEventData *req, char **data_ptr
         *data_ptr = worker_buffer->str;
         length = worker_buffer->length;
     }
+    else if (req->info.type == SW_EVENT_PACKAGE)
+    {
+        swString package;
+        memcpy(&package, req->data, sizeof(package));
+        *data_ptr = package.str;
+        length = package.length;
+    }
     else if (req->info.type == SW_EVENT_PACKAGE_PTR)
     {
         swPackagePtr *task = (swPackagePtr *) req;
@@ -1052,6 +1173,7 @@ size_t  swWorker_get_recv_data(swEventData *req, char **data_ptr);
 
 int swReactorThread_create(swServer *serv);
 int swReactorThread_start(swServer *serv);
+int swReactorThread_reuse_port(swServer *serv);
 void swReactorThread_set_protocol(swServer *serv, swReactor *reactor);
 void swReactorThread_free(swServer *serv);
 int swReactorThread_close(swReactor *reactor, int fd);
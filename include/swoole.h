@@ -292,6 +292,7 @@ enum swFd_type
     SW_FD_ARES            = 16, //c-ares
     SW_FD_STREAM_CLIENT   = 17, //swClient stream
     SW_FD_DGRAM_CLIENT    = 18, //swClient dgram
+    SW_FD_IOURING         = 19, //io_uring completion eventfd
 };
 
 enum swBool_type
@@ -362,6 +363,7 @@ enum swFactory_dispatch_mode
     SW_DISPATCH_UIDMOD   = 5,
     SW_DISPATCH_USERFUNC = 6,
     SW_DISPATCH_STREAM   = 7,
+    SW_DISPATCH_LEAST_LOAD = 8,
 };
 
 enum swWorker_status
@@ -565,6 +567,10 @@ typedef struct _swConnection
     uint8_t http_upgrade;
     uint8_t http2_stream;
     uint8_t skip_recv;
+    /**
+     * reading paused until the worker drains its pipe backlog
+     */
+    uint8_t backpressure;
     //--------------------------------------------------------------
     /**
      * server is actively close the connection
@@ -633,6 +639,13 @@ typedef struct _swConnection
      */
     time_t last_time;
 
+    /**
+     * idle wheel of the reactor thread, slot + 1 or 0 if not linked, the connections of a slot are linked by fd
+     */
+    uint32_t idle_slot;
+    int idle_prev;
+    int idle_next;
+
 #ifdef SW_BUFFER_RECV_TIME
     /**
      * received time(microseconds) with last data
@@ -1393,6 +1406,7 @@ int swSocket_wait_multi(int *list_of_fd, int n_fd, int timeout_ms, int events);
 void swSocket_clean(int fd);
 ssize_t swSocket_sendto_blocking(int, void *, size_t, int, struct sockaddr *, socklen_t);
 int swSocket_set_buffer_size(int fd, int buffer_size);
+int swSocket_udp_address(swSocketAddress *sa, int ipv6, char *dst_ip, int dst_port);
 ssize_t swSocket_udp_sendto(int server_sock, char *dst_ip, int dst_port, char *data, uint32_t len);
 ssize_t swSocket_udp_sendto6(int server_sock, char *dst_ip, int dst_port, char *data, uint32_t len);
 ssize_t swSocket_unix_sendto(int server_sock, char *dst_path, char *data, uint32_t len);
@@ -1600,6 +1614,32 @@ struct _swWorker
 
 	void *send_shm;
 
+	/**
+	 * [ReactorThread] -> [Worker] big package ring
+	 */
+	swMemoryPool *dispatch_shm;
+	sw_atomic_t dispatch_lock;
+	/**
+	 * packages allocated in the ring and not given back yet
+	 */
+	sw_atomic_t dispatch_shm_num;
+
+	/**
+	 * [TaskWorker] held around every read of the pipe while the idle workers steal tasks, a peeked task is then the one taken
+	 */
+	sw_atomic_t steal_lock;
+
+	/**
+	 * [ReactorThread] -> [Worker] bytes and messages waiting in the pipe buffers of the reactor threads
+	 */
+	sw_atomic_t pipe_backlog_size;
+	sw_atomic_t pipe_backlog_num;
+
+	/**
+	 * [ReactorThread] -> [Worker] requests dispatched to the worker and not handled yet
+	 */
+	sw_atomic_t inflight_num;
+
 	swPipe *pipe_object;
 
 	int pipe_master;
@@ -1652,6 +1692,12 @@ struct _swProcessPool
      */
     uint8_t use_socket;
 
+    /**
+     * idle workers take the messages queued on the pipes of the busy workers
+     */
+    uint8_t work_stealing;
+    sw_atomic_t steal_count;
+
     char *packet_buffer;
     uint32_t max_packet_size;
 
@@ -1945,6 +1991,7 @@ void swChannel_print(swChannel *);
 swLinkedList* swLinkedList_new(uint8_t type, swDestructor dtor);
 int swLinkedList_append(swLinkedList *ll, void *data);
 void swLinkedList_remove_node(swLinkedList *ll, swLinkedList_node *remove_node);
+void swLinkedList_move_to_tail(swLinkedList *ll, swLinkedList_node *node);
 int swLinkedList_prepend(swLinkedList *ll, void *data);
 void* swLinkedList_pop(swLinkedList *ll);
 void* swLinkedList_shift(swLinkedList *ll);
@@ -2011,12 +2058,20 @@ int swProtocol_recv_check_eof(swProtocol *protocol, swConnection *conn, swString
 
 typedef struct _swTimer swTimer;
 typedef struct _swTimer_node swTimer_node;
+typedef struct _swTimerWheel swTimerWheel;
 
 typedef void (*swTimerCallback)(swTimer *, swTimer_node *);
+typedef void (*swTimerEachCallback)(swTimer *, swTimer_node *);
 
 struct _swTimer_node
 {
     swHeap_node *heap_node;
+    /**
+     * timer wheel: slot list and id index links
+     */
+    swTimer_node *next;
+    swTimer_node **pprev;
+    swTimer_node *index_next;
     void *data;
     swTimerCallback callback;
     int64_t exec_msec;
@@ -2042,6 +2097,7 @@ struct _swTimer
     uint8_t initialized;
     swHeap *heap;
     swHashMap *map;
+    swTimerWheel *wheel;
     uint32_t num;
     int lasttime;
     uint64_t round;
@@ -2059,11 +2115,8 @@ int swTimer_del(swTimer *timer, swTimer_node *node);
 void swTimer_free(swTimer *timer);
 int swTimer_select(swTimer *timer);
 int swTimer_now(struct timeval *time);
-
-static sw_inline swTimer_node* swTimer_get(swTimer *timer, long id)
-{
-    return (swTimer_node*) swHashMap_find_int(timer->map, id);
-}
+swTimer_node* swTimer_get(swTimer *timer, long id);
+void swTimer_each(swTimer *timer, swTimerEachCallback callback);
 
 int swSystemTimer_init(int msec);
 void swSystemTimer_signal_handler(int sig);
@@ -2101,6 +2154,10 @@ typedef struct
     uint32_t in_client :1;
     uint32_t shutdown :1;
     uint32_t wait_exit :1;
+    /**
+     * the request in onTask is not done yet, a coroutine started for it takes it over
+     */
+    uint32_t request_pending :1;
 
     int max_request;
 
@@ -2145,6 +2202,7 @@ typedef struct
     uint8_t socket_dontwait :1;
     uint8_t dns_lookup_random :1;
     uint8_t use_async_resolver :1;
+    uint8_t use_timer_wheel :1;
 
     int error;
     int process_type;
@@ -30,6 +30,10 @@ typedef struct _swTableRow
 #else
     pthread_mutex_t lock;
 #endif
+    /**
+     * seqlock, odd while a writer holds the lock, only used on the root row of the slot
+     */
+    sw_atomic_t version;
     /**
      * 1:used, 0:empty
      */
@@ -52,6 +56,25 @@ typedef struct
     swTableRow *row;
 } swTable_iterator;
 
+enum swTable_layout
+{
+    /**
+     * root rows + conflict rows from a fixed pool, linked by next
+     */
+    SW_TABLE_LAYOUT_CHAIN = 0,
+    /**
+     * one flat slot array, linear probing guided by one control byte per slot
+     */
+    SW_TABLE_LAYOUT_OPEN_ADDRESSING = 1,
+};
+
+/**
+ * control byte of the open addressing slot, 0x00-0x7f: used, 7 bits of the key hash
+ */
+#define SW_TABLE_CTRL_EMPTY      0x80
+#define SW_TABLE_CTRL_DELETED    0xfe
+#define SW_TABLE_CTRL_BUSY       0xff
+
 typedef struct
 {
     swHashMap *columns;
@@ -62,6 +85,11 @@ typedef struct
     size_t item_size;
     size_t memory_size;
     float conflict_proportion;
+    uint8_t layout;
+    /**
+     * number of rows[], chain: size, open addressing: size + spare slots
+     */
+    size_t slot_num;
 
     /**
      * total rows that in active state(shm)
@@ -70,8 +98,35 @@ typedef struct
 
     swTableRow **rows;
     swMemoryPool *pool;
+    /**
+     * open addressing only, control bytes and the longest probe distance in use(shm)
+     */
+    uint8_t *ctrl;
+    sw_atomic_t *max_probe;
+
+    /**
+     * open addressing online resize, every generation up to max_size is reserved at create,
+     * the generation is odd while the slot arrays are switched
+     */
+    size_t max_size;
+    size_t memory_offset;
+    sw_atomic_t generation;
+    uint8_t resizing;
+    swTableRow **old_rows;
+    uint8_t *old_ctrl;
+    size_t old_slot_num;
+    sw_atomic_t *old_max_probe;
+    /**
+     * generation << 32 | next old slot to migrate, and the old slots already migrated
+     */
+    volatile uint64_t migrate_index;
+    sw_atomic_t migrated;
 
     swTable_iterator *iterator;
+    /**
+     * process local copy of the row for optimistic reads
+     */
+    swTableRow *read_buffer;
 
     void *memory;
 } swTable;
@@ -115,6 +170,8 @@ void swTable_free(swTable *table);
 int swTableColumn_add(swTable *table, char *name, int len, int type, int size);
 swTableRow* swTableRow_set(swTable *table, char *key, int keylen, swTableRow **rowlock);
 swTableRow* swTableRow_get(swTable *table, char *key, int keylen, swTableRow **rowlock);
+swTableRow* swTableRow_read(swTable *table, char *key, int keylen);
+swTableRow* swTableRow_get_lock(swTable *table, swTableRow *row);
 
 void swTable_iterator_rewind(swTable *table);
 swTableRow* swTable_iterator_current(swTable *table);
@@ -133,10 +190,12 @@ static sw_inline void swTableRow_lock(swTableRow *row)
 #else
     pthread_mutex_lock(&row->lock);
 #endif
+    sw_atomic_fetch_add(&row->version, 1);
 }
 
 static sw_inline void swTableRow_unlock(swTableRow *row)
 {
+    sw_atomic_fetch_add(&row->version, 1);
 #if SW_TABLE_USE_SPINLOCK
     sw_spinlock_release(&row->lock);
 #else
@@ -383,6 +383,7 @@ void swoole_channel_init(int module_number);
 void swoole_ringqueue_init(int module_number);
 void swoole_msgqueue_init(int module_number);
 void swoole_channel_coro_init(int module_number);
+void swoole_connection_pool_coro_init(int module_number);
 #ifdef SW_USE_FAST_SERIALIZE
 void swoole_serialize_init(int module_number);
 #endif
@@ -411,6 +412,11 @@ void php_swoole_clear_all_timer();
 void php_swoole_register_callback(swServer *serv);
 void php_swoole_trace_check(void *arg);
 void php_swoole_client_free(zval *zobject, swClient *cli);
+int php_swoole_redis_coro_get_fd(zval *zobject, int *fd);
+int php_swoole_mysql_coro_get_fd(zval *zobject, int *fd);
+#ifdef SW_USE_POSTGRESQL
+int php_swoole_postgresql_coro_get_fd(zval *zobject, int *fd);
+#endif
 swClient* php_swoole_client_new(zval *zobject, char *host, int host_len, int port);
 void php_swoole_client_check_setting(swClient *cli, zval *zset);
 #ifdef SW_USE_OPENSSL
@@ -155,6 +155,31 @@ void swLinkedList_remove_node(swLinkedList *ll, swLinkedList_node *remove_node)
     sw_free(remove_node);
 }
 
+/**
+ * move the node to the end of queue, the node is kept
+ */
+void swLinkedList_move_to_tail(swLinkedList *ll, swLinkedList_node *node)
+{
+    if (node == ll->tail)
+    {
+        return;
+    }
+    if (node == ll->head)
+    {
+        ll->head = node->next;
+    }
+    else
+    {
+        node->prev->next = node->next;
+    }
+    node->next->prev = node->prev;
+
+    node->prev = ll->tail;
+    node->next = NULL;
+    ll->tail->next = node;
+    ll->tail = node;
+}
+
 swLinkedList_node* swLinkedList_find(swLinkedList *ll, void *data)
 {
     if (ll->num == 0)
@@ -24,11 +24,15 @@ using namespace swoole;
 Context::Context(size_t stack_size, coroutine_func_t fn, void* private_data) :
         fn_(fn), stack_size_(stack_size), private_data_(private_data)
 {
-    protect_page_ = 0;
     end = false;
     swap_ctx_ = NULL;
 
-    stack_ = (char*) sw_malloc(stack_size_);
+    stack_ = StackPool::alloc(stack_size_);
+    if (stack_ == NULL)
+    {
+        swoole_throw_error(SW_ERROR_MALLOC_FAIL);
+        return;
+    }
     swTraceLog(SW_TRACE_COROUTINE, "alloc stack: size=%u, ptr=%p.", stack_size_, stack_);
 
     void* sp = (void*) ((char*) stack_ + stack_size_);
@@ -36,15 +40,6 @@ Context::Context(size_t stack_size, coroutine_func_t fn, void* private_data) :
     valgrind_stack_id = VALGRIND_STACK_REGISTER(sp, stack_);
 #endif
     ctx_ = make_fcontext(sp, stack_size_, (void (*)(intptr_t))&context_func);
-
-    uint32_t protect_page = get_protect_stack_page();
-    if (protect_page)
-    {
-        if (protect_stack(stack_, stack_size_, protect_page))
-        {
-            protect_page_ = protect_page;
-        }
-    }
 }
 
 Context::~Context()
@@ -52,14 +47,10 @@ Context::~Context()
     if (stack_)
     {
         swTraceLog(SW_TRACE_COROUTINE, "free stack: ptr=%p", stack_);
-        if (protect_page_)
-        {
-            unprotect_stack(stack_, protect_page_);
-        }
 #if defined(USE_VALGRIND)
         VALGRIND_STACK_DEREGISTER(valgrind_stack_id);
 #endif
-        sw_free(stack_);
+        StackPool::free(stack_, stack_size_);
         stack_ = NULL;
     }
 }
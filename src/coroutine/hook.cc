@@ -316,6 +316,20 @@ static void handler_rename(swAio_event *event)
     event->error = errno;
 }
 
+/**
+ * file operations go to io_uring when it is available, otherwise to the thread pool
+ */
+static int aio_dispatch(swAio_event *event)
+{
+#ifdef SW_USE_IOURING
+    if (swAio_iouring_dispatch(event) == SW_OK)
+    {
+        return SW_OK;
+    }
+#endif
+    return swAio_dispatch(event);
+}
+
 static void aio_onCompleted(swAio_event *event)
 {
     swAio_event *ev = (swAio_event *) event->req;
@@ -375,12 +389,13 @@ int swoole_coroutine_open(const char *pathname, int flags, mode_t mode)
     ev.buf = (void*) pathname;
     ev.offset = mode;
     ev.flags = flags;
+    ev.type = SW_AIO_OPEN;
     ev.handler = handler_open;
     ev.callback = aio_onCompleted;
     ev.object = Coroutine::get_current();
     ev.req = &ev;
 
-    int ret = swAio_dispatch(&ev);
+    int ret = aio_dispatch(&ev);
     if (ret < 0)
     {
         return SW_ERR;
@@ -408,12 +423,13 @@ ssize_t swoole_coroutine_read(int fd, void *buf, size_t count)
     ev.fd = fd;
     ev.buf = buf;
     ev.nbytes = count;
+    ev.type = SW_AIO_READ;
     ev.handler = handler_read;
     ev.callback = aio_onCompleted;
     ev.object = Coroutine::get_current();
     ev.req = &ev;
 
-    int ret = swAio_dispatch(&ev);
+    int ret = aio_dispatch(&ev);
     if (ret < 0)
     {
         return SW_ERR;
@@ -441,12 +457,13 @@ ssize_t swoole_coroutine_write(int fd, const void *buf, size_t count)
     ev.fd = fd;
     ev.buf = (void*) buf;
     ev.nbytes = count;
+    ev.type = SW_AIO_WRITE;
     ev.handler = handler_write;
     ev.callback = aio_onCompleted;
     ev.object = Coroutine::get_current();
     ev.req = &ev;
 
-    int ret = swAio_dispatch(&ev);
+    int ret = aio_dispatch(&ev);
     if (ret < 0)
     {
         return SW_ERR;
@@ -492,12 +509,13 @@ int swoole_coroutine_fstat(int fd, struct stat *statbuf)
     bzero(&ev, sizeof(ev));
     ev.fd = fd;
     ev.buf = (void*) statbuf;
+    ev.type = SW_AIO_FSTAT;
     ev.handler = handler_fstat;
     ev.callback = aio_onCompleted;
     ev.object = Coroutine::get_current();
     ev.req = &ev;
 
-    int ret = swAio_dispatch(&ev);
+    int ret = aio_dispatch(&ev);
     if (ret < 0)
     {
         return SW_ERR;
@@ -516,12 +534,13 @@ int swoole_coroutine_unlink(const char *pathname)
     swAio_event ev;
     bzero(&ev, sizeof(ev));
     ev.buf = (void*) pathname;
+    ev.type = SW_AIO_UNLINK;
     ev.handler = handler_unlink;
     ev.callback = aio_onCompleted;
     ev.object = Coroutine::get_current();
     ev.req = &ev;
 
-    int ret = swAio_dispatch(&ev);
+    int ret = aio_dispatch(&ev);
     if (ret < 0)
     {
         return SW_ERR;
@@ -566,12 +585,13 @@ int swoole_coroutine_mkdir(const char *pathname, mode_t mode)
     bzero(&ev, sizeof(ev));
     ev.buf = (void*) pathname;
     ev.offset = mode;
+    ev.type = SW_AIO_MKDIR;
     ev.handler = handler_mkdir;
     ev.callback = aio_onCompleted;
     ev.object = Coroutine::get_current();
     ev.req = &ev;
 
-    int ret = swAio_dispatch(&ev);
+    int ret = aio_dispatch(&ev);
     if (ret < 0)
     {
         return SW_ERR;
@@ -590,12 +610,13 @@ int swoole_coroutine_rmdir(const char *pathname)
     swAio_event ev;
     bzero(&ev, sizeof(ev));
     ev.buf = (void*) pathname;
+    ev.type = SW_AIO_RMDIR;
     ev.handler = handler_rmdir;
     ev.callback = aio_onCompleted;
     ev.object = Coroutine::get_current();
     ev.req = &ev;
 
-    int ret = swAio_dispatch(&ev);
+    int ret = aio_dispatch(&ev);
     if (ret < 0)
     {
         return SW_ERR;
@@ -615,12 +636,13 @@ int swoole_coroutine_rename(const char *oldpath, const char *newpath)
     bzero(&ev, sizeof(ev));
     ev.buf = (void*) oldpath;
     ev.offset = (off_t) newpath;
+    ev.type = SW_AIO_RENAME;
     ev.handler = handler_rename;
     ev.callback = aio_onCompleted;
     ev.object = Coroutine::get_current();
     ev.req = &ev;
 
-    int ret = swAio_dispatch(&ev);
+    int ret = aio_dispatch(&ev);
     if (ret < 0)
     {
         return SW_ERR;
@@ -695,8 +717,142 @@ int Coroutine::sleep(double sec)
     return 0;
 }
 
+#ifdef SW_USE_IOURING
+/**
+ * open/fstat/read/close issued one by one on the ring, no thread switch is involved
+ */
+static swString* read_file_iouring(const char *file, int lock)
+{
+    struct stat file_stat;
+    swString *str = NULL;
+
+    int fd = swoole_coroutine_open(file, O_RDONLY, 0);
+    if (fd < 0)
+    {
+        swSysError("open(%s, O_RDONLY) failed.", file);
+        SwooleG.error = errno;
+        return NULL;
+    }
+    if (swoole_coroutine_fstat(fd, &file_stat) < 0)
+    {
+        swSysError("fstat(%s) failed.", file);
+        goto _error;
+    }
+    if ((file_stat.st_mode & S_IFMT) != S_IFREG)
+    {
+        errno = EISDIR;
+        goto _error;
+    }
+    if (lock && swoole_coroutine_flock(fd, LOCK_SH) < 0)
+    {
+        swSysError("flock(%d, LOCK_SH) failed.", fd);
+        goto _error;
+    }
+
+    str = swString_new(file_stat.st_size > 0 ? file_stat.st_size : SW_BUFFER_SIZE_STD);
+    if (str == NULL)
+    {
+        goto _error;
+    }
+    while (1)
+    {
+        if (str->length == str->size && swString_extend(str, str->size * 2) < 0)
+        {
+            goto _error;
+        }
+        ssize_t n = swoole_coroutine_read(fd, str->str + str->length, str->size - str->length);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            swSysError("read(%d, %ld) failed.", fd, str->size - str->length);
+            goto _error;
+        }
+        str->length += n;
+        //a regular file is done once st_size bytes are in, files like /proc report 0 and are read to EOF
+        if (n == 0 || (file_stat.st_size > 0 && str->length >= (size_t) file_stat.st_size))
+        {
+            break;
+        }
+    }
+
+    if (lock && swoole_coroutine_flock(fd, LOCK_UN) < 0)
+    {
+        swSysError("flock(%d, LOCK_UN) failed.", fd);
+    }
+    close(fd);
+    return str;
+
+    _error:
+    SwooleG.error = errno;
+    if (str)
+    {
+        swString_free(str);
+    }
+    close(fd);
+    return NULL;
+}
+
+static ssize_t write_file_iouring(const char *file, char *buf, size_t length, int lock, int flags)
+{
+    size_t written = 0;
+    int error = 0;
+
+    int fd = swoole_coroutine_open(file, flags, 0644);
+    if (fd < 0)
+    {
+        swSysError("open(%s, %d) failed.", file, flags);
+        SwooleG.error = errno;
+        return -1;
+    }
+    if (lock && swoole_coroutine_flock(fd, LOCK_EX) < 0)
+    {
+        swSysError("flock(%d, LOCK_EX) failed.", fd);
+        SwooleG.error = errno;
+        close(fd);
+        return -1;
+    }
+    while (written < length)
+    {
+        ssize_t n = swoole_coroutine_write(fd, buf + written, length - written);
+        if (n < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            swSysError("write(%d, %ld) failed.", fd, length - written);
+            error = errno;
+            break;
+        }
+        written += n;
+    }
+    if (lock && swoole_coroutine_flock(fd, LOCK_UN) < 0)
+    {
+        swSysError("flock(%d, LOCK_UN) failed.", fd);
+    }
+    close(fd);
+    //a write that stops halfway reports the error, not a short count
+    if (error)
+    {
+        SwooleG.error = errno = error;
+        return -1;
+    }
+    return written;
+}
+#endif
+
 swString* Coroutine::read_file(const char *file, int lock)
 {
+#ifdef SW_USE_IOURING
+    if (swAio_iouring_init() == SW_OK)
+    {
+        return read_file_iouring(file, lock);
+    }
+#endif
+
     aio_task task;
 
     swAio_event ev;
@@ -734,6 +890,13 @@ swString* Coroutine::read_file(const char *file, int lock)
 
 ssize_t Coroutine::write_file(const char *file, char *buf, size_t length, int lock, int flags)
 {
+#ifdef SW_USE_IOURING
+    if (!(flags & SW_AIO_WRITE_FSYNC) && swAio_iouring_init() == SW_OK)
+    {
+        return write_file_iouring(file, buf, length, lock, flags);
+    }
+#endif
+
     aio_task task;
 
     swAio_event ev;
@@ -0,0 +1,154 @@
+/*
+  +----------------------------------------------------------------------+
+  | Swoole                                                               |
+  +----------------------------------------------------------------------+
+  | This source file is subject to version 2.0 of the Apache license,    |
+  | that is bundled with this package in the file LICENSE, and is        |
+  | available through the world-wide-web at the following url:           |
+  | http://www.apache.org/licenses/LICENSE-2.0.html                      |
+  | If you did not receive a copy of the Apache2.0 license and are unable|
+  | to obtain it through the world-wide-web, please send a note to       |
+  | license@swoole.com so we can mail you a copy immediately.            |
+  +----------------------------------------------------------------------+
+  | Author: Tianfeng Han  <mikan.tenny@gmail.com>                        |
+  +----------------------------------------------------------------------+
+*/
+
+#include "swoole.h"
+#include "context.h"
+
+#include <sys/mman.h>
+#include <vector>
+
+using namespace swoole;
+
+#ifndef MAP_NORESERVE
+#define MAP_NORESERVE 0
+#endif
+
+#ifndef MAP_STACK
+#define MAP_STACK 0
+#endif
+
+thread_local uint64_t StackPool::hit = 0;
+thread_local uint64_t StackPool::miss = 0;
+
+/**
+ * idle stacks of the current stack size, the most recently freed one is reused first,
+ * the ones below [trimmed] have given their pages back to the kernel,
+ * the ones below [low_water] were not reused since the last trim
+ */
+struct stack_pool
+{
+    size_t stack_size = 0;
+    size_t trimmed = 0;
+    size_t low_water = 0;
+    int64_t trim_time = 0;
+    std::vector<char*> stacks;
+
+    ~stack_pool()
+    {
+        clear();
+    }
+
+    void clear();
+    void trim();
+};
+
+static thread_local stack_pool pool;
+
+static inline size_t stack_guard_size()
+{
+    return SwooleG.pagesize * SW_CORO_STACK_GUARD_PAGES;
+}
+
+static char* stack_map(size_t stack_size)
+{
+    size_t guard_size = stack_guard_size();
+    void *mem = mmap(NULL, guard_size + stack_size, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_STACK, -1, 0);
+    if (mem == MAP_FAILED)
+    {
+        swSysError("mmap(%ld) failed.", guard_size + stack_size);
+        return NULL;
+    }
+    //the stack grows down, an overflow faults on the guard page instead of the neighbour
+    if (mprotect(mem, guard_size, PROT_NONE) < 0)
+    {
+        swoole_error_log(SW_LOG_WARNING, SW_ERROR_CO_PROTECT_STACK_FAILED, "mprotect(%p) failed, Error: %s[%d].", mem,
+                strerror(errno), errno);
+    }
+    return (char *) mem + guard_size;
+}
+
+static void stack_unmap(char *stack, size_t stack_size)
+{
+    size_t guard_size = stack_guard_size();
+    munmap(stack - guard_size, guard_size + stack_size);
+}
+
+void stack_pool::clear()
+{
+    for (auto stack : stacks)
+    {
+        stack_unmap(stack, stack_size);
+    }
+    stacks.clear();
+    trimmed = low_water = 0;
+}
+
+/**
+ * drop the pages of the stacks that stayed idle for a whole interval, the mapping and the guard page are kept,
+ * so reusing them later costs just the page faults
+ */
+void stack_pool::trim()
+{
+    int64_t now = swTimer_get_absolute_msec();
+    if (now - trim_time < SW_CORO_STACK_POOL_TRIM_INTERVAL)
+    {
+        return;
+    }
+    for (; trimmed < low_water; trimmed++)
+    {
+        madvise(stacks[trimmed], stack_size, MADV_DONTNEED);
+    }
+    low_water = stacks.size();
+    trim_time = now;
+}
+
+char* StackPool::alloc(size_t stack_size)
+{
+    if (pool.stack_size != stack_size)
+    {
+        //Coroutine::set_stack_size() was called, the idle stacks are of no use anymore
+        pool.clear();
+        pool.stack_size = stack_size;
+    }
+    if (!pool.stacks.empty())
+    {
+        char *stack = pool.stacks.back();
+        pool.stacks.pop_back();
+        pool.low_water = MIN(pool.low_water, pool.stacks.size());
+        pool.trimmed = MIN(pool.trimmed, pool.stacks.size());
+        hit++;
+        return stack;
+    }
+    miss++;
+    return stack_map(stack_size);
+}
+
+void StackPool::free(char *stack, size_t stack_size)
+{
+    if (pool.stack_size != stack_size || pool.stacks.size() >= SW_CORO_STACK_POOL_SIZE)
+    {
+        stack_unmap(stack, stack_size);
+        return;
+    }
+    pool.stacks.push_back(stack);
+    pool.trim();
+}
+
+size_t StackPool::count()
+{
+    return pool.stacks.size();
+}
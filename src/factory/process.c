@@ -90,10 +90,19 @@ static int swFactoryProcess_start(swFactory *factory)
 
     for (i = 0; i < serv->worker_num; i++)
     {
-        if (swServer_worker_create(serv, swServer_get_worker(serv, i)) < 0)
+        swWorker *worker = swServer_get_worker(serv, i);
+        if (swServer_worker_create(serv, worker) < 0)
         {
             return SW_ERR;
         }
+        if (serv->dispatch_shm_size > 0)
+        {
+            worker->dispatch_shm = swRingBuffer_new(serv->dispatch_shm_size, 1);
+            if (worker->dispatch_shm == NULL)
+            {
+                return SW_ERR;
+            }
+        }
     }
 
     serv->reactor_pipe_num = serv->worker_num / serv->reactor_num;
@@ -184,7 +193,8 @@ static int swFactoryProcess_dispatch(swFactory *factory, swDispatchData *task)
             //Connection has been clsoed by server
             if (!(task->data.info.type == SW_EVENT_CLOSE && conn->close_force))
             {
-                return SW_OK;
+                //the caller gives the package in the dispatch ring back
+                return task->data.info.type == SW_EVENT_PACKAGE ? SW_ERR : SW_OK;
             }
         }
         //converted fd to session_id
@@ -192,7 +202,21 @@ static int swFactoryProcess_dispatch(swFactory *factory, swDispatchData *task)
         task->data.info.from_fd = conn->from_fd;
     }
 
-    return swReactorThread_send2worker(serv, (void *) &(task->data), send_len, target_worker_id);
+    if (!swEventData_is_request(task->data.info.type))
+    {
+        return swReactorThread_send2worker(serv, (void *) &(task->data), send_len, target_worker_id);
+    }
+    /**
+     * counted before it is sent, the worker may be done with it before send2worker returns
+     */
+    swWorker *worker = swServer_get_worker(serv, target_worker_id);
+    sw_atomic_fetch_add(&worker->inflight_num, 1);
+    int ret = swReactorThread_send2worker(serv, (void *) &(task->data), send_len, target_worker_id);
+    if (ret < 0)
+    {
+        sw_atomic_fetch_sub(&worker->inflight_num, 1);
+    }
+    return ret;
 }
 
 /**
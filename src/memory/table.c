@@ -84,6 +84,10 @@ swTable* swTable_new(uint32_t rows_size, float conflict_proportion)
     table->size = rows_size;
     table->mask = rows_size - 1;
     table->conflict_proportion = conflict_proportion;
+    table->layout = SW_TABLE_LAYOUT_CHAIN;
+    table->max_size = 0;
+    table->resizing = 0;
+    table->generation = 0;
 
     bzero(table->iterator, sizeof(swTable_iterator));
     table->memory = NULL;
@@ -147,18 +151,66 @@ int swTableColumn_add(swTable *table, char *name, int len, int type, int size)
     return swHashMap_add(table->columns, name, len, col);
 }
 
-size_t swTable_get_memory_size(swTable *table)
+/**
+ * one generation of open addressing slots
+ */
+typedef struct
 {
-    /**
-     * table size + conflict size
-     */
-    size_t row_num = table->size * (1 + table->conflict_proportion);
+    swTableRow **rows;
+    uint8_t *ctrl;
+    size_t slot_num;
+    sw_atomic_t *max_probe;
+} swTable_slots;
+
+static sw_inline size_t swTable_slot_num(swTable *table, size_t size)
+{
+    return size * (1 + table->conflict_proportion);
+}
+
+/**
+ * one done flag for every batch of slots to migrate, they follow the control bytes
+ */
+static sw_inline size_t swTable_batch_num(size_t slot_num)
+{
+    return (slot_num + SW_TABLE_MIGRATE_BATCH - 1) / SW_TABLE_MIGRATE_BATCH;
+}
 
+/**
+ * max_probe + rows[] + control bytes + batch flags + rows
+ */
+static sw_inline size_t swTable_slots_memory_size(swTable *table, size_t size)
+{
+    size_t slot_num = swTable_slot_num(table, size);
+    return sizeof(uint64_t) + slot_num * (sizeof(swTableRow *) + sizeof(swTableRow) + table->item_size)
+            + SW_MEM_ALIGNED_SIZE_EX(slot_num + swTable_batch_num(slot_num), 8);
+}
+
+size_t swTable_get_memory_size(swTable *table)
+{
     /*
      * header + data
      */
     size_t row_memory_size = sizeof(swTableRow) + table->item_size;
 
+    if (table->layout == SW_TABLE_LAYOUT_OPEN_ADDRESSING)
+    {
+        /**
+         * size rows + spare slots, no conflict pool,
+         * every generation up to max_size is reserved for the online resize, untouched pages cost nothing
+         */
+        size_t size, memory_size = 0;
+        for (size = table->size; size <= MAX(table->size, table->max_size); size *= 2)
+        {
+            memory_size += swTable_slots_memory_size(table, size);
+        }
+        return memory_size;
+    }
+
+    /**
+     * table size + conflict size
+     */
+    size_t row_num = table->size * (1 + table->conflict_proportion);
+
     /**
      * row data & header
      */
@@ -177,23 +229,32 @@ size_t swTable_get_memory_size(swTable *table)
     return memory_size;
 }
 
-int swTable_create(swTable *table)
+/**
+ * carve rows[] and the rows out of the memory, open addressing also gets max_probe and the control bytes
+ */
+static void* swTable_slots_init(swTable *table, void *memory, size_t slot_num, swTable_slots *slots)
 {
-    size_t memory_size = swTable_get_memory_size(table);
     size_t row_memory_size = sizeof(swTableRow) + table->item_size;
 
-    void *memory = sw_shm_malloc(memory_size);
-    if (memory == NULL)
+    bzero(slots, sizeof(swTable_slots));
+    if (table->layout == SW_TABLE_LAYOUT_OPEN_ADDRESSING)
     {
-        return SW_ERR;
+        slots->max_probe = memory;
+        *slots->max_probe = 0;
+        memory = (char *) memory + sizeof(uint64_t);
     }
 
-    table->memory_size = memory_size;
-    table->memory = memory;
+    slots->rows = memory;
+    slots->slot_num = slot_num;
+    memory = (char *) memory + slot_num * sizeof(swTableRow *);
 
-    table->rows = memory;
-    memory = (char *) memory + table->size * sizeof(swTableRow *);
-    memory_size -= table->size * sizeof(swTableRow *);
+    if (table->layout == SW_TABLE_LAYOUT_OPEN_ADDRESSING)
+    {
+        slots->ctrl = memory;
+        memset(slots->ctrl, SW_TABLE_CTRL_EMPTY, slot_num);
+        memset(slots->ctrl + slot_num, 0, swTable_batch_num(slot_num));
+        memory = (char *) memory + SW_MEM_ALIGNED_SIZE_EX(slot_num + swTable_batch_num(slot_num), 8);
+    }
 
 #if SW_TABLE_USE_SPINLOCK == 0
     pthread_mutexattr_t attr;
@@ -203,18 +264,58 @@ int swTable_create(swTable *table)
     pthread_mutexattr_setrobust_np(&attr, PTHREAD_MUTEX_ROBUST_NP);
 #endif
 
-    int i;
-    for (i = 0; i < table->size; i++)
+    size_t i;
+    for (i = 0; i < slot_num; i++)
     {
-        table->rows[i] = (swTableRow *) ((char *) memory + (row_memory_size * i));
-        memset(table->rows[i], 0, sizeof(swTableRow));
+        slots->rows[i] = (swTableRow *) ((char *) memory + (row_memory_size * i));
+        memset(slots->rows[i], 0, sizeof(swTableRow));
 #if SW_TABLE_USE_SPINLOCK == 0
-        pthread_mutex_init(&table->rows[i]->lock, &attr);
+        pthread_mutex_init(&slots->rows[i]->lock, &attr);
 #endif
     }
 
-    memory = (char *) memory + row_memory_size * table->size;
-    memory_size -= row_memory_size * table->size;
+    return (char *) memory + row_memory_size * slot_num;
+}
+
+int swTable_create(swTable *table)
+{
+    size_t memory_size = swTable_get_memory_size(table);
+    size_t row_memory_size = sizeof(swTableRow) + table->item_size;
+
+    void *memory = sw_shm_malloc(memory_size);
+    if (memory == NULL)
+    {
+        return SW_ERR;
+    }
+
+    table->read_buffer = sw_malloc(row_memory_size);
+    if (table->read_buffer == NULL)
+    {
+        sw_shm_free(memory);
+        return SW_ERR;
+    }
+
+    table->memory_size = memory_size;
+    table->memory = memory;
+
+    swTable_slots slots;
+    if (table->layout == SW_TABLE_LAYOUT_OPEN_ADDRESSING)
+    {
+        swTable_slots_init(table, memory, swTable_slot_num(table, table->size), &slots);
+        table->rows = slots.rows;
+        table->ctrl = slots.ctrl;
+        table->slot_num = slots.slot_num;
+        table->max_probe = slots.max_probe;
+        table->memory_offset = swTable_slots_memory_size(table, table->size);
+        table->generation = 0;
+        table->resizing = 0;
+        return SW_OK;
+    }
+
+    memory = swTable_slots_init(table, memory, table->size, &slots);
+    table->rows = slots.rows;
+    table->slot_num = table->size;
+    memory_size -= (char *) memory - (char *) table->memory;
     table->pool = swFixedPool_new2(row_memory_size, memory, memory_size);
 
     return SW_OK;
@@ -231,22 +332,60 @@ void swTable_free(swTable *table)
     sw_free(table->iterator);
     if (table->memory)
     {
+        sw_free(table->read_buffer);
         sw_shm_free(table->memory);
     }
 }
 
-static sw_inline swTableRow* swTable_hash(swTable *table, char *key, int keylen)
+static sw_inline uint64_t swTable_hash_key(char *key, int keylen)
 {
 #ifdef SW_TABLE_USE_PHP_HASH
-    uint64_t hashv = swoole_hash_php(key, keylen);
+    return swoole_hash_php(key, keylen);
 #else
-    uint64_t hashv = swoole_hash_austin(key, keylen);
+    return swoole_hash_austin(key, keylen);
 #endif
+}
+
+/**
+ * the root row of the slot, its lock guards every row that hashes to the slot
+ */
+static sw_inline swTableRow* swTable_hash(swTable *table, uint64_t hashv)
+{
     uint64_t index = hashv & table->mask;
     assert(index < table->size);
     return table->rows[index];
 }
 
+/**
+ * seqlock read of the slot arrays, the table header is only switched under an odd generation
+ */
+static sw_atomic_t swTable_slots_get(swTable *table, swTable_slots *slots, swTable_slots *old_slots, uint8_t *resizing)
+{
+    for (;;)
+    {
+        sw_atomic_t generation = __atomic_load_n(&table->generation, __ATOMIC_ACQUIRE);
+        if (generation & 1)
+        {
+            sw_atomic_cpu_pause();
+            continue;
+        }
+        slots->rows = table->rows;
+        slots->ctrl = table->ctrl;
+        slots->slot_num = table->slot_num;
+        slots->max_probe = table->max_probe;
+        old_slots->rows = table->old_rows;
+        old_slots->ctrl = table->old_ctrl;
+        old_slots->slot_num = table->old_slot_num;
+        old_slots->max_probe = table->old_max_probe;
+        *resizing = table->resizing;
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (table->generation == generation)
+        {
+            return generation;
+        }
+    }
+}
+
 void swTable_iterator_rewind(swTable *table)
 {
     bzero(table->iterator, sizeof(swTable_iterator));
@@ -254,7 +393,20 @@ void swTable_iterator_rewind(swTable *table)
 
 static sw_inline swTableRow* swTable_iterator_get(swTable *table, uint32_t index)
 {
-    swTableRow *row = table->rows[index];
+    swTableRow *row;
+    if (index < table->slot_num)
+    {
+        row = table->rows[index];
+    }
+    //while resizing, the rows not migrated yet follow the new slots
+    else if (table->resizing && index - table->slot_num < table->old_slot_num)
+    {
+        row = table->old_rows[index - table->slot_num];
+    }
+    else
+    {
+        return NULL;
+    }
     return row->active ? row : NULL;
 }
 
@@ -265,7 +417,8 @@ swTableRow* swTable_iterator_current(swTable *table)
 
 void swTable_iterator_forward(swTable *table)
 {
-    for (; table->iterator->absolute_index < table->size; table->iterator->absolute_index++)
+    for (; table->iterator->absolute_index < table->slot_num + (table->resizing ? table->old_slot_num : 0);
+            table->iterator->absolute_index++)
     {
         swTableRow *row = swTable_iterator_get(table, table->iterator->absolute_index);
         if (row == NULL)
@@ -301,6 +454,396 @@ void swTable_iterator_forward(swTable *table)
     table->iterator->row = NULL;
 }
 
+swTableRow* swTableRow_get_lock(swTable *table, swTableRow *row)
+{
+    int keylen = strnlen(row->key, SW_TABLE_KEY_SIZE);
+    uint64_t hashv = swTable_hash_key(row->key, keylen);
+    if (table->layout == SW_TABLE_LAYOUT_CHAIN)
+    {
+        return swTable_hash(table, hashv);
+    }
+
+    swTable_slots slots, old_slots;
+    uint8_t resizing;
+    swTable_slots_get(table, &slots, &old_slots, &resizing);
+
+    //a row of the old generation is guarded by its old home slot
+    char *first = (char *) old_slots.rows[0];
+    size_t old_memory_size = old_slots.slot_num * (sizeof(swTableRow) + table->item_size);
+    if (resizing && (char *) row >= first && (char *) row < first + old_memory_size)
+    {
+        return old_slots.rows[hashv % old_slots.slot_num];
+    }
+    return slots.rows[hashv % slots.slot_num];
+}
+
+static sw_inline uint8_t swTable_ctrl_hash(uint64_t hashv)
+{
+    return (hashv * 0x9E3779B97F4A7C15ULL) >> 57;
+}
+
+/**
+ * open addressing, linear probing over the control bytes,
+ * only the rows carrying the same 7 bits of hash have their key compared
+ */
+static swTableRow* swTable_probe(swTable_slots *slots, uint64_t hashv, char *key, int keylen, size_t *slot)
+{
+    size_t index = hashv % slots->slot_num;
+    uint8_t h2 = swTable_ctrl_hash(hashv);
+    uint32_t max_probe = *slots->max_probe;
+    uint32_t i;
+
+    for (i = 0; i <= max_probe; i++)
+    {
+        uint8_t ctrl = __atomic_load_n(&slots->ctrl[index], __ATOMIC_ACQUIRE);
+        if (ctrl == SW_TABLE_CTRL_EMPTY)
+        {
+            break;
+        }
+        if (ctrl == h2)
+        {
+            swTableRow *row = slots->rows[index];
+            if (strncmp(row->key, key, keylen) == 0 && (keylen == SW_TABLE_KEY_SIZE || row->key[keylen] == '\0'))
+            {
+                if (slot)
+                {
+                    *slot = index;
+                }
+                return row;
+            }
+        }
+        if (++index == slots->slot_num)
+        {
+            index = 0;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * claim the first free slot after the home slot, the caller holds the lock of the home slot
+ * so the same key can never be inserted twice, other keys race for the slot with CAS,
+ * the control byte stays BUSY until the caller publishes the row
+ */
+static swTableRow* swTable_probe_claim(swTable_slots *slots, uint64_t hashv, char *key, int keylen, size_t *slot)
+{
+    size_t index = hashv % slots->slot_num;
+    uint32_t i;
+
+    for (i = 0; i < slots->slot_num; i++)
+    {
+        uint8_t ctrl = slots->ctrl[index];
+        if ((ctrl == SW_TABLE_CTRL_EMPTY || ctrl == SW_TABLE_CTRL_DELETED)
+                && sw_atomic_cmp_set(&slots->ctrl[index], ctrl, SW_TABLE_CTRL_BUSY))
+        {
+            for (;;)
+            {
+                uint32_t max_probe = *slots->max_probe;
+                if (i <= max_probe || sw_atomic_cmp_set(slots->max_probe, max_probe, i))
+                {
+                    break;
+                }
+            }
+            swTableRow *row = slots->rows[index];
+            memcpy(row->key, key, keylen);
+            row->active = 1;
+            *slot = index;
+            return row;
+        }
+        if (++index == slots->slot_num)
+        {
+            index = 0;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * the row header is also the lock of another home slot, only clear the entry,
+ * the control byte goes first so that nobody trusts the key while it is wiped
+ */
+static sw_inline void swTable_slot_clear(swTable *table, swTable_slots *slots, swTableRow *row, size_t slot)
+{
+    __atomic_store_n(&slots->ctrl[slot], SW_TABLE_CTRL_DELETED, __ATOMIC_RELEASE);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    row->active = 0;
+    bzero(row->key, sizeof(row->key) + table->item_size);
+}
+
+static void swTable_resize(swTable *table);
+
+static swTableRow* swTable_probe_insert(swTable *table, swTable_slots *slots, uint64_t hashv, char *key, int keylen)
+{
+    swTable_slots current, old_slots;
+    swTableRow *new_root = NULL;
+    uint8_t resizing;
+
+    if (sw_atomic_add_fetch(&table->row_num, 1) > table->size)
+    {
+        //the last resize may have finished after the check in swTableRow_set
+        if (!table->resizing && table->max_size > table->size)
+        {
+            swTable_resize(table);
+        }
+        if (table->row_num > table->size)
+        {
+            sw_atomic_fetch_sub(&table->row_num, 1);
+            return NULL;
+        }
+        /**
+         * the slots of the caller became the old generation, insert into the new one,
+         * the old home slot stays locked so the key can be neither migrated nor inserted by anyone else,
+         * lock order is old home then new home like the migration
+         */
+        swTable_slots_get(table, &current, &old_slots, &resizing);
+        if (resizing && current.rows != slots->rows && old_slots.rows == slots->rows)
+        {
+            slots = &current;
+            new_root = slots->rows[hashv % slots->slot_num];
+            swTableRow_lock(new_root);
+        }
+    }
+
+    size_t slot;
+    swTableRow *row = swTable_probe_claim(slots, hashv, key, keylen, &slot);
+    if (row == NULL)
+    {
+        sw_atomic_fetch_sub(&table->row_num, 1);
+    }
+    else
+    {
+        __atomic_store_n(&slots->ctrl[slot], swTable_ctrl_hash(hashv), __ATOMIC_RELEASE);
+    }
+    if (new_root)
+    {
+        swTableRow_unlock(new_root);
+    }
+    return row;
+}
+
+/**
+ * double the table into the next reserved generation, the rows are moved later by the writers in small batches
+ */
+static void swTable_resize(swTable *table)
+{
+    table->lock.lock(&table->lock);
+    if (table->resizing || table->size * 2 > table->max_size || table->row_num < table->size * SW_TABLE_RESIZE_THRESHOLD)
+    {
+        table->lock.unlock(&table->lock);
+        return;
+    }
+
+    size_t size = table->size * 2;
+    size_t memory_size = swTable_slots_memory_size(table, size);
+    if (table->memory_offset + memory_size > table->memory_size)
+    {
+        table->lock.unlock(&table->lock);
+        return;
+    }
+
+    swTable_slots slots;
+    swTable_slots_init(table, (char *) table->memory + table->memory_offset, swTable_slot_num(table, size), &slots);
+    table->memory_offset += memory_size;
+
+    sw_atomic_fetch_add(&table->generation, 1);
+    table->old_rows = table->rows;
+    table->old_ctrl = table->ctrl;
+    table->old_slot_num = table->slot_num;
+    table->old_max_probe = table->max_probe;
+    table->rows = slots.rows;
+    table->ctrl = slots.ctrl;
+    table->slot_num = slots.slot_num;
+    table->max_probe = slots.max_probe;
+    table->size = size;
+    table->migrate_index = (uint64_t) (table->generation + 1) << 32;
+    table->migrated = 0;
+    table->resizing = 1;
+    sw_atomic_fetch_add(&table->generation, 1);
+
+    table->lock.unlock(&table->lock);
+    swTraceLog(SW_TRACE_NORMAL, "table resize to %ld rows, %ld slots.", size, slots.slot_num);
+}
+
+/**
+ * move every row whose home is the given old slot into the new generation,
+ * lock order is always old home then new home
+ */
+static void swTable_migrate_slot(swTable *table, swTable_slots *slots, swTable_slots *old_slots, size_t home,
+        sw_atomic_t generation)
+{
+    swTableRow *root = old_slots->rows[home];
+    swTableRow_lock(root);
+    if (table->generation != generation)
+    {
+        swTableRow_unlock(root);
+        return;
+    }
+
+    char key[SW_TABLE_KEY_SIZE];
+    size_t index = home;
+    uint32_t i, max_probe = *old_slots->max_probe;
+    for (i = 0; i <= max_probe; i++)
+    {
+        uint8_t ctrl = old_slots->ctrl[index];
+        if (ctrl == SW_TABLE_CTRL_EMPTY)
+        {
+            break;
+        }
+        if (ctrl < SW_TABLE_CTRL_EMPTY)
+        {
+            /**
+             * rows of other home slots may be cleared meanwhile, the key is only trusted
+             * if the control byte did not change while it was copied
+             */
+            swTableRow *row = old_slots->rows[index];
+            memcpy(key, row->key, SW_TABLE_KEY_SIZE);
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            if (__atomic_load_n(&old_slots->ctrl[index], __ATOMIC_ACQUIRE) != ctrl)
+            {
+                goto _next;
+            }
+            int keylen = strnlen(key, SW_TABLE_KEY_SIZE);
+            uint64_t hashv = swTable_hash_key(key, keylen);
+            if (hashv % old_slots->slot_num == home && swTable_ctrl_hash(hashv) == ctrl)
+            {
+                swTableRow *new_root = slots->rows[hashv % slots->slot_num];
+                size_t slot;
+                swTableRow_lock(new_root);
+                //the new generation has twice the slots of the old one, there is always room
+                swTableRow *new_row = swTable_probe_claim(slots, hashv, key, keylen, &slot);
+                memcpy(new_row->data, row->data, table->item_size);
+                __atomic_store_n(&slots->ctrl[slot], swTable_ctrl_hash(hashv), __ATOMIC_RELEASE);
+                swTableRow_unlock(new_root);
+
+                swTable_slot_clear(table, old_slots, row, index);
+            }
+        }
+        _next:
+        if (++index == old_slots->slot_num)
+        {
+            index = 0;
+        }
+    }
+    swTableRow_unlock(root);
+}
+
+/**
+ * the first writer to flag the batch as done counts it, the one counting the last batch completes the resize
+ */
+static void swTable_migrate_done(swTable *table, swTable_slots *old_slots, size_t batch)
+{
+    uint8_t *done = old_slots->ctrl + old_slots->slot_num + batch;
+    if (!sw_atomic_cmp_set(done, 0, 1))
+    {
+        return;
+    }
+    size_t n = MIN(SW_TABLE_MIGRATE_BATCH, old_slots->slot_num - batch * SW_TABLE_MIGRATE_BATCH);
+    if (sw_atomic_add_fetch(&table->migrated, n) < old_slots->slot_num)
+    {
+        return;
+    }
+
+    table->lock.lock(&table->lock);
+    sw_atomic_fetch_add(&table->generation, 1);
+    table->resizing = 0;
+    sw_atomic_fetch_add(&table->generation, 1);
+    table->lock.unlock(&table->lock);
+}
+
+/**
+ * take the next batch of old slots, once all of them are taken help with a batch
+ * whose writer has not finished it yet, so a descheduled writer never holds back the resize
+ */
+static void swTable_migrate(swTable *table, swTable_slots *slots, swTable_slots *old_slots, sw_atomic_t generation)
+{
+    size_t batch_num = swTable_batch_num(old_slots->slot_num);
+    size_t i, batch;
+    uint64_t start;
+
+    for (;;)
+    {
+        start = table->migrate_index;
+        if ((start >> 32) != generation)
+        {
+            return;
+        }
+        batch = (start & 0xffffffff) / SW_TABLE_MIGRATE_BATCH;
+        if (batch >= batch_num)
+        {
+            for (batch = 0; batch < batch_num; batch++)
+            {
+                if (old_slots->ctrl[old_slots->slot_num + batch] == 0)
+                {
+                    break;
+                }
+            }
+            if (batch == batch_num)
+            {
+                return;
+            }
+            break;
+        }
+        if (sw_atomic_cmp_set(&table->migrate_index, start, start + SW_TABLE_MIGRATE_BATCH))
+        {
+            break;
+        }
+    }
+
+    size_t index = batch * SW_TABLE_MIGRATE_BATCH;
+    size_t n = MIN(SW_TABLE_MIGRATE_BATCH, old_slots->slot_num - index);
+    for (i = 0; i < n; i++)
+    {
+        swTable_migrate_slot(table, slots, old_slots, index + i, generation);
+    }
+    if (table->generation == generation)
+    {
+        swTable_migrate_done(table, old_slots, batch);
+    }
+}
+
+/**
+ * lock the home slot of the key in the current generation, while resizing its old home slot is migrated first,
+ * so with the lock held the key can only be in the current generation
+ */
+static swTableRow* swTable_lock_home(swTable *table, uint64_t hashv, swTable_slots *slots)
+{
+    swTable_slots old_slots;
+    uint8_t resizing;
+
+    for (;;)
+    {
+        sw_atomic_t generation = swTable_slots_get(table, slots, &old_slots, &resizing);
+        if (resizing)
+        {
+            swTable_migrate_slot(table, slots, &old_slots, hashv % old_slots.slot_num, generation);
+            swTable_migrate(table, slots, &old_slots, generation);
+        }
+        swTableRow *root = slots->rows[hashv % slots->slot_num];
+        swTableRow_lock(root);
+        if (table->generation == generation)
+        {
+            return root;
+        }
+        swTableRow_unlock(root);
+    }
+}
+
+static sw_inline swTableRow* swTableRow_find(swTable *table, swTableRow *row, char *key, int keylen)
+{
+    /**
+     * the chain may be changed under an optimistic reader, never walk more rows than the table has
+     */
+    size_t n = table->size;
+    for (; row && n > 0; row = row->next, n--)
+    {
+        if (strncmp(row->key, key, keylen) == 0)
+        {
+            return row->active ? row : NULL;
+        }
+    }
+    return NULL;
+}
+
 swTableRow* swTableRow_get(swTable *table, char *key, int keylen, swTableRow** rowlock)
 {
     if (keylen > SW_TABLE_KEY_SIZE)
@@ -308,32 +851,208 @@ swTableRow* swTableRow_get(swTable *table, char *key, int keylen, swTableRow** r
         keylen = SW_TABLE_KEY_SIZE;
     }
 
-    swTableRow *row = swTable_hash(table, key, keylen);
+    uint64_t hashv = swTable_hash_key(key, keylen);
+    if (table->layout == SW_TABLE_LAYOUT_OPEN_ADDRESSING)
+    {
+        swTable_slots slots;
+        *rowlock = swTable_lock_home(table, hashv, &slots);
+        return swTable_probe(&slots, hashv, key, keylen, NULL);
+    }
+
+    swTableRow *row = swTable_hash(table, hashv);
     *rowlock = row;
     swTableRow_lock(row);
 
-    for (;;)
+    return swTableRow_find(table, row, key, keylen);
+}
+
+/**
+ * swTable_probe for the optimistic reader, the control byte of every slot it reads is kept in seen,
+ * returns SW_ERR if the probe is too long to be verified
+ */
+static int swTable_probe_snapshot(swTable_slots *slots, uint64_t hashv, char *key, int keylen, swTableRow **row,
+        uint8_t *seen, uint32_t *seen_num)
+{
+    size_t index = hashv % slots->slot_num;
+    uint8_t h2 = swTable_ctrl_hash(hashv);
+    uint32_t max_probe = *slots->max_probe;
+    uint32_t i;
+
+    *row = NULL;
+    for (i = 0; i <= max_probe; i++)
     {
-        if (strncmp(row->key, key, keylen) == 0)
+        if (*seen_num == SW_TABLE_READ_PROBE_MAX)
+        {
+            return SW_ERR;
+        }
+        uint8_t ctrl = __atomic_load_n(&slots->ctrl[index], __ATOMIC_ACQUIRE);
+        seen[(*seen_num)++] = ctrl;
+        if (ctrl == SW_TABLE_CTRL_EMPTY)
         {
-            if (!row->active)
+            break;
+        }
+        if (ctrl == h2)
+        {
+            swTableRow *_row = slots->rows[index];
+            if (strncmp(_row->key, key, keylen) == 0 && (keylen == SW_TABLE_KEY_SIZE || _row->key[keylen] == '\0'))
             {
-                row = NULL;
+                *row = _row;
+                break;
             }
+        }
+        if (++index == slots->slot_num)
+        {
+            index = 0;
+        }
+    }
+    return SW_OK;
+}
+
+/**
+ * the slots read by swTable_probe_snapshot still have the same control bytes
+ */
+static int swTable_probe_verify(swTable_slots *slots, uint64_t hashv, uint8_t *seen, uint32_t seen_num)
+{
+    size_t index = hashv % slots->slot_num;
+    uint32_t i;
+
+    for (i = 0; i < seen_num; i++)
+    {
+        if (__atomic_load_n(&slots->ctrl[index], __ATOMIC_ACQUIRE) != seen[i])
+        {
+            return SW_ERR;
+        }
+        if (++index == slots->slot_num)
+        {
+            index = 0;
+        }
+    }
+    return SW_OK;
+}
+
+/**
+ * open addressing, while resizing the key is either in the new or in the old generation,
+ * a migration bumps the versions of both home slots, the probe may also cross the rows of other keys,
+ * so the control byte of every slot read is checked again after the copy
+ */
+static swTableRow* swTableRow_read_slots(swTable *table, uint64_t hashv, char *key, int keylen)
+{
+    size_t row_size = sizeof(swTableRow) + table->item_size;
+    swTable_slots slots, old_slots;
+    swTableRow *row;
+    uint8_t resizing;
+    uint8_t seen[SW_TABLE_READ_PROBE_MAX];
+    uint32_t seen_num, old_seen_num;
+    int i;
+
+    for (i = 0; i < SW_TABLE_READ_RETRY; i++)
+    {
+        sw_atomic_t generation = swTable_slots_get(table, &slots, &old_slots, &resizing);
+        swTableRow *root = slots.rows[hashv % slots.slot_num];
+        swTableRow *old_root = resizing ? old_slots.rows[hashv % old_slots.slot_num] : root;
+        sw_atomic_t version = __atomic_load_n(&root->version, __ATOMIC_ACQUIRE);
+        sw_atomic_t old_version = __atomic_load_n(&old_root->version, __ATOMIC_ACQUIRE);
+        if ((version | old_version) & 1)
+        {
+            sw_atomic_cpu_pause();
+            continue;
+        }
+        seen_num = 0;
+        if (swTable_probe_snapshot(&slots, hashv, key, keylen, &row, seen, &seen_num) < 0)
+        {
             break;
         }
-        else if (row->next == NULL)
+        old_seen_num = seen_num;
+        if (row == NULL && resizing
+                && swTable_probe_snapshot(&old_slots, hashv, key, keylen, &row, seen, &old_seen_num) < 0)
         {
-            row = NULL;
             break;
         }
-        else
+        if (row)
         {
-            row = row->next;
+            memcpy(table->read_buffer, row, row_size);
         }
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (root->version != version || old_root->version != old_version || table->generation != generation)
+        {
+            continue;
+        }
+        if (swTable_probe_verify(&slots, hashv, seen, seen_num) < 0
+                || (old_seen_num > seen_num
+                        && swTable_probe_verify(&old_slots, hashv, seen + seen_num, old_seen_num - seen_num) < 0))
+        {
+            continue;
+        }
+        //the slot may have been given to another key meanwhile
+        if (row && (strncmp(table->read_buffer->key, key, keylen) != 0
+                || (keylen < SW_TABLE_KEY_SIZE && table->read_buffer->key[keylen] != '\0')))
+        {
+            continue;
+        }
+        return row ? table->read_buffer : NULL;
     }
 
-    return row;
+    //too much write contention, wait for the lock
+    swTableRow *rowlock;
+    row = swTableRow_get(table, key, keylen, &rowlock);
+    if (row)
+    {
+        memcpy(table->read_buffer, row, row_size);
+    }
+    swTableRow_unlock(rowlock);
+    return row ? table->read_buffer : NULL;
+}
+
+/**
+ * seqlock read, copy the row into table->read_buffer and retry if a writer touched the slot meanwhile
+ */
+swTableRow* swTableRow_read(swTable *table, char *key, int keylen)
+{
+    if (keylen > SW_TABLE_KEY_SIZE)
+    {
+        keylen = SW_TABLE_KEY_SIZE;
+    }
+
+    uint64_t hashv = swTable_hash_key(key, keylen);
+    if (table->layout == SW_TABLE_LAYOUT_OPEN_ADDRESSING)
+    {
+        return swTableRow_read_slots(table, hashv, key, keylen);
+    }
+
+    swTableRow *root = swTable_hash(table, hashv);
+    swTableRow *row;
+    size_t row_size = sizeof(swTableRow) + table->item_size;
+    int i;
+
+    for (i = 0; i < SW_TABLE_READ_RETRY; i++)
+    {
+        sw_atomic_t version = __atomic_load_n(&root->version, __ATOMIC_ACQUIRE);
+        if (version & 1)
+        {
+            sw_atomic_cpu_pause();
+            continue;
+        }
+        row = swTableRow_find(table, root, key, keylen);
+        if (row)
+        {
+            memcpy(table->read_buffer, row, row_size);
+        }
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (root->version == version)
+        {
+            return row ? table->read_buffer : NULL;
+        }
+    }
+
+    //too much write contention, wait for the lock
+    swTableRow_lock(root);
+    row = swTableRow_find(table, root, key, keylen);
+    if (row)
+    {
+        memcpy(table->read_buffer, row, row_size);
+    }
+    swTableRow_unlock(root);
+    return row ? table->read_buffer : NULL;
 }
 
 swTableRow* swTableRow_set(swTable *table, char *key, int keylen, swTableRow **rowlock)
@@ -343,7 +1062,22 @@ swTableRow* swTableRow_set(swTable *table, char *key, int keylen, swTableRow **r
         keylen = SW_TABLE_KEY_SIZE;
     }
 
-    swTableRow *row = swTable_hash(table, key, keylen);
+    uint64_t hashv = swTable_hash_key(key, keylen);
+
+    if (table->layout == SW_TABLE_LAYOUT_OPEN_ADDRESSING)
+    {
+        if (table->max_size > table->size && !table->resizing
+                && table->row_num >= table->size * SW_TABLE_RESIZE_THRESHOLD)
+        {
+            swTable_resize(table);
+        }
+        swTable_slots slots;
+        *rowlock = swTable_lock_home(table, hashv, &slots);
+        swTableRow *exist = swTable_probe(&slots, hashv, key, keylen, NULL);
+        return exist ? exist : swTable_probe_insert(table, &slots, hashv, key, keylen);
+    }
+
+    swTableRow *row = swTable_hash(table, hashv);
     *rowlock = row;
     swTableRow_lock(row);
 
@@ -407,6 +1141,26 @@ swTableRow* swTableRow_set(swTable *table, char *key, int keylen, swTableRow **r
     return row;
 }
 
+static int swTableRow_del_slot(swTable *table, char *key, int keylen)
+{
+    uint64_t hashv = swTable_hash_key(key, keylen);
+    swTable_slots slots;
+    size_t slot;
+
+    swTableRow *root = swTable_lock_home(table, hashv, &slots);
+    swTableRow *row = swTable_probe(&slots, hashv, key, keylen, &slot);
+    if (row == NULL)
+    {
+        swTableRow_unlock(root);
+        return SW_ERR;
+    }
+    swTable_slot_clear(table, &slots, row, slot);
+    sw_atomic_fetch_sub(&(table->row_num), 1);
+    swTableRow_unlock(root);
+
+    return SW_OK;
+}
+
 int swTableRow_del(swTable *table, char *key, int keylen)
 {
     if (keylen > SW_TABLE_KEY_SIZE)
@@ -414,7 +1168,12 @@ int swTableRow_del(swTable *table, char *key, int keylen)
         keylen = SW_TABLE_KEY_SIZE;
     }
 
-    swTableRow *row = swTable_hash(table, key, keylen);
+    if (table->layout == SW_TABLE_LAYOUT_OPEN_ADDRESSING)
+    {
+        return swTableRow_del_slot(table, key, keylen);
+    }
+
+    swTableRow *row = swTable_hash(table, swTable_hash_key(key, keylen));
     //no exists
     if (!row->active)
     {
@@ -426,7 +1185,10 @@ int swTableRow_del(swTable *table, char *key, int keylen)
     {
         if (strncmp(row->key, key, keylen) == 0)
         {
-            bzero(row, sizeof(swTableRow) + table->item_size);
+            //the lock is held and the version is odd, only clear the entry
+            row->active = 0;
+            row->next = NULL;
+            bzero(row->key, sizeof(row->key) + table->item_size);
             goto delete_element;
         }
         else
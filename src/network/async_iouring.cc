@@ -0,0 +1,558 @@
+/*
+ +----------------------------------------------------------------------+
+ | Swoole                                                               |
+ +----------------------------------------------------------------------+
+ | This source file is subject to version 2.0 of the Apache license,    |
+ | that is bundled with this package in the file LICENSE, and is        |
+ | available through the world-wide-web at the following url:           |
+ | http://www.apache.org/licenses/LICENSE-2.0.html                      |
+ | If you did not receive a copy of the Apache2.0 license and are unable|
+ | to obtain it through the world-wide-web, please send a note to       |
+ | license@swoole.com so we can mail you a copy immediately.            |
+ +----------------------------------------------------------------------+
+ | Author: Tianfeng Han  <mikan.tenny@gmail.com>                        |
+ +----------------------------------------------------------------------+
+ */
+
+#include "swoole.h"
+#include "async.h"
+
+#ifdef SW_USE_IOURING
+
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
+
+#include <unordered_set>
+
+class async_iouring;
+static async_iouring *ring = nullptr;
+static bool ring_unavailable = false;
+
+/**
+ * file operations are submitted from the reactor thread straight to the kernel,
+ * completions are reaped in the event loop through an eventfd registered on the ring.
+ * talks to the kernel with raw syscalls, liburing is not required.
+ */
+class async_iouring
+{
+public:
+    async_iouring()
+    {
+        ring_fd = -1;
+        event_fd = -1;
+        sq_ptr = cq_ptr = MAP_FAILED;
+        sqes = (struct io_uring_sqe *) MAP_FAILED;
+        sq_tail = 0;
+        inflight = 0;
+        submit_deferred = false;
+        owner_pid = getpid();
+        bzero(ops, sizeof(ops));
+    }
+
+    ~async_iouring()
+    {
+        if (sqes != MAP_FAILED)
+        {
+            munmap(sqes, sq_entries * sizeof(struct io_uring_sqe));
+        }
+        if (cq_ptr != MAP_FAILED && cq_ptr != sq_ptr)
+        {
+            munmap(cq_ptr, cq_size);
+        }
+        if (sq_ptr != MAP_FAILED)
+        {
+            munmap(sq_ptr, sq_size);
+        }
+        if (ring_fd >= 0)
+        {
+            close(ring_fd);
+        }
+        if (event_fd >= 0)
+        {
+            close(event_fd);
+        }
+    }
+
+    int create(unsigned entries)
+    {
+        struct io_uring_params params;
+        bzero(&params, sizeof(params));
+
+        ring_fd = syscall(__NR_io_uring_setup, entries, &params);
+        if (ring_fd < 0)
+        {
+            swSysError("io_uring_setup(%u) failed.", entries);
+            return SW_ERR;
+        }
+        sq_entries = params.sq_entries;
+        cq_entries = params.cq_entries;
+
+        sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+        if (params.features & IORING_FEAT_SINGLE_MMAP)
+        {
+            sq_size = cq_size = MAX(sq_size, cq_size);
+        }
+        sq_ptr = mmap(NULL, sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQ_RING);
+        if (sq_ptr == MAP_FAILED)
+        {
+            swSysError("mmap(IORING_OFF_SQ_RING) failed.");
+            return SW_ERR;
+        }
+        if (params.features & IORING_FEAT_SINGLE_MMAP)
+        {
+            cq_ptr = sq_ptr;
+        }
+        else
+        {
+            cq_ptr = mmap(NULL, cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_CQ_RING);
+            if (cq_ptr == MAP_FAILED)
+            {
+                swSysError("mmap(IORING_OFF_CQ_RING) failed.");
+                return SW_ERR;
+            }
+        }
+        sqes = (struct io_uring_sqe *) mmap(NULL, sq_entries * sizeof(struct io_uring_sqe), PROT_READ | PROT_WRITE,
+                MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQES);
+        if (sqes == MAP_FAILED)
+        {
+            swSysError("mmap(IORING_OFF_SQES) failed.");
+            return SW_ERR;
+        }
+
+        sq_khead = (unsigned *) ((char *) sq_ptr + params.sq_off.head);
+        sq_ktail = (unsigned *) ((char *) sq_ptr + params.sq_off.tail);
+        sq_mask = *(unsigned *) ((char *) sq_ptr + params.sq_off.ring_mask);
+        cq_khead = (unsigned *) ((char *) cq_ptr + params.cq_off.head);
+        cq_ktail = (unsigned *) ((char *) cq_ptr + params.cq_off.tail);
+        cq_mask = *(unsigned *) ((char *) cq_ptr + params.cq_off.ring_mask);
+        cqes = (struct io_uring_cqe *) ((char *) cq_ptr + params.cq_off.cqes);
+
+        /**
+         * sqe index i always sits in ring slot i, the indirection array never changes
+         */
+        unsigned *sq_array = (unsigned *) ((char *) sq_ptr + params.sq_off.array);
+        for (unsigned i = 0; i < sq_entries; i++)
+        {
+            sq_array[i] = i;
+        }
+        sq_tail = *sq_ktail;
+
+        if (probe(params.features) < 0)
+        {
+            return SW_ERR;
+        }
+
+        event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (event_fd < 0)
+        {
+            swSysError("eventfd() failed.");
+            return SW_ERR;
+        }
+        if (syscall(__NR_io_uring_register, ring_fd, IORING_REGISTER_EVENTFD, &event_fd, 1) < 0)
+        {
+            swSysError("io_uring_register(IORING_REGISTER_EVENTFD) failed.");
+            return SW_ERR;
+        }
+        return SW_OK;
+    }
+
+    inline bool supports(uint8_t type)
+    {
+        return type < SW_AIO_OPCODE_MAX && ops[type];
+    }
+
+    /**
+     * queue one request, it is handed to the kernel in a single io_uring_enter()
+     * together with everything else queued in the same event loop round
+     */
+    int dispatch(swAio_event *event)
+    {
+        //never hand out more requests than the completion ring can hold
+        if (inflight >= cq_entries)
+        {
+            return SW_ERR;
+        }
+        if (sq_tail - __atomic_load_n(sq_khead, __ATOMIC_ACQUIRE) >= sq_entries)
+        {
+            submit();
+            if (sq_tail - __atomic_load_n(sq_khead, __ATOMIC_ACQUIRE) >= sq_entries)
+            {
+                return SW_ERR;
+            }
+        }
+
+        struct io_uring_sqe *sqe = &sqes[sq_tail & sq_mask];
+        bzero(sqe, sizeof(*sqe));
+        if (prepare(sqe, event) < 0)
+        {
+            return SW_ERR;
+        }
+        sqe->user_data = (uint64_t) (uintptr_t) event;
+        sq_tail++;
+        inflight++;
+        __atomic_store_n(sq_ktail, sq_tail, __ATOMIC_RELEASE);
+
+        swReactor *reactor = SwooleG.main_reactor;
+        if (!reactor->start)
+        {
+            submit();
+        }
+        else if (!submit_deferred)
+        {
+            submit_deferred = true;
+            reactor->defer(reactor, submit_callback, nullptr);
+        }
+        return SW_OK;
+    }
+
+    void submit()
+    {
+        submit_deferred = false;
+        unsigned n = sq_tail - __atomic_load_n(sq_khead, __ATOMIC_ACQUIRE);
+        while (n > 0)
+        {
+            int ret = syscall(__NR_io_uring_enter, ring_fd, n, 0, 0, NULL, 0);
+            if (ret < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                if (errno == EAGAIN || errno == EBUSY)
+                {
+                    //the kernel is short of resources, retry in the next round
+                    submit_deferred = true;
+                    SwooleG.main_reactor->defer(SwooleG.main_reactor, submit_callback, nullptr);
+                    return;
+                }
+                swSysError("io_uring_enter(%u) failed.", n);
+                return;
+            }
+            n -= ret;
+        }
+    }
+
+    /**
+     * pop one completion and run its callback, the callback may dispatch again
+     */
+    bool reap()
+    {
+        unsigned head = *cq_khead;
+        if (head == __atomic_load_n(cq_ktail, __ATOMIC_ACQUIRE))
+        {
+            return false;
+        }
+        struct io_uring_cqe *cqe = &cqes[head & cq_mask];
+        swAio_event *event = (swAio_event *) (uintptr_t) cqe->user_data;
+        int res = cqe->res;
+        __atomic_store_n(cq_khead, head + 1, __ATOMIC_RELEASE);
+
+        inflight--;
+        SwooleAIO.task_num--;
+        complete(event, res);
+        event->callback(event);
+        return true;
+    }
+
+    /**
+     * wait for the requests the kernel holds, the events may live on the stacks of coroutines that are gone,
+     * so only the statx buffers are released, the callbacks are not run.
+     * a forked child shares the ring with the parent, the completions belong to the parent
+     */
+    void drain()
+    {
+        if (owner_pid == getpid())
+        {
+            //queued in this round but never handed to the kernel
+            unsigned waiting = inflight - (sq_tail - __atomic_load_n(sq_khead, __ATOMIC_ACQUIRE));
+            while (waiting > 0)
+            {
+                unsigned head = *cq_khead;
+                unsigned tail = __atomic_load_n(cq_ktail, __ATOMIC_ACQUIRE);
+                if (head == tail)
+                {
+                    if (syscall(__NR_io_uring_enter, ring_fd, 0, 1, IORING_ENTER_GETEVENTS, NULL, 0) < 0 && errno != EINTR)
+                    {
+                        swSysError("io_uring_enter(IORING_ENTER_GETEVENTS) failed.");
+                        break;
+                    }
+                    continue;
+                }
+                __atomic_store_n(cq_khead, tail, __ATOMIC_RELEASE);
+                waiting -= MIN(tail - head, waiting);
+            }
+        }
+        for (auto stx : statx_bufs)
+        {
+            sw_free(stx);
+        }
+        statx_bufs.clear();
+    }
+
+    int event_fd;
+    unsigned inflight;
+
+private:
+    static void submit_callback(void *data)
+    {
+        //the ring may have been released before the deferred submission runs
+        if (ring)
+        {
+            ring->submit();
+        }
+    }
+
+    int probe(unsigned features)
+    {
+        size_t len = sizeof(struct io_uring_probe) + 256 * sizeof(struct io_uring_probe_op);
+        struct io_uring_probe *p = (struct io_uring_probe *) sw_calloc(1, len);
+        if (p == NULL)
+        {
+            swWarn("calloc(%ld) failed.", len);
+            return SW_ERR;
+        }
+        if (syscall(__NR_io_uring_register, ring_fd, IORING_REGISTER_PROBE, p, 256) < 0)
+        {
+            swSysError("io_uring_register(IORING_REGISTER_PROBE) failed.");
+            sw_free(p);
+            return SW_ERR;
+        }
+
+        auto supported = [p](int op) -> bool
+        {
+            return op <= p->last_op && (p->ops[op].flags & IO_URING_OP_SUPPORTED);
+        };
+        //read/write at the current file position need offset -1
+        if (features & IORING_FEAT_RW_CUR_POS)
+        {
+            ops[SW_AIO_READ] = supported(IORING_OP_READ);
+            ops[SW_AIO_WRITE] = supported(IORING_OP_WRITE);
+        }
+        ops[SW_AIO_OPEN] = supported(IORING_OP_OPENAT);
+        ops[SW_AIO_FSTAT] = supported(IORING_OP_STATX);
+        ops[SW_AIO_UNLINK] = ops[SW_AIO_RMDIR] = supported(IORING_OP_UNLINKAT);
+        ops[SW_AIO_MKDIR] = supported(IORING_OP_MKDIRAT);
+        ops[SW_AIO_RENAME] = supported(IORING_OP_RENAMEAT);
+        sw_free(p);
+        return SW_OK;
+    }
+
+    int prepare(struct io_uring_sqe *sqe, swAio_event *event)
+    {
+        switch (event->type)
+        {
+        case SW_AIO_OPEN:
+            sqe->opcode = IORING_OP_OPENAT;
+            sqe->fd = AT_FDCWD;
+            sqe->addr = (uint64_t) (uintptr_t) event->buf;
+            sqe->len = (uint32_t) event->offset;
+            sqe->open_flags = event->flags;
+            break;
+        case SW_AIO_READ:
+        case SW_AIO_WRITE:
+            sqe->opcode = event->type == SW_AIO_READ ? IORING_OP_READ : IORING_OP_WRITE;
+            sqe->fd = event->fd;
+            sqe->addr = (uint64_t) (uintptr_t) event->buf;
+            sqe->len = event->nbytes;
+            sqe->off = (uint64_t) -1;
+            break;
+        case SW_AIO_FSTAT:
+        {
+            /**
+             * statx needs a bigger buffer than struct stat, it is converted on completion
+             */
+            struct statx *stx = (struct statx *) sw_malloc(sizeof(struct statx));
+            if (stx == NULL)
+            {
+                swWarn("malloc(%ld) failed.", sizeof(struct statx));
+                return SW_ERR;
+            }
+            sqe->opcode = IORING_OP_STATX;
+            sqe->fd = event->fd;
+            sqe->addr = (uint64_t) (uintptr_t) "";
+            sqe->len = STATX_BASIC_STATS;
+            sqe->statx_flags = AT_EMPTY_PATH;
+            sqe->off = (uint64_t) (uintptr_t) stx;
+            event->offset = (off_t) stx;
+            statx_bufs.insert(stx);
+            break;
+        }
+        case SW_AIO_UNLINK:
+        case SW_AIO_RMDIR:
+            sqe->opcode = IORING_OP_UNLINKAT;
+            sqe->fd = AT_FDCWD;
+            sqe->addr = (uint64_t) (uintptr_t) event->buf;
+            sqe->unlink_flags = event->type == SW_AIO_RMDIR ? AT_REMOVEDIR : 0;
+            break;
+        case SW_AIO_MKDIR:
+            sqe->opcode = IORING_OP_MKDIRAT;
+            sqe->fd = AT_FDCWD;
+            sqe->addr = (uint64_t) (uintptr_t) event->buf;
+            sqe->len = (uint32_t) event->offset;
+            break;
+        case SW_AIO_RENAME:
+            sqe->opcode = IORING_OP_RENAMEAT;
+            sqe->fd = AT_FDCWD;
+            sqe->addr = (uint64_t) (uintptr_t) event->buf;
+            sqe->len = (uint32_t) AT_FDCWD;
+            sqe->off = (uint64_t) event->offset;
+            break;
+        default:
+            return SW_ERR;
+        }
+        return SW_OK;
+    }
+
+    void complete(swAio_event *event, int res)
+    {
+        if (event->type == SW_AIO_FSTAT)
+        {
+            struct statx *stx = (struct statx *) event->offset;
+            if (res == 0)
+            {
+                struct stat *st = (struct stat *) event->buf;
+                bzero(st, sizeof(*st));
+                st->st_dev = makedev(stx->stx_dev_major, stx->stx_dev_minor);
+                st->st_ino = stx->stx_ino;
+                st->st_mode = stx->stx_mode;
+                st->st_nlink = stx->stx_nlink;
+                st->st_uid = stx->stx_uid;
+                st->st_gid = stx->stx_gid;
+                st->st_rdev = makedev(stx->stx_rdev_major, stx->stx_rdev_minor);
+                st->st_size = stx->stx_size;
+                st->st_blksize = stx->stx_blksize;
+                st->st_blocks = stx->stx_blocks;
+                st->st_atim.tv_sec = stx->stx_atime.tv_sec;
+                st->st_atim.tv_nsec = stx->stx_atime.tv_nsec;
+                st->st_mtim.tv_sec = stx->stx_mtime.tv_sec;
+                st->st_mtim.tv_nsec = stx->stx_mtime.tv_nsec;
+                st->st_ctim.tv_sec = stx->stx_ctime.tv_sec;
+                st->st_ctim.tv_nsec = stx->stx_ctime.tv_nsec;
+            }
+            statx_bufs.erase(stx);
+            sw_free(stx);
+        }
+        if (res < 0)
+        {
+            event->ret = -1;
+            event->error = -res;
+        }
+        else
+        {
+            event->ret = res;
+            event->error = 0;
+        }
+    }
+
+    int ring_fd;
+    unsigned sq_entries;
+    unsigned cq_entries;
+    size_t sq_size;
+    size_t cq_size;
+    void *sq_ptr;
+    void *cq_ptr;
+    unsigned *sq_khead;
+    unsigned *sq_ktail;
+    unsigned sq_mask;
+    unsigned sq_tail;
+    struct io_uring_sqe *sqes;
+    unsigned *cq_khead;
+    unsigned *cq_ktail;
+    unsigned cq_mask;
+    struct io_uring_cqe *cqes;
+    bool submit_deferred;
+    pid_t owner_pid;
+    uint8_t ops[SW_AIO_OPCODE_MAX];
+    /* the statx buffers of the requests in flight */
+    std::unordered_set<struct statx *> statx_bufs;
+};
+
+static int swAio_iouring_onCompleted(swReactor *reactor, swEvent *event)
+{
+    uint64_t n;
+    if (read(event->fd, &n, sizeof(n)) < 0 && errno != EAGAIN)
+    {
+        swSysError("read(%d) failed.", event->fd);
+    }
+    //the ring may be released by a callback
+    while (ring && ring->reap());
+    return SW_OK;
+}
+
+int swAio_iouring_init(void)
+{
+    if (!SwooleAIO.use_iouring)
+    {
+        return SW_ERR;
+    }
+    if (SwooleAIO.iouring_init)
+    {
+        return SW_OK;
+    }
+    if (ring_unavailable || !SwooleG.main_reactor)
+    {
+        return SW_ERR;
+    }
+
+    swReactor *reactor = SwooleG.main_reactor;
+    ring = new async_iouring();
+    if (ring->create(SW_AIO_IOURING_ENTRIES) < 0)
+    {
+        swWarn("io_uring is unavailable, fall back to the thread pool.");
+        goto _error;
+    }
+    if (!swReactor_handle_isset(reactor, SW_FD_IOURING))
+    {
+        reactor->setHandle(reactor, SW_FD_IOURING, swAio_iouring_onCompleted);
+    }
+    if (reactor->add(reactor, ring->event_fd, SW_FD_IOURING) < 0)
+    {
+        goto _error;
+    }
+    SwooleAIO.iouring_init = 1;
+    return SW_OK;
+
+    _error:
+    delete ring;
+    ring = nullptr;
+    ring_unavailable = true;
+    return SW_ERR;
+}
+
+int swAio_iouring_dispatch(swAio_event *event)
+{
+    if (swAio_iouring_init() < 0)
+    {
+        return SW_ERR;
+    }
+    if (!ring->supports(event->type) || ring->dispatch(event) < 0)
+    {
+        return SW_ERR;
+    }
+    SwooleAIO.task_num++;
+    return SW_OK;
+}
+
+void swAio_iouring_free(void)
+{
+    if (!SwooleAIO.iouring_init)
+    {
+        return;
+    }
+    if (SwooleG.main_reactor)
+    {
+        SwooleG.main_reactor->del(SwooleG.main_reactor, ring->event_fd);
+    }
+    ring->drain();
+    SwooleAIO.task_num -= ring->inflight;
+    delete ring;
+    ring = nullptr;
+    SwooleAIO.iouring_init = 0;
+}
+
+#endif
@@ -23,6 +23,7 @@
 #include <condition_variable>
 #include <mutex>
 #include <queue>
+#include <cstdint>
 
 using namespace std;
 
@@ -30,48 +31,123 @@ typedef swAio_event async_event;
 
 swAsyncIO SwooleAIO;
 
-class async_event_queue
+class async_thread_pool;
+static async_thread_pool *pool = nullptr;
+
+/**
+ * bounded lock-free ring, safe for any number of producers and consumers
+ */
+class async_event_ring
 {
 public:
+    async_event_ring(size_t _size)
+    {
+        size = _size;
+        mask = _size - 1;
+        cells = new cell[size];
+        for (size_t i = 0; i < size; i++)
+        {
+            cells[i].sequence.store(i, memory_order_relaxed);
+        }
+        head.store(0, memory_order_relaxed);
+        tail.store(0, memory_order_relaxed);
+    }
+    ~async_event_ring()
+    {
+        delete[] cells;
+    }
     bool push(async_event *event)
     {
-        unique_lock<mutex> lock(_mutex);
-        _queue.push(event);
+        cell *_cell;
+        size_t pos = tail.load(memory_order_relaxed);
+        while (true)
+        {
+            _cell = &cells[pos & mask];
+            size_t seq = _cell->sequence.load(memory_order_acquire);
+            intptr_t diff = (intptr_t) seq - (intptr_t) pos;
+            if (diff == 0)
+            {
+                if (tail.compare_exchange_weak(pos, pos + 1, memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = tail.load(memory_order_relaxed);
+            }
+        }
+        _cell->event = event;
+        _cell->sequence.store(pos + 1, memory_order_release);
         return true;
     }
     async_event* pop()
     {
-        unique_lock<mutex> lock(_mutex);
-        if (_queue.empty())
+        cell *_cell;
+        size_t pos = head.load(memory_order_relaxed);
+        while (true)
         {
-            return nullptr;
+            _cell = &cells[pos & mask];
+            size_t seq = _cell->sequence.load(memory_order_acquire);
+            intptr_t diff = (intptr_t) seq - (intptr_t) (pos + 1);
+            if (diff == 0)
+            {
+                if (head.compare_exchange_weak(pos, pos + 1, memory_order_relaxed))
+                {
+                    break;
+                }
+            }
+            else if (diff < 0)
+            {
+                return nullptr;
+            }
+            else
+            {
+                pos = head.load(memory_order_relaxed);
+            }
         }
-        async_event* retval = _queue.front();
-        _queue.pop();
-        return retval;
+        async_event *event = _cell->event;
+        _cell->sequence.store(pos + mask + 1, memory_order_release);
+        return event;
     }
     bool empty()
     {
-        unique_lock<mutex> lock(_mutex);
-        return _queue.empty();
+        return head.load(memory_order_acquire) == tail.load(memory_order_acquire);
     }
 private:
-    queue<async_event*> _queue;
-    mutex _mutex;
+    struct cell
+    {
+        atomic<size_t> sequence;
+        async_event *event;
+    };
+    cell *cells;
+    size_t size;
+    size_t mask;
+    //keep the consumer and producer indexes on different cache lines
+    char _pad1[64];
+    atomic<size_t> head;
+    char _pad2[64 - sizeof(atomic<size_t>)];
+    atomic<size_t> tail;
 };
 
 class async_thread_pool
 {
 public:
-    async_thread_pool(int _min_threads, int _max_threads)
+    async_thread_pool(int _min_threads, int _max_threads) :
+            queue(SW_AIO_QUEUE_SIZE), completed_queue(SW_AIO_QUEUE_SIZE * 2)
     {
         n_waiting = 0;
+        notified = false;
         running = false;
         min_threads = _min_threads;
         max_threads = _max_threads;
         current_task_id = 0;
 
-        if (swPipeBase_create(&_aio_pipe, 0) < 0)
+        if (swPipeNotify_auto(&_aio_pipe, 0, 0) < 0)
         {
             swoole_throw_error(SW_ERROR_SYSTEM_CALL_FAIL);
         }
@@ -80,22 +156,31 @@ public:
 
         SwooleG.main_reactor->setHandle(SwooleG.main_reactor, SW_FD_AIO, [] (swReactor *reactor, swEvent *_event)
         {
-            int i;
+            int i, n;
+            uint64_t flag;
             async_event *events[SW_AIO_EVENT_NUM];
-            ssize_t n = read(_event->fd, events, sizeof(async_event*) * SW_AIO_EVENT_NUM);
-            if (n < 0)
+            if (read(_event->fd, &flag, sizeof(flag)) < 0 && errno != EAGAIN)
             {
                 swWarn("read() failed. Error: %s[%d]", strerror(errno), errno);
                 return SW_ERR;
             }
-            for (i = 0; i < n / (int) sizeof(async_event*); i++)
+            pool->notified = false;
+            //the pool may be freed in the callbacks
+            while (pool && (n = pool->reap(events, SW_AIO_EVENT_NUM)) > 0)
             {
-                if (!events[i]->canceled)
+                for (i = 0; i < n; i++)
                 {
-                    events[i]->callback(events[i]);
+                    if (!events[i]->canceled)
+                    {
+                        events[i]->callback(events[i]);
+                    }
+                    SwooleAIO.task_num--;
+                    delete events[i];
+                }
+                if (pool)
+                {
+                    pool->flush_overflow();
                 }
-                SwooleAIO.task_num--;
-                delete events[i];
             }
             return SW_OK;
         });
@@ -164,6 +249,21 @@ public:
 
         threads.clear();
         exit_flags.clear();
+
+        async_event *event;
+        while ((event = queue.pop()))
+        {
+            delete event;
+        }
+        while ((event = completed_queue.pop()))
+        {
+            delete event;
+        }
+        while (!overflow.empty())
+        {
+            delete overflow.front();
+            overflow.pop();
+        }
         return true;
     }
 
@@ -172,12 +272,96 @@ public:
         auto _event_copy = new async_event(*request);
         schedule();
         _event_copy->task_id = current_task_id++;
-        queue.push(_event_copy);
-        _cv.notify_one();
+        if (!overflow.empty())
+        {
+            flush_overflow();
+        }
+        if (!overflow.empty() || !queue.push(_event_copy))
+        {
+            overflow.push(_event_copy);
+        }
+        notify_one();
         return _event_copy;
     }
 
+    /**
+     * move the events queued while the ring was full, called in the reactor thread only
+     */
+    void flush_overflow()
+    {
+        bool pushed = false;
+        while (!overflow.empty() && queue.push(overflow.front()))
+        {
+            overflow.pop();
+            pushed = true;
+        }
+        if (pushed)
+        {
+            notify_one();
+        }
+    }
+
+    int reap(async_event **events, int n)
+    {
+        int i;
+        for (i = 0; i < n; i++)
+        {
+            if (!(events[i] = completed_queue.pop()))
+            {
+                break;
+            }
+        }
+        return i;
+    }
+
+    atomic<bool> notified;
+
 private:
+    void notify_one()
+    {
+        atomic_thread_fence(memory_order_seq_cst);
+        if (n_waiting > 0)
+        {
+            unique_lock<mutex> lock(_mutex);
+            _cv.notify_one();
+        }
+    }
+
+    void complete(async_event *event)
+    {
+        while (!completed_queue.push(event))
+        {
+            swYield();
+        }
+        //one notification per batch, the reactor clears the flag before reaping
+        if (notified.exchange(true))
+        {
+            return;
+        }
+        uint64_t flag = 1;
+        while (true)
+        {
+            int ret = write(_pipe_write, &flag, sizeof(flag));
+            if (ret < 0)
+            {
+                if (errno == EAGAIN)
+                {
+                    swSocket_wait(_pipe_write, 1000, SW_EVENT_WRITE);
+                    continue;
+                }
+                else if (errno == EINTR)
+                {
+                    continue;
+                }
+                else
+                {
+                    swSysError("sendto swoole_aio_pipe_write failed.");
+                }
+            }
+            break;
+        }
+    }
+
     void create_thread(int i)
     {
         exit_flags[i] = make_shared<atomic<bool>>(false);
@@ -202,13 +386,11 @@ private:
                 {
                     event->error = SW_ERROR_AIO_BAD_REQUEST;
                     event->ret = -1;
-                    goto _error;
                 }
                 else if (unlikely(event->canceled))
                 {
                     event->error = SW_ERROR_AIO_BAD_REQUEST;
                     event->ret = -1;
-                    goto _error;
                 }
                 else
                 {
@@ -216,30 +398,8 @@ private:
                 }
 
                 swTrace("aio_thread ok. ret=%d, error=%d", event->ret, event->error);
+                complete(event);
 
-                _error: while (true)
-                {
-                    SwooleAIO.lock.lock(&SwooleAIO.lock);
-                    int ret = write(_pipe_write, &event, sizeof(event));
-                    SwooleAIO.lock.unlock(&SwooleAIO.lock);
-                    if (ret < 0)
-                    {
-                        if (errno == EAGAIN)
-                        {
-                            swSocket_wait(_pipe_write, 1000, SW_EVENT_WRITE);
-                            continue;
-                        }
-                        else if (errno == EINTR)
-                        {
-                            continue;
-                        }
-                        else
-                        {
-                            swSysError("sendto swoole_aio_pipe_write failed.");
-                        }
-                    }
-                    break;
-                }
                 //exit
                 if (_flag)
                 {
@@ -252,7 +412,11 @@ private:
                 if (running)
                 {
                     ++n_waiting;
-                    _cv.wait(lock);
+                    atomic_thread_fence(memory_order_seq_cst);
+                    if (queue.empty())
+                    {
+                        _cv.wait(lock);
+                    }
                     --n_waiting;
                 }
             }
@@ -272,7 +436,9 @@ private:
     unordered_map<int, unique_ptr<thread>> threads;
     unordered_map<int, shared_ptr<atomic<bool>>> exit_flags;
 
-    async_event_queue queue;
+    async_event_ring queue;
+    async_event_ring completed_queue;
+    std::queue<async_event*> overflow;
     bool running;
     atomic<int> n_waiting;
     int min_threads;
@@ -281,7 +447,6 @@ private:
     condition_variable _cv;
 };
 
-static async_thread_pool *pool = nullptr;
 
 static int swAio_init()
 {
@@ -20,11 +20,19 @@
 #include "server.h"
 
 #include <sys/stat.h>
+#include <sys/uio.h>
+#include <limits.h>
 
 #ifndef MSG_NOSIGNAL
 #define MSG_NOSIGNAL        0
 #endif
 
+#ifdef IOV_MAX
+#define SW_CONNECTION_IOV_MAX    IOV_MAX
+#else
+#define SW_CONNECTION_IOV_MAX    16
+#endif
+
 int swConnection_onSendfile(swConnection *conn, swBuffer_chunk *chunk)
 {
     int ret;
@@ -123,12 +131,92 @@ int swConnection_onSendfile(swConnection *conn, swBuffer_chunk *chunk)
 /**
  * send buffer to client
  */
+static sw_inline int swConnection_send_error(swConnection *conn)
+{
+    switch (swConnection_error(errno))
+    {
+    case SW_ERROR:
+        swWarn("send to fd[%d] failed. Error: %s[%d]", conn->fd, strerror(errno), errno);
+        break;
+    case SW_CLOSE:
+        conn->close_errno = errno;
+        conn->close_wait = 1;
+        return SW_ERR;
+    case SW_WAIT:
+        conn->send_wait = 1;
+        return SW_ERR;
+    default:
+        break;
+    }
+    return SW_OK;
+}
+
+/**
+ * send the consecutive data chunks at the head of the buffer with one writev, sendfile and close chunks stop it
+ */
+static int swConnection_buffer_writev(swConnection *conn)
+{
+    struct iovec iov[SW_CONNECTION_IOV_MAX];
+    swBuffer *buffer = conn->out_buffer;
+    swBuffer_chunk *chunk;
+    ssize_t ret;
+    int n = 0;
+
+    for (chunk = swBuffer_get_chunk(buffer); chunk && chunk->type == SW_CHUNK_DATA && n < SW_CONNECTION_IOV_MAX; chunk = chunk->next)
+    {
+        iov[n].iov_base = (char*) chunk->store.ptr + chunk->offset;
+        iov[n].iov_len = chunk->length - chunk->offset;
+        n++;
+    }
+
+    do
+    {
+        ret = writev(conn->fd, iov, n);
+    } while (ret < 0 && errno == EINTR);
+
+    if (ret < 0)
+    {
+        return swConnection_send_error(conn);
+    }
+#ifdef SW_DEBUG
+    conn->total_send_bytes += ret;
+#endif
+
+    //pop the chunks sent in full, the last one may be sent in part
+    while (n-- > 0)
+    {
+        chunk = swBuffer_get_chunk(buffer);
+        if (ret < chunk->length - chunk->offset)
+        {
+            chunk->offset += ret;
+            break;
+        }
+        ret -= chunk->length - chunk->offset;
+        swBuffer_pop_chunk(buffer, chunk);
+    }
+    return SW_OK;
+}
+
 int swConnection_buffer_send(swConnection *conn)
 {
     int ret, sendn;
 
     swBuffer *buffer = conn->out_buffer;
     swBuffer_chunk *chunk = swBuffer_get_chunk(buffer);
+
+    /**
+     * a response queued as several chunks goes out with a single syscall,
+     * not over SSL nor on the dgram sockets, a writev would merge the messages
+     */
+    if (chunk->next && chunk->next->type == SW_CHUNK_DATA && swSocket_is_stream(conn->socket_type)
+#ifdef SW_USE_OPENSSL
+            && conn->ssl == NULL
+#endif
+            )
+    {
+        return swConnection_buffer_writev(conn);
+    }
+
     sendn = chunk->length - chunk->offset;
 
     if (sendn == 0)
@@ -140,22 +228,7 @@ int swConnection_buffer_send(swConnection *conn)
     ret = swConnection_send(conn, (char*) chunk->store.ptr + chunk->offset, sendn, 0);
     if (ret < 0)
     {
-        switch (swConnection_error(errno))
-        {
-        case SW_ERROR:
-            swWarn("send to fd[%d] failed. Error: %s[%d]", conn->fd, strerror(errno), errno);
-            break;
-        case SW_CLOSE:
-            conn->close_errno = errno;
-            conn->close_wait = 1;
-            return SW_ERR;
-        case SW_WAIT:
-            conn->send_wait = 1;
-            return SW_ERR;
-        default:
-            break;
-        }
-        return SW_OK;
+        return swConnection_send_error(conn);
     }
     //chunk full send
     else if (ret == sendn || sendn == 0)
@@ -91,6 +91,7 @@ int swManager_start(swFactory *factory)
         swError("malloc[worker_pipes] failed. Error: %s [%d]", strerror(errno), errno);
         return SW_ERR;
     }
+    object->pipe_workers_size = 0;
 
     for (i = 0; i < serv->worker_num; i++)
     {
@@ -102,6 +103,21 @@ int swManager_start(swFactory *factory)
         serv->workers[i].pipe_worker = object->pipes[i].getFd(&object->pipes[i], SW_PIPE_WORKER);
         serv->workers[i].pipe_object = &object->pipes[i];
         swServer_store_pipe_fd(serv, serv->workers[i].pipe_object);
+        if (serv->workers[i].pipe_master >= object->pipe_workers_size)
+        {
+            object->pipe_workers_size = serv->workers[i].pipe_master + 1;
+        }
+    }
+
+    object->pipe_workers = sw_calloc(object->pipe_workers_size, sizeof(swWorker *));
+    if (object->pipe_workers == NULL)
+    {
+        swError("malloc[pipe_workers] failed. Error: %s [%d]", strerror(errno), errno);
+        return SW_ERR;
+    }
+    for (i = 0; i < serv->worker_num; i++)
+    {
+        object->pipe_workers[serv->workers[i].pipe_master] = &serv->workers[i];
     }
 
     if (serv->task_worker_num > 0)
@@ -92,9 +92,8 @@ int swPort_enable_ssl_encrypt(swListenPort *ls)
 }
 #endif
 
-int swPort_listen(swListenPort *ls)
+static int swPort_listen_socket(swListenPort *ls, int sock)
 {
-    int sock = ls->sock;
     int option = 1;
 
     //listen stream socket
@@ -139,6 +138,27 @@ int swPort_listen(swListenPort *ls)
     }
 #endif
 
+    return SW_OK;
+}
+
+int swPort_listen(swListenPort *ls)
+{
+    if (ls->reactor_socks)
+    {
+        int i;
+        for (i = 0; i < ls->reactor_sock_num; i++)
+        {
+            if (swPort_listen_socket(ls, ls->reactor_socks[i]) < 0)
+            {
+                return SW_ERR;
+            }
+        }
+    }
+    else if (swPort_listen_socket(ls, ls->sock) < 0)
+    {
+        return SW_ERR;
+    }
+
     ls->buffer_high_watermark = ls->socket_buffer_size * 0.8;
     ls->buffer_low_watermark = 0;
 
@@ -587,6 +607,16 @@ void swPort_free(swListenPort *port)
     }
 #endif
 
+    if (port->reactor_socks)
+    {
+        int i;
+        for (i = 1; i < port->reactor_sock_num; i++)
+        {
+            close(port->reactor_socks[i]);
+        }
+        sw_free(port->reactor_socks);
+        port->reactor_socks = NULL;
+    }
     close(port->sock);
 
     //remove unix socket file
@@ -596,6 +626,267 @@ void swPort_free(swListenPort *port)
     }
 }
 
+/**
+ * a static file served by the reactor, the headers that do not change between requests are prebuilt,
+ * the body is kept in memory for the small files
+ */
+typedef struct
+{
+    time_t mtime;
+    off_t size;
+    ino_t ino;
+    time_t check_time;
+    //the precompressed sibling does not exist, kept to save the lstat()
+    uint8_t missing;
+    swString *header;
+    swString *body;
+    char last_modified[64];
+    //set while the file is in the cache
+    char *key;
+    uint16_t key_len;
+    swLinkedList_node *lru_node;
+} swHttpStaticFile;
+
+/**
+ * each reactor owns its cache, so lookups take no lock,
+ * at most SW_HTTP_STATIC_CACHE_NUM files, the least recently used one is evicted first
+ */
+static __thread struct
+{
+    swHashMap *files;
+    swLinkedList *lru;
+    size_t memory_size;
+    time_t date_time;
+    char date[64];
+    swString *response;
+} sw_static_cache;
+
+/**
+ * precompressed siblings of a static file, in the order of preference
+ */
+static const struct
+{
+    uint8_t accept;
+    char *ext;
+    char *encoding;
+} sw_static_encodings[] =
+{
+    { SW_HTTP_ACCEPT_BR, ".br", "br" },
+    { SW_HTTP_ACCEPT_GZIP, ".gz", "gzip" },
+};
+
+static void swPort_http_static_file_free(void *data)
+{
+    swHttpStaticFile *file = (swHttpStaticFile *) data;
+    if (file->header)
+    {
+        swString_free(file->header);
+    }
+    if (file->body)
+    {
+        sw_static_cache.memory_size -= file->body->size;
+        swString_free(file->body);
+    }
+    if (file->lru_node)
+    {
+        swLinkedList_remove_node(sw_static_cache.lru, file->lru_node);
+        sw_free(file->key);
+    }
+    sw_free(file);
+}
+
+static int swPort_http_static_file_add(char *filename, uint16_t filename_len, swHttpStaticFile *file)
+{
+    if (sw_static_cache.lru->num >= SW_HTTP_STATIC_CACHE_NUM)
+    {
+        swHttpStaticFile *oldest = sw_static_cache.lru->head->data;
+        swHashMap_del(sw_static_cache.files, oldest->key, oldest->key_len);
+    }
+    file->key = sw_strndup(filename, filename_len);
+    if (file->key == NULL)
+    {
+        return SW_ERR;
+    }
+    if (swLinkedList_append(sw_static_cache.lru, file) < 0)
+    {
+        sw_free(file->key);
+        return SW_ERR;
+    }
+    if (swHashMap_add(sw_static_cache.files, filename, filename_len, file) < 0)
+    {
+        swLinkedList_pop(sw_static_cache.lru);
+        sw_free(file->key);
+        return SW_ERR;
+    }
+    file->key_len = filename_len;
+    file->lru_node = sw_static_cache.lru->tail;
+    return SW_OK;
+}
+
+static sw_inline time_t swPort_http_static_file_mtime(struct stat *file_stat)
+{
+#ifdef __MACH__
+    return file_stat->st_mtimespec.tv_sec;
+#elif defined(_WIN32)
+    return file_stat->st_mtime;
+#else
+    return file_stat->st_mtim.tv_sec;
+#endif
+}
+
+static swHttpStaticFile* swPort_http_static_file_new(char *filename, struct stat *file_stat, const char *content_type, const char *encoding)
+{
+    swHttpStaticFile *file = sw_malloc(sizeof(swHttpStaticFile));
+    if (file == NULL)
+    {
+        return NULL;
+    }
+    file->mtime = swPort_http_static_file_mtime(file_stat);
+    file->size = file_stat->st_size;
+    file->ino = file_stat->st_ino;
+    file->missing = 0;
+    file->body = NULL;
+    file->lru_node = NULL;
+
+    struct tm *tm2 = gmtime(&file->mtime);
+    strftime(file->last_modified, sizeof(file->last_modified), "%a, %d %b %Y %H:%M:%S %Z", tm2);
+
+    file->header = swString_new(256);
+    if (file->header == NULL)
+    {
+        sw_free(file);
+        return NULL;
+    }
+    file->header->length = sw_snprintf(file->header->str, file->header->size,
+            "Content-Length: %ld\r\n"
+            "Content-Type: %s\r\n"
+            "%s%s%s"
+            "Last-Modified: %s\r\n"
+            "Server: %s\r\n\r\n",
+            (long) file->size,
+            content_type ? content_type : swoole_get_mime_type(filename),
+            encoding ? "Content-Encoding: " : "",
+            encoding ? encoding : "",
+            encoding ? "\r\nVary: Accept-Encoding\r\n" : "",
+            file->last_modified,
+            SW_HTTP_SERVER_SOFTWARE);
+
+    if (file->size > SW_HTTP_STATIC_CACHE_FILE_SIZE
+            || sw_static_cache.memory_size + file->size > SW_HTTP_STATIC_CACHE_MEMORY_SIZE)
+    {
+        return file;
+    }
+    int fd = open(filename, O_RDONLY);
+    if (fd < 0)
+    {
+        return file;
+    }
+    swString *body = swString_new(file->size);
+    if (body)
+    {
+        //the file was changed while reading, leave it to sendfile
+        if (swoole_sync_readfile(fd, body->str, file->size) != file->size)
+        {
+            swString_free(body);
+        }
+        else
+        {
+            body->length = file->size;
+            file->body = body;
+            sw_static_cache.memory_size += body->size;
+        }
+    }
+    close(fd);
+    return file;
+}
+
+/**
+ * find the file in the cache, it is checked against the file system once SW_HTTP_STATIC_CACHE_REVALIDATE seconds
+ * and dropped when it changed, the precompressed siblings are looked up with their [encoding],
+ * their absence is cached as well
+ */
+static swHttpStaticFile* swPort_http_static_file_get(swServer *serv, char *filename, uint16_t filename_len,
+        const char *content_type, const char *encoding, int *cached)
+{
+    *cached = 0;
+    if (sw_static_cache.files == NULL)
+    {
+        sw_static_cache.lru = swLinkedList_new(0, NULL);
+        if (sw_static_cache.lru == NULL)
+        {
+            return NULL;
+        }
+        sw_static_cache.files = swHashMap_new(SW_HTTP_STATIC_CACHE_NUM, swPort_http_static_file_free);
+        if (sw_static_cache.files == NULL)
+        {
+            return NULL;
+        }
+    }
+
+    time_t now = serv->gs->now;
+    swHttpStaticFile *file = swHashMap_find(sw_static_cache.files, filename, filename_len);
+    if (file)
+    {
+        swLinkedList_move_to_tail(sw_static_cache.lru, file->lru_node);
+    }
+    if (file && now - file->check_time < SW_HTTP_STATIC_CACHE_REVALIDATE)
+    {
+        *cached = 1;
+        return file->missing ? NULL : file;
+    }
+
+    struct stat file_stat;
+    if (lstat(filename, &file_stat) < 0 || file_stat.st_size == 0 || (file_stat.st_mode & S_IFMT) != S_IFREG)
+    {
+        if (file && encoding && file->missing)
+        {
+            file->check_time = now;
+        }
+        else if (file)
+        {
+            swHashMap_del(sw_static_cache.files, filename, filename_len);
+            file = NULL;
+        }
+        if (file == NULL && encoding)
+        {
+            file = sw_calloc(1, sizeof(swHttpStaticFile));
+            if (file)
+            {
+                file->missing = 1;
+                file->check_time = now;
+                if (swPort_http_static_file_add(filename, filename_len, file) < 0)
+                {
+                    sw_free(file);
+                }
+            }
+        }
+        return NULL;
+    }
+    if (file && !file->missing && file->mtime == swPort_http_static_file_mtime(&file_stat)
+            && file->size == file_stat.st_size && file->ino == file_stat.st_ino)
+    {
+        file->check_time = now;
+        *cached = 1;
+        return file;
+    }
+    if (file)
+    {
+        swHashMap_del(sw_static_cache.files, filename, filename_len);
+    }
+
+    file = swPort_http_static_file_new(filename, &file_stat, content_type, encoding);
+    if (file == NULL)
+    {
+        return NULL;
+    }
+    file->check_time = now;
+    if (swPort_http_static_file_add(filename, filename_len, file) == SW_OK)
+    {
+        *cached = 1;
+    }
+    return file;
+}
+
 static int swPort_http_static_handler(swServer *serv, swHttpRequest *request, swConnection *conn)
 {
     char *url = request->buffer->str + request->url_offset;
@@ -617,21 +908,54 @@ static int swPort_http_static_handler(swServer *serv, swHttpRequest *request, sw
     p += n;
     *p = 0;
 
-    struct stat file_stat;
-    if (lstat(buffer.filename, &file_stat) < 0)
+    int cached;
+    uint16_t filename_len = p - buffer.filename;
+    swHttpStaticFile *file = swPort_http_static_file_get(serv, buffer.filename, filename_len, NULL, NULL, &cached);
+    if (file == NULL)
     {
         return SW_FALSE;
     }
-    if (file_stat.st_size == 0)
+
+    //serve [file].br or [file].gz instead when the client accepts it
+    if (serv->http_compression && request->accept_encoding && filename_len + 3 < sizeof(buffer.filename))
     {
-        return SW_FALSE;
+        const char *content_type = swoole_get_mime_type(buffer.filename);
+        int i;
+        for (i = 0; i < sizeof(sw_static_encodings) / sizeof(sw_static_encodings[0]); i++)
+        {
+            if (!(request->accept_encoding & sw_static_encodings[i].accept))
+            {
+                continue;
+            }
+            strcpy(buffer.filename + filename_len, sw_static_encodings[i].ext);
+            int encoded_cached;
+            swHttpStaticFile *encoded_file = swPort_http_static_file_get(serv, buffer.filename, filename_len + 3,
+                    content_type, sw_static_encodings[i].encoding, &encoded_cached);
+            if (encoded_file)
+            {
+                if (!cached)
+                {
+                    swPort_http_static_file_free(file);
+                }
+                file = encoded_file;
+                cached = encoded_cached;
+                break;
+            }
+            buffer.filename[filename_len] = 0;
+        }
     }
-    if ((file_stat.st_mode & S_IFMT) != S_IFREG)
+
+    if (sw_static_cache.response == NULL)
     {
-        return SW_FALSE;
+        sw_static_cache.response = swString_new(SW_BUFFER_SIZE_STD);
+        if (sw_static_cache.response == NULL)
+        {
+            goto _error;
+        }
     }
+    swString *response_buffer = sw_static_cache.response;
+    swString_clear(response_buffer);
 
-    char header_buffer[1024];
     swSendData response;
     response.info.fd = conn->session_id;
 
@@ -674,28 +998,20 @@ static int swPort_http_static_handler(swServer *serv, swHttpRequest *request, sw
         }
     }
 
-    char date_[64];
-    struct tm *tm1;
-
-    check_modify_date: tm1 = gmtime(&serv->gs->now);
-    strftime(date_, sizeof(date_), "%a, %d %b %Y %H:%M:%S %Z", tm1);
-
-    char date_last_modified[64];
-#ifdef __MACH__
-    time_t file_mtime = file_stat.st_mtimespec.tv_sec;
-#elif defined(_WIN32)
-	time_t file_mtime = file_stat.st_mtime;
-#else
-    time_t file_mtime = file_stat.st_mtim.tv_sec;
-#endif
-
-    struct tm *tm2 = gmtime(&file_mtime);
-    strftime(date_last_modified, sizeof(date_last_modified), "%a, %d %b %Y %H:%M:%S %Z", tm2);
+    check_modify_date:
+    if (sw_static_cache.date_time != serv->gs->now)
+    {
+        struct tm *tm1 = gmtime(&serv->gs->now);
+        strftime(sw_static_cache.date, sizeof(sw_static_cache.date), "%a, %d %b %Y %H:%M:%S %Z", tm1);
+        sw_static_cache.date_time = serv->gs->now;
+    }
 
     if (state == 2)
     {
         struct tm tm3;
         char date_tmp[64];
+        //strptime() leaves tm_isdst alone, mktime() must not see garbage in it
+        bzero(&tm3, sizeof(tm3));
         memcpy(date_tmp, date_if_modified_since, length_if_modified_since);
         date_tmp[length_if_modified_since] = 0;
 
@@ -717,41 +1033,52 @@ static int swPort_http_static_handler(swServer *serv, swHttpRequest *request, sw
         {
             date_format = SW_HTTP_ASCTIME_DATE;
         }
-        if (date_format && mktime(&tm3) - (int) timezone >= file_mtime)
+        if (date_format && mktime(&tm3) - (int) timezone >= file->mtime)
         {
-            response.length = response.info.len = sw_snprintf(header_buffer, sizeof(header_buffer),
+            response_buffer->length = sw_snprintf(response_buffer->str, response_buffer->size,
                     "HTTP/1.1 304 Not Modified\r\n"
                     "%s"
                     "Date: %s\r\n"
                     "Last-Modified: %s\r\n"
                     "Server: %s\r\n\r\n",
                     request->keep_alive ? "Connection: keep-alive\r\n" : "",
-                    date_,
-                    date_last_modified,
+                    sw_static_cache.date,
+                    file->last_modified,
                     SW_HTTP_SERVER_SOFTWARE
             );
-            response.data = header_buffer;
+            response.data = response_buffer->str;
+            response.length = response.info.len = response_buffer->length;
             swServer_master_send(serv, &response);
             goto _finish;
         }
     }
 
-    response.length = response.info.len = sw_snprintf(header_buffer, sizeof(header_buffer),
+    response_buffer->length = sw_snprintf(response_buffer->str, response_buffer->size,
             "HTTP/1.1 200 OK\r\n"
             "%s"
-            "Content-Length: %ld\r\n"
-            "Content-Type: %s\r\n"
-            "Date: %s\r\n"
-            "Last-Modified: %s\r\n"
-            "Server: %s\r\n\r\n",
+            "Date: %s\r\n",
             request->keep_alive ? "Connection: keep-alive\r\n" : "",
-            (long) file_stat.st_size,
-            swoole_get_mime_type(buffer.filename),
-            date_,
-            date_last_modified,
-            SW_HTTP_SERVER_SOFTWARE);
+            sw_static_cache.date);
+    if (swString_append(response_buffer, file->header) < 0)
+    {
+        goto _error;
+    }
 
-    response.data = header_buffer;
+    //the whole response goes out with one write
+    if (file->body)
+    {
+        if (swString_append(response_buffer, file->body) < 0)
+        {
+            goto _error;
+        }
+        response.data = response_buffer->str;
+        response.length = response.info.len = response_buffer->length;
+        swServer_master_send(serv, &response);
+        goto _finish;
+    }
+
+    response.data = response_buffer->str;
+    response.length = response.info.len = response_buffer->length;
 
 #ifdef HAVE_TCP_NOPUSH
     if (conn->tcp_nopush == 0)
@@ -766,7 +1093,7 @@ static int swPort_http_static_handler(swServer *serv, swHttpRequest *request, sw
     swServer_master_send(serv, &response);
 
     buffer.offset = 0;
-    buffer.length = file_stat.st_size;
+    buffer.length = file->size;
 
     response.info.type = SW_EVENT_SENDFILE;
     response.length = response.info.len = sizeof(swSendFile_request) + buffer.length + 1;
@@ -782,6 +1109,16 @@ static int swPort_http_static_handler(swServer *serv, swHttpRequest *request, sw
         response.data = NULL;
         swServer_master_send(serv, &response);
     }
-
+    if (!cached)
+    {
+        swPort_http_static_file_free(file);
+    }
     return SW_TRUE;
+
+    _error:
+    if (!cached)
+    {
+        swPort_http_static_file_free(file);
+    }
+    return SW_FALSE;
 }
@@ -28,6 +28,7 @@ static int swProcessPool_worker_loop(swProcessPool *pool, swWorker *worker);
 static int swProcessPool_worker_loop_ex(swProcessPool *pool, swWorker *worker);
 
 static void swProcessPool_free(swProcessPool *pool);
+static int swProcessPool_worker_recv(swProcessPool *pool, swWorker *worker, swEventData *buf);
 
 
 static void swProcessPool_killTimeout(swTimer *timer, swTimer_node *tnode)
@@ -514,6 +515,14 @@ static int swProcessPool_worker_loop(swProcessPool *pool, swWorker *worker)
             }
             pool->stream->last_connection = fd;
         }
+        else if (pool->work_stealing)
+        {
+            n = swProcessPool_worker_recv(pool, worker, &out.buf);
+            if (n < 0 && errno != EINTR)
+            {
+                swSysError("[Worker#%d] recv(%d) failed.", worker->id, worker->pipe_worker);
+            }
+        }
         else
         {
             n = read(worker->pipe_worker, &out.buf, sizeof(out.buf));
@@ -521,6 +530,10 @@ static int swProcessPool_worker_loop(swProcessPool *pool, swWorker *worker)
             {
                 swSysError("[Worker#%d] read(%d) failed.", worker->id, worker->pipe_worker);
             }
+            else if (n > 0 && pool->type == SW_PROCESS_TASKWORKER && out.buf.info.type != SW_EVENT_PIPE_MESSAGE)
+            {
+                sw_atomic_fetch_sub(&worker->tasking_num, 1);
+            }
         }
 
         /**
@@ -570,6 +583,100 @@ static int swProcessPool_worker_loop(swProcessPool *pool, swWorker *worker)
     return SW_OK;
 }
 
+/**
+ * take a task from the pipe of the busiest worker, the tasks sent to the given worker stay in its pipe
+ */
+static int swProcessPool_steal(swProcessPool *pool, swWorker *worker, swEventData *buf)
+{
+    swWorker *victim = NULL;
+    int i, n;
+
+    for (i = 0; i < pool->worker_num; i++)
+    {
+        swWorker *w = &pool->workers[i];
+        if (w == worker || w->status != SW_WORKER_BUSY || (int) w->tasking_num <= 0)
+        {
+            continue;
+        }
+        if (victim == NULL || w->tasking_num > victim->tasking_num)
+        {
+            victim = w;
+        }
+    }
+    if (victim == NULL)
+    {
+        return SW_ERR;
+    }
+    /**
+     * the owner or another worker is reading the pipe, come back later
+     */
+    if (!sw_atomic_cmp_set(&victim->steal_lock, 0, 1))
+    {
+        return SW_ERR;
+    }
+    /**
+     * look at the head of the queue first, nobody else can read it before the recv
+     */
+    n = recv(victim->pipe_worker, buf, sizeof(buf->info), MSG_PEEK | MSG_DONTWAIT);
+    if (n < (int) sizeof(buf->info) || buf->info.type == SW_EVENT_PIPE_MESSAGE || (swTask_type(buf) & SW_TASK_NOSTEAL))
+    {
+        sw_spinlock_release(&victim->steal_lock);
+        return SW_ERR;
+    }
+    n = recv(victim->pipe_worker, buf, sizeof(*buf), MSG_DONTWAIT);
+    sw_spinlock_release(&victim->steal_lock);
+    if (n <= 0)
+    {
+        return SW_ERR;
+    }
+    sw_atomic_fetch_sub(&victim->tasking_num, 1);
+    sw_atomic_fetch_add(&pool->steal_count, 1);
+    return n;
+}
+
+/**
+ * wait for a task on its own pipe, look for the tasks of the busy workers while idle
+ */
+static int swProcessPool_worker_recv(swProcessPool *pool, swWorker *worker, swEventData *buf)
+{
+    struct pollfd event;
+    int n;
+
+    event.fd = worker->pipe_worker;
+    event.events = POLLIN;
+
+    while (SwooleG.running > 0)
+    {
+        n = poll(&event, 1, SW_TASK_STEAL_INTERVAL);
+        if (n < 0)
+        {
+            return SW_ERR;
+        }
+        else if (n > 0)
+        {
+            sw_spinlock(&worker->steal_lock);
+            n = recv(worker->pipe_worker, buf, sizeof(*buf), MSG_DONTWAIT);
+            sw_spinlock_release(&worker->steal_lock);
+            if (n < 0 && errno == EAGAIN)
+            {
+                continue;
+            }
+            if (n > 0 && buf->info.type != SW_EVENT_PIPE_MESSAGE)
+            {
+                sw_atomic_fetch_sub(&worker->tasking_num, 1);
+            }
+            return n;
+        }
+        n = swProcessPool_steal(pool, worker, buf);
+        if (n > 0)
+        {
+            return n;
+        }
+    }
+    errno = EINTR;
+    return SW_ERR;
+}
+
 int swProcessPool_set_protocol(swProcessPool *pool, int task_protocol, uint32_t max_packet_size)
 {
     if (task_protocol)
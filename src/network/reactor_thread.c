@@ -28,10 +28,140 @@ static int swReactorThread_onWrite(swReactor *reactor, swEvent *ev);
 static int swReactorThread_onPackage(swReactor *reactor, swEvent *event);
 static int swReactorThread_onClose(swReactor *reactor, swEvent *event);
 static void swReactorThread_onStreamResponse(swStream *stream, char *data, uint32_t length);
+static int swReactorThread_dispatch_shm(swServer *serv, swDispatchData *task, char *data, uint32_t length);
+
+static void swReactorThread_check_idle(swReactor *reactor);
+static void swReactorThread_check_paused(swReactor *reactor);
+static void swReactorThread_onTimeout(swReactor *reactor);
 
 static void swHeartbeatThread_start(swServer *serv);
 static void swHeartbeatThread_loop(swThreadParam *param);
 
+static sw_inline void swReactorThread_idle_link(swServer *serv, swReactorThread *thread, swConnection *conn, time_t tick)
+{
+    uint32_t slot = tick % thread->idle_slot_num;
+    int head = thread->idle_slots[slot];
+
+    conn->idle_slot = slot + 1;
+    conn->idle_prev = 0;
+    conn->idle_next = head;
+    if (head)
+    {
+        serv->connection_list[head].idle_prev = conn->fd;
+    }
+    thread->idle_slots[slot] = conn->fd;
+}
+
+static sw_inline void swReactorThread_idle_unlink(swServer *serv, swReactorThread *thread, swConnection *conn)
+{
+    if (conn->idle_slot == 0)
+    {
+        return;
+    }
+    if (conn->idle_prev)
+    {
+        serv->connection_list[conn->idle_prev].idle_next = conn->idle_next;
+    }
+    else
+    {
+        thread->idle_slots[conn->idle_slot - 1] = conn->idle_next;
+    }
+    if (conn->idle_next)
+    {
+        serv->connection_list[conn->idle_next].idle_prev = conn->idle_prev;
+    }
+    conn->idle_slot = 0;
+}
+
+static sw_inline int swReactorThread_pipe_overloaded(swServer *serv, swWorker *worker)
+{
+    return (serv->pipe_backlog_size > 0 && worker->pipe_backlog_size >= serv->pipe_backlog_size)
+            || (serv->pipe_backlog_num > 0 && worker->pipe_backlog_num >= serv->pipe_backlog_num);
+}
+
+/**
+ * resume below the half of the budget, a worker on the edge would pause and resume the connections all the time
+ */
+static sw_inline int swReactorThread_pipe_drained(swServer *serv, swWorker *worker)
+{
+    return (serv->pipe_backlog_size == 0 || worker->pipe_backlog_size <= serv->pipe_backlog_size / 2)
+            && (serv->pipe_backlog_num == 0 || worker->pipe_backlog_num <= serv->pipe_backlog_num / 2);
+}
+
+static sw_inline swWorker* swReactorThread_get_pipe_worker(swServer *serv, int pipe_fd)
+{
+    swFactoryProcess *object = serv->factory.object;
+    if (pipe_fd >= object->pipe_workers_size)
+    {
+        return NULL;
+    }
+    return object->pipe_workers[pipe_fd];
+}
+
+/**
+ * the package of a discarded SW_EVENT_PACKAGE message is never read by the worker, give it back to the ring,
+ * the ring is collected in order so a block left behind would stall it
+ */
+static sw_inline void swReactorThread_free_dispatch_shm(swWorker *worker, swEventData *send_data)
+{
+    swString package;
+    memcpy(&package, send_data->data, sizeof(package));
+    sw_spinlock(&worker->dispatch_lock);
+    worker->dispatch_shm->free(worker->dispatch_shm, package.str);
+    worker->dispatch_shm_num--;
+    sw_spinlock_release(&worker->dispatch_lock);
+}
+
+static sw_inline void swReactorThread_pop_pipe_chunk(swWorker *worker, swBuffer *buffer, swBuffer_chunk *chunk)
+{
+    if (worker)
+    {
+        sw_atomic_fetch_sub(&worker->pipe_backlog_size, chunk->length);
+        sw_atomic_fetch_sub(&worker->pipe_backlog_num, 1);
+    }
+    swBuffer_pop_chunk(buffer, chunk);
+}
+
+/**
+ * stop reading from the connection, the data already received is still dispatched
+ */
+static void swReactorThread_pause(swServer *serv, swConnection *conn, uint16_t worker_id)
+{
+    swReactorThread *thread = swServer_get_thread(serv, conn->from_id);
+    swReactor *reactor = &thread->reactor;
+
+    if (conn->backpressure || conn->removed || conn->closed)
+    {
+        return;
+    }
+    if (thread->paused_num == thread->paused_size)
+    {
+        uint32_t size = thread->paused_size == 0 ? 64 : thread->paused_size * 2;
+        swPausedConnection *list = sw_realloc(thread->paused_list, sizeof(swPausedConnection) * size);
+        if (list == NULL)
+        {
+            swWarn("realloc(%ld) failed.", sizeof(swPausedConnection) * size);
+            return;
+        }
+        thread->paused_list = list;
+        thread->paused_size = size;
+    }
+    if (conn->events & SW_EVENT_WRITE)
+    {
+        reactor->set(reactor, conn->fd, conn->fdtype | SW_EVENT_WRITE);
+    }
+    else
+    {
+        reactor->del(reactor, conn->fd);
+    }
+    conn->backpressure = 1;
+
+    swPausedConnection *paused = &thread->paused_list[thread->paused_num++];
+    paused->fd = conn->fd;
+    paused->session_id = conn->session_id;
+    paused->worker_id = worker_id;
+}
+
 #ifdef SW_USE_OPENSSL
 static sw_inline int swReactorThread_verify_ssl_state(swReactor *reactor, swListenPort *port, swConnection *conn)
 {
@@ -112,6 +242,119 @@ static void swReactorThread_onStreamResponse(swStream *stream, char *data, uint3
     swServer_master_send(SwooleG.serv, &response);
 }
 
+#ifdef HAVE_RECVMMSG
+/**
+ * the datagrams of one recvmmsg() call, the buffer is allocated by the first udp event of the thread
+ */
+static __thread struct
+{
+    char *buffer;
+    struct mmsghdr msgs[SW_UDP_RECV_BATCH];
+    struct iovec iov[SW_UDP_RECV_BATCH];
+    swSocketAddress addrs[SW_UDP_RECV_BATCH];
+} sw_udp_batch;
+#endif
+
+/**
+ * dispatch one datagram to the worker, the packets larger than the ipc buffer are sent in pieces
+ */
+static int swReactorThread_dispatch_packet(swFactory *factory, int socket_type, swDispatchData *task, swSocketAddress *info, char *packet, int length)
+{
+    swDgramPacket pkt;
+    pkt.length = length;
+
+    //IPv4
+    if (socket_type == SW_SOCK_UDP)
+    {
+        pkt.port = ntohs(info->addr.inet_v4.sin_port);
+        pkt.addr.v4.s_addr = info->addr.inet_v4.sin_addr.s_addr;
+        task->data.info.fd = pkt.addr.v4.s_addr;
+    }
+    //IPv6
+    else if (socket_type == SW_SOCK_UDP6)
+    {
+        pkt.port = ntohs(info->addr.inet_v6.sin6_port);
+        memcpy(&pkt.addr.v6, &info->addr.inet_v6.sin6_addr, sizeof(info->addr.inet_v6.sin6_addr));
+        memcpy(&task->data.info.fd, &info->addr.inet_v6.sin6_addr, sizeof(task->data.info.fd));
+    }
+#ifndef _WIN32
+    //Unix Dgram
+    else
+    {
+        pkt.addr.un.path_length = strlen(info->addr.un.sun_path) + 1;
+        pkt.length += pkt.addr.un.path_length;
+        pkt.port = 0;
+        memcpy(&task->data.info.fd, info->addr.un.sun_path + pkt.addr.un.path_length - 6, sizeof(task->data.info.fd));
+    }
+#endif
+
+    task->target_worker_id = -1;
+    uint32_t header_size = sizeof(pkt);
+
+    //dgram header
+    memcpy(task->data.data, &pkt, sizeof(pkt));
+#ifndef _WIN32
+    //unix dgram
+    if (socket_type == SW_SOCK_UNIX_DGRAM)
+    {
+        header_size += pkt.addr.un.path_length;
+        memcpy(task->data.data + sizeof(pkt), info->addr.un.sun_path, pkt.addr.un.path_length);
+    }
+#endif
+    //dgram body
+    if (pkt.length > SW_IPC_BUFFER_SIZE - sizeof(pkt))
+    {
+        task->data.info.len = SW_IPC_BUFFER_SIZE;
+    }
+    else
+    {
+        task->data.info.len = pkt.length + sizeof(pkt);
+    }
+    //dispatch packet header
+    memcpy(task->data.data + header_size, packet, task->data.info.len - header_size);
+
+    uint32_t send_n = pkt.length + header_size;
+    if (socket_type == SW_SOCK_UNIX_DGRAM)
+    {
+        send_n -= pkt.addr.un.path_length;
+    }
+    uint32_t offset = 0;
+
+    /**
+     * lock target
+     */
+    SwooleTG.factory_lock_target = 1;
+
+    if (factory->dispatch(factory, task) < 0)
+    {
+        return SW_ERR;
+    }
+
+    send_n -= task->data.info.len;
+    if (send_n > 0)
+    {
+        offset = SW_IPC_BUFFER_SIZE - header_size;
+        while (send_n > 0)
+        {
+            task->data.info.len = send_n > SW_IPC_BUFFER_SIZE ? SW_IPC_BUFFER_SIZE : send_n;
+            memcpy(task->data.data, packet + offset, task->data.info.len);
+            send_n -= task->data.info.len;
+            offset += task->data.info.len;
+
+            if (factory->dispatch(factory, task) < 0)
+            {
+                break;
+            }
+        }
+    }
+    /**
+     * unlock
+     */
+    SwooleTG.factory_target_worker = -1;
+    SwooleTG.factory_lock_target = 0;
+    return SW_OK;
+}
+
 /**
  * for udp
  */
@@ -123,11 +366,8 @@ static int swReactorThread_onPackage(swReactor *reactor, swEvent *event)
     swServer *serv = SwooleG.serv;
     swConnection *server_sock = &serv->connection_list[fd];
     swDispatchData task;
-    swSocketAddress info;
-    swDgramPacket pkt;
     swFactory *factory = &serv->factory;
 
-    info.len = sizeof(info.addr);
     bzero(&task.data.info, sizeof(task.data.info));
     task.data.info.from_fd = fd;
     task.data.info.from_id = SwooleTG.id;
@@ -150,124 +390,92 @@ static int swReactorThread_onPackage(swReactor *reactor, swEvent *event)
         break;
     }
 
-    char packet[SW_BUFFER_SIZE_UDP];
-    do_recvfrom:
-    ret = recvfrom(fd, packet, SW_BUFFER_SIZE_UDP, 0, (struct sockaddr *) &info.addr, &info.len);
-
-    if (ret > 0)
+#ifdef HAVE_RECVMMSG
+    if (sw_udp_batch.buffer == NULL)
     {
-        pkt.length = ret;
-
-        //IPv4
-        if (socket_type == SW_SOCK_UDP)
+        sw_udp_batch.buffer = sw_malloc(SW_UDP_RECV_BATCH * SW_BUFFER_SIZE_UDP);
+        if (sw_udp_batch.buffer == NULL)
         {
-            pkt.port = ntohs(info.addr.inet_v4.sin_port);
-            pkt.addr.v4.s_addr = info.addr.inet_v4.sin_addr.s_addr;
-            task.data.info.fd = pkt.addr.v4.s_addr;
-        }
-        //IPv6
-        else if (socket_type == SW_SOCK_UDP6)
-        {
-            pkt.port = ntohs(info.addr.inet_v6.sin6_port);
-            memcpy(&pkt.addr.v6, &info.addr.inet_v6.sin6_addr, sizeof(info.addr.inet_v6.sin6_addr));
-            memcpy(&task.data.info.fd, &info.addr.inet_v6.sin6_addr, sizeof(task.data.info.fd));
-        }
-#ifndef _WIN32
-        //Unix Dgram
-        else
-        {
-            pkt.addr.un.path_length = strlen(info.addr.un.sun_path) + 1;
-            pkt.length += pkt.addr.un.path_length;
-            pkt.port = 0;
-            memcpy(&task.data.info.fd, info.addr.un.sun_path + pkt.addr.un.path_length - 6, sizeof(task.data.info.fd));
+            swSysError("malloc(%d) failed.", SW_UDP_RECV_BATCH * SW_BUFFER_SIZE_UDP);
+            return SW_ERR;
         }
-#endif
-
-        task.target_worker_id = -1;
-        uint32_t header_size = sizeof(pkt);
+    }
 
-        //dgram header
-        memcpy(task.data.data, &pkt, sizeof(pkt));
-#ifndef _WIN32
-        //unix dgram
-        if (socket_type == SW_SOCK_UNIX_DGRAM)
-        {
-            header_size += pkt.addr.un.path_length;
-            memcpy(task.data.data + sizeof(pkt), info.addr.un.sun_path, pkt.addr.un.path_length);
-        }
-#endif
-        //dgram body
-        if (pkt.length > SW_IPC_BUFFER_SIZE - sizeof(pkt))
-        {
-            task.data.info.len = SW_IPC_BUFFER_SIZE;
-        }
-        else
+    int i;
+    while (1)
+    {
+        for (i = 0; i < SW_UDP_RECV_BATCH; i++)
         {
-            task.data.info.len = pkt.length + sizeof(pkt);
+            sw_udp_batch.iov[i].iov_base = sw_udp_batch.buffer + i * SW_BUFFER_SIZE_UDP;
+            sw_udp_batch.iov[i].iov_len = SW_BUFFER_SIZE_UDP;
+            bzero(&sw_udp_batch.msgs[i].msg_hdr, sizeof(sw_udp_batch.msgs[i].msg_hdr));
+            sw_udp_batch.msgs[i].msg_hdr.msg_name = &sw_udp_batch.addrs[i].addr;
+            sw_udp_batch.msgs[i].msg_hdr.msg_namelen = sizeof(sw_udp_batch.addrs[i].addr);
+            sw_udp_batch.msgs[i].msg_hdr.msg_iov = &sw_udp_batch.iov[i];
+            sw_udp_batch.msgs[i].msg_hdr.msg_iovlen = 1;
+            //unnamed unix dgram sockets leave the path untouched
+            sw_udp_batch.addrs[i].addr.un.sun_path[0] = 0;
         }
-        //dispatch packet header
-        memcpy(task.data.data + header_size, packet, task.data.info.len - header_size);
 
-        uint32_t send_n = pkt.length + header_size;
-        if (socket_type == SW_SOCK_UNIX_DGRAM)
+        ret = recvmmsg(fd, sw_udp_batch.msgs, SW_UDP_RECV_BATCH, 0, NULL);
+        if (ret < 0)
         {
-            send_n -= pkt.addr.un.path_length;
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            else if (errno == EAGAIN)
+            {
+                return SW_OK;
+            }
+            swSysError("recvmmsg(%d) failed.", fd);
+            return ret;
         }
-        uint32_t offset = 0;
-
-        /**
-         * lock target
-         */
-        SwooleTG.factory_lock_target = 1;
 
-        if (factory->dispatch(factory, &task) < 0)
+        for (i = 0; i < ret; i++)
         {
-            return SW_ERR;
+            if (sw_udp_batch.msgs[i].msg_len == 0)
+            {
+                continue;
+            }
+            sw_udp_batch.addrs[i].len = sw_udp_batch.msgs[i].msg_hdr.msg_namelen;
+            if (swReactorThread_dispatch_packet(factory, socket_type, &task, &sw_udp_batch.addrs[i],
+                    sw_udp_batch.iov[i].iov_base, sw_udp_batch.msgs[i].msg_len) < 0)
+            {
+                return SW_ERR;
+            }
         }
-
-        send_n -= task.data.info.len;
-        if (send_n == 0)
+        //a short batch means the socket queue is drained, skip the recvmmsg() that would return EAGAIN
+        if (ret < SW_UDP_RECV_BATCH)
         {
-            /**
-             * unlock
-             */
-            SwooleTG.factory_target_worker = -1;
-            SwooleTG.factory_lock_target = 0;
-            goto do_recvfrom;
+            return SW_OK;
         }
-
-        offset = SW_IPC_BUFFER_SIZE - header_size;
-        while (send_n > 0)
+    }
+#else
+    swSocketAddress info;
+    char packet[SW_BUFFER_SIZE_UDP];
+    while (1)
+    {
+        info.len = sizeof(info.addr);
+        ret = recvfrom(fd, packet, SW_BUFFER_SIZE_UDP, 0, (struct sockaddr *) &info.addr, &info.len);
+        if (ret > 0)
         {
-            task.data.info.len = send_n > SW_IPC_BUFFER_SIZE ? SW_IPC_BUFFER_SIZE : send_n;
-            memcpy(task.data.data, packet + offset, task.data.info.len);
-            send_n -= task.data.info.len;
-            offset += task.data.info.len;
-
-            if (factory->dispatch(factory, &task) < 0)
+            if (swReactorThread_dispatch_packet(factory, socket_type, &task, &info, packet, ret) < 0)
             {
-                break;
+                return SW_ERR;
             }
         }
-        /**
-         * unlock
-         */
-        SwooleTG.factory_target_worker = -1;
-        SwooleTG.factory_lock_target = 0;
-        goto do_recvfrom;
-    }
-    else
-    {
-        if (errno == EAGAIN)
+        else if (errno == EAGAIN)
         {
             return SW_OK;
         }
         else
         {
             swSysError("recvfrom(%d) failed.", fd);
+            return ret;
         }
     }
-    return ret;
+#endif
 }
 
 /**
@@ -285,8 +493,8 @@ int swReactorThread_close(swReactor *reactor, int fd)
 
     if (serv->factory_mode == SW_MODE_PROCESS)
     {
-        assert(fd % serv->reactor_num == reactor->id);
-        assert(fd % serv->reactor_num == SwooleTG.id);
+        assert(conn->from_id == reactor->id);
+        assert(conn->from_id == SwooleTG.id);
     }
 
     if (conn->removed == 0 && reactor->del(reactor, fd) < 0)
@@ -296,6 +504,15 @@ int swReactorThread_close(swReactor *reactor, int fd)
 
     sw_atomic_fetch_add(&serv->stats->close_count, 1);
     sw_atomic_fetch_sub(&serv->stats->connection_num, 1);
+    if (serv->factory_mode == SW_MODE_PROCESS)
+    {
+        swReactorThread *thread = swServer_get_thread(serv, conn->from_id);
+        sw_atomic_fetch_sub(&thread->connection_num, 1);
+        if (thread->idle_slots)
+        {
+            swReactorThread_idle_unlink(serv, thread, conn);
+        }
+    }
 
     swTrace("Close Event.fd=%d|from=%d", fd, reactor->id);
 
@@ -368,8 +585,8 @@ static int swReactorThread_onClose(swReactor *reactor, swEvent *event)
     swDataHead notify_ev;
     bzero(&notify_ev, sizeof(notify_ev));
 
-    assert(fd % serv->reactor_num == reactor->id);
-    assert(fd % serv->reactor_num == SwooleTG.id);
+    assert(serv->connection_list[fd].from_id == reactor->id);
+    assert(serv->connection_list[fd].from_id == SwooleTG.id);
 
     notify_ev.from_id = reactor->id;
     notify_ev.fd = fd;
@@ -536,11 +753,26 @@ int swReactorThread_send2worker(swServer *serv, void *data, int len, uint16_t ta
             }
             else
             {
+                sw_atomic_fetch_add(&worker->pipe_backlog_size, len);
+                sw_atomic_fetch_add(&worker->pipe_backlog_num, 1);
                 ret = SW_OK;
             }
         }
         //release thread lock
         lock->unlock(lock);
+
+        /**
+         * the worker is over its budget, stop reading from the connection until it drains
+         */
+        swEventData *event = data;
+        if (swEventData_is_stream(event->info.type) && swReactorThread_pipe_overloaded(serv, worker))
+        {
+            swConnection *conn = swServer_connection_verify(serv, event->info.fd);
+            if (conn && conn->from_id == SwooleTG.id)
+            {
+                swReactorThread_pause(serv, conn, target_worker_id);
+            }
+        }
     }
     //master/udp thread
     else
@@ -565,6 +797,7 @@ static int swReactorThread_onPipeWrite(swReactor *reactor, swEvent *ev)
     swServer *serv = reactor->ptr;
     swBuffer *buffer = serv->connection_list[ev->fd].in_buffer;
     swLock *lock = serv->connection_list[ev->fd].object;
+    swWorker *worker = swReactorThread_get_pipe_worker(serv, ev->fd);
 
     //lock thread
     lock->lock(lock);
@@ -584,7 +817,16 @@ static int swReactorThread_onPipeWrite(swReactor *reactor, swEvent *ev)
                 if (conn->closed)
                 {
                     swoole_error_log(SW_LOG_NOTICE, SW_ERROR_SESSION_CLOSED_BY_SERVER, "Session#%d is closed by server.", send_data->info.fd);
-                    _discard: swBuffer_pop_chunk(buffer, chunk);
+                    _discard:
+                    if (worker && swEventData_is_request(send_data->info.type))
+                    {
+                        sw_atomic_fetch_sub(&worker->inflight_num, 1);
+                    }
+                    if (worker && send_data->info.type == SW_EVENT_PACKAGE)
+                    {
+                        swReactorThread_free_dispatch_shm(worker, send_data);
+                    }
+                    swReactorThread_pop_pipe_chunk(worker, buffer, chunk);
                     continue;
                 }
             }
@@ -605,7 +847,7 @@ static int swReactorThread_onPipeWrite(swReactor *reactor, swEvent *ev)
         }
         else
         {
-            swBuffer_pop_chunk(buffer, chunk);
+            swReactorThread_pop_pipe_chunk(worker, buffer, chunk);
         }
     }
 
@@ -689,8 +931,8 @@ static int swReactorThread_onWrite(swReactor *reactor, swEvent *ev)
 
     if (serv->factory_mode == SW_MODE_PROCESS)
     {
-        assert(fd % serv->reactor_num == reactor->id);
-        assert(fd % serv->reactor_num == SwooleTG.id);
+        assert(serv->connection_list[fd].from_id == reactor->id);
+        assert(serv->connection_list[fd].from_id == SwooleTG.id);
     }
 
     swConnection *conn = swServer_connection_get(serv, fd);
@@ -705,6 +947,14 @@ static int swReactorThread_onWrite(swReactor *reactor, swEvent *ev)
     if (conn->connect_notify)
     {
         conn->connect_notify = 0;
+        if (serv->factory_mode == SW_MODE_PROCESS)
+        {
+            swReactorThread *thread = swServer_get_thread(serv, reactor->id);
+            if (thread->idle_slots)
+            {
+                swReactorThread_idle_link(serv, thread, conn, (conn->last_time + serv->heartbeat_idle_time) / serv->heartbeat_check_interval);
+            }
+        }
 #ifdef SW_USE_OPENSSL
         if (conn->ssl)
         {
@@ -799,7 +1049,15 @@ static int swReactorThread_onWrite(swReactor *reactor, swEvent *ev)
     //remove EPOLLOUT event
     if (!conn->removed && swBuffer_empty(conn->out_buffer))
     {
-        reactor->set(reactor, fd, SW_FD_TCP | SW_EVENT_READ);
+        //still paused by the pipe backlog of the worker
+        if (conn->backpressure)
+        {
+            reactor->del(reactor, fd);
+        }
+        else
+        {
+            reactor->set(reactor, fd, SW_FD_TCP | SW_EVENT_READ);
+        }
     }
     return SW_OK;
 }
@@ -843,6 +1101,66 @@ int swReactorThread_create(swServer *serv)
     return SW_OK;
 }
 
+#ifdef HAVE_REUSEPORT
+/**
+ * [master] each reactor thread accepts on a SO_REUSEPORT listen socket of its own,
+ * the kernel spreads the new connections over them
+ */
+int swReactorThread_reuse_port(swServer *serv)
+{
+    swListenPort *ls;
+    int i, sock, ret = SW_OK;
+    int _reuse_port = SwooleG.reuse_port;
+
+    SwooleG.reuse_port = 1;
+    LL_FOREACH(serv->listen_list, ls)
+    {
+        if (ls->type != SW_SOCK_TCP && ls->type != SW_SOCK_TCP6)
+        {
+            continue;
+        }
+        ls->reactor_socks = sw_calloc(serv->reactor_num, sizeof(int));
+        if (ls->reactor_socks == NULL)
+        {
+            swWarn("malloc[reactor_socks] failed.");
+            ret = SW_ERR;
+            break;
+        }
+        //bound without SO_REUSEPORT
+        close(ls->sock);
+        for (i = 0; i < serv->reactor_num; i++)
+        {
+            sock = swSocket_create(ls->type);
+            if (sock < 0)
+            {
+                swSysError("create socket failed.");
+                ret = SW_ERR;
+                break;
+            }
+            if (swSocket_bind(sock, ls->type, ls->host, &ls->port) < 0)
+            {
+                close(sock);
+                ret = SW_ERR;
+                break;
+            }
+            swSetNonBlock(sock);
+            ls->reactor_socks[i] = sock;
+            ls->reactor_sock_num++;
+        }
+        if (ls->reactor_sock_num > 0)
+        {
+            ls->sock = ls->reactor_socks[0];
+        }
+        if (ret < 0)
+        {
+            break;
+        }
+    }
+    SwooleG.reuse_port = _reuse_port;
+    return ret;
+}
+#endif
+
 /**
  * [master]
  */
@@ -909,6 +1227,11 @@ int swReactorThread_start(swServer *serv)
         {
             continue;
         }
+        //accepted by the reactor threads
+        if (ls->reactor_socks)
+        {
+            continue;
+        }
         main_reactor->add(main_reactor, ls->sock, SW_FD_LISTEN);
     }
 
@@ -964,9 +1287,9 @@ int swReactorThread_start(swServer *serv)
     _init_master_thread: 
 
     /**
-     * heartbeat thread
+     * heartbeat thread, the reactor threads check the idle connections by themselves
      */
-    if (serv->heartbeat_check_interval >= 1 && serv->heartbeat_check_interval <= serv->heartbeat_idle_time)
+    if (serv->single_thread && serv->heartbeat_check_interval >= 1 && serv->heartbeat_check_interval <= serv->heartbeat_idle_time)
     {
         swTrace("hb timer start, time: %d live time:%d", serv->heartbeat_check_interval, serv->heartbeat_idle_time);
         swHeartbeatThread_start(serv);
@@ -1029,6 +1352,22 @@ int swReactorThread_init_reactor(swServer *serv, swReactor *reactor, uint16_t re
     reactor->setHandle(reactor, SW_FD_PIPE | SW_EVENT_READ, swReactorThread_onPipeReceive);
     reactor->setHandle(reactor, SW_FD_PIPE | SW_EVENT_WRITE, swReactorThread_onPipeWrite);
 
+    //listen TCP, the listen socket of its own
+    swListenPort *port;
+    LL_FOREACH(serv->listen_list, port)
+    {
+        if (port->reactor_socks == NULL)
+        {
+            continue;
+        }
+        if (reactor->add(reactor, port->reactor_socks[reactor_id], SW_FD_LISTEN) < 0)
+        {
+            return SW_ERR;
+        }
+    }
+    reactor->enable_accept = swServer_enable_accept;
+    reactor->setHandle(reactor, SW_FD_LISTEN, swServer_master_onAccept);
+
     //listen UDP
     if (serv->have_dgram_sock == 1)
     {
@@ -1180,6 +1519,26 @@ static int swReactorThread_loop(swThreadParam *param)
         return SW_ERR;
     }
 
+    //heartbeat check
+    if (serv->heartbeat_check_interval >= 1 && serv->heartbeat_check_interval <= serv->heartbeat_idle_time)
+    {
+        thread->idle_slot_num = serv->heartbeat_idle_time / serv->heartbeat_check_interval + 2;
+        thread->idle_slots = sw_calloc(thread->idle_slot_num, sizeof(int));
+        if (thread->idle_slots == NULL)
+        {
+            swWarn("malloc[idle_slots] failed.");
+            return SW_ERR;
+        }
+        thread->idle_tick = serv->gs->now / serv->heartbeat_check_interval;
+        //wake up at least once a second to see the slot expire
+        reactor->timeout_msec = 1000;
+    }
+    if (thread->idle_slots || serv->pipe_backlog_size > 0 || serv->pipe_backlog_num > 0)
+    {
+        reactor->onFinish = swReactorThread_onTimeout;
+        reactor->onTimeout = swReactorThread_onTimeout;
+    }
+
     //wait other thread
 #ifdef HAVE_PTHREAD_BARRIER
     pthread_barrier_wait(&serv->barrier);
@@ -1190,12 +1549,75 @@ static int swReactorThread_loop(swThreadParam *param)
     reactor->wait(reactor, NULL);
     //shutdown
     reactor->free(reactor);
+    if (thread->idle_slots)
+    {
+        sw_free(thread->idle_slots);
+        thread->idle_slots = NULL;
+    }
+    if (thread->paused_list)
+    {
+        sw_free(thread->paused_list);
+        thread->paused_list = NULL;
+    }
 
     swString_free(SwooleTG.buffer_stack);
+#ifdef HAVE_RECVMMSG
+    if (sw_udp_batch.buffer)
+    {
+        sw_free(sw_udp_batch.buffer);
+    }
+#endif
     pthread_exit(0);
     return SW_OK;
 }
 
+/**
+ * copy the whole package into the ring of the target worker and send only its address,
+ * the ring is mapped before the workers are forked so the pointer is valid on both sides
+ */
+static int swReactorThread_dispatch_shm(swServer *serv, swDispatchData *task, char *data, uint32_t length)
+{
+    task->data.info.type = SW_EVENT_PACKAGE;
+    int target_worker_id = swServer_worker_schedule(serv, task->data.info.fd, &task->data);
+    //the chunked fallback must go to the same worker
+    SwooleTG.factory_target_worker = target_worker_id;
+
+    swWorker *worker = swServer_get_worker(serv, target_worker_id);
+    swMemoryPool *pool = worker->dispatch_shm;
+    //several reactor threads may dispatch to the same worker
+    sw_spinlock(&worker->dispatch_lock);
+    void *mem = pool->alloc(pool, length);
+    if (mem)
+    {
+        worker->dispatch_shm_num++;
+    }
+    sw_spinlock_release(&worker->dispatch_lock);
+    if (mem == NULL)
+    {
+        swTraceLog(SW_TRACE_REACTOR, "the dispatch ring of worker#%d is full, size=%d.", target_worker_id, length);
+        return SW_ERR;
+    }
+    memcpy(mem, data, length);
+
+    swString pkg;
+    bzero(&pkg, sizeof(pkg));
+    pkg.str = mem;
+    pkg.length = length;
+    task->data.info.len = sizeof(pkg);
+    memcpy(task->data.data, &pkg, sizeof(pkg));
+    task->target_worker_id = target_worker_id;
+
+    if (serv->factory.dispatch(&serv->factory, task) < 0)
+    {
+        sw_spinlock(&worker->dispatch_lock);
+        pool->free(pool, mem);
+        worker->dispatch_shm_num--;
+        sw_spinlock_release(&worker->dispatch_lock);
+        return SW_ERR;
+    }
+    return SW_OK;
+}
+
 /**
  * dispatch request data [only data frame]
  */
@@ -1241,15 +1663,28 @@ int swReactorThread_dispatch(swConnection *conn, char *data, uint32_t length)
 
     swTrace("send string package, size=%ld bytes.", (long)length);
 
-
-    task.data.info.type = SW_EVENT_PACKAGE_START;
-    task.target_worker_id = -1;
-
     /**
      * lock target
      */
     SwooleTG.factory_lock_target = 1;
 
+    /**
+     * big package, pass it through the shared memory ring of the worker
+     */
+    if (length > SW_IPC_BUFFER_SIZE && serv->factory_mode == SW_MODE_PROCESS && serv->dispatch_shm_size > 0
+            && serv->dispatch_mode != SW_DISPATCH_USERFUNC && !conn->closed)
+    {
+        if (swReactorThread_dispatch_shm(serv, &task, data, length) == SW_OK)
+        {
+            SwooleTG.factory_target_worker = -1;
+            SwooleTG.factory_lock_target = 0;
+            return SW_OK;
+        }
+    }
+
+    task.data.info.type = SW_EVENT_PACKAGE_START;
+    task.target_worker_id = -1;
+
     size_t send_n = length;
     size_t offset = 0;
 
@@ -1326,6 +1761,128 @@ void swReactorThread_free(swServer *serv)
     }
 }
 
+/**
+ * the connections are kept in the slot of the tick they would expire in, only the slots of the past ticks are visited,
+ * a connection active in the meantime is moved to the slot of its new expiry
+ */
+static void swReactorThread_check_idle(swReactor *reactor)
+{
+    swServer *serv = reactor->ptr;
+    swReactorThread *thread = swServer_get_thread(serv, reactor->id);
+    swConnection *conn;
+    time_t now = serv->gs->now;
+    time_t now_tick = now / serv->heartbeat_check_interval;
+    uint32_t slot;
+    int fd, next;
+
+    if (now_tick - thread->idle_tick > thread->idle_slot_num)
+    {
+        thread->idle_tick = now_tick - thread->idle_slot_num;
+    }
+
+    for (; thread->idle_tick < now_tick; thread->idle_tick++)
+    {
+        slot = thread->idle_tick % thread->idle_slot_num;
+        next = thread->idle_slots[slot];
+        thread->idle_slots[slot] = 0;
+
+        while (next)
+        {
+            fd = next;
+            conn = &serv->connection_list[fd];
+            next = conn->idle_next;
+            conn->idle_slot = 0;
+
+            if (conn->active == 0 || conn->closed || conn->fdtype != SW_FD_TCP)
+            {
+                continue;
+            }
+            if (conn->protect)
+            {
+                swReactorThread_idle_link(serv, thread, conn, (now + serv->heartbeat_idle_time) / serv->heartbeat_check_interval);
+                continue;
+            }
+            if (conn->last_time > now - serv->heartbeat_idle_time)
+            {
+                swReactorThread_idle_link(serv, thread, conn, (conn->last_time + serv->heartbeat_idle_time) / serv->heartbeat_check_interval);
+                continue;
+            }
+
+            conn->close_force = 1;
+            conn->close_notify = 1;
+            if (conn->removed)
+            {
+                swServer_tcp_notify(serv, conn, SW_EVENT_CLOSE);
+            }
+            else
+            {
+                reactor->set(reactor, fd, SW_FD_TCP | SW_EVENT_WRITE);
+            }
+        }
+    }
+}
+
+/**
+ * resume the connections of the workers drained below the half of the budget, drop the closed ones
+ */
+static void swReactorThread_check_paused(swReactor *reactor)
+{
+    swServer *serv = reactor->ptr;
+    swReactorThread *thread = swServer_get_thread(serv, reactor->id);
+    swPausedConnection *paused;
+    swConnection *conn;
+    uint32_t i, n = 0;
+
+    for (i = 0; i < thread->paused_num; i++)
+    {
+        paused = &thread->paused_list[i];
+        conn = &serv->connection_list[paused->fd];
+        if (conn->active == 0 || conn->closed || conn->session_id != paused->session_id || conn->backpressure == 0)
+        {
+            continue;
+        }
+        if (!swReactorThread_pipe_drained(serv, &serv->workers[paused->worker_id]))
+        {
+            thread->paused_list[n++] = *paused;
+            continue;
+        }
+        conn->backpressure = 0;
+        if (conn->events & SW_EVENT_WRITE)
+        {
+            reactor->set(reactor, conn->fd, conn->fdtype | SW_EVENT_READ | SW_EVENT_WRITE);
+        }
+        else
+        {
+            reactor->add(reactor, conn->fd, conn->fdtype | SW_EVENT_READ);
+        }
+    }
+    thread->paused_num = n;
+}
+
+static void swReactorThread_onTimeout(swReactor *reactor)
+{
+    swServer *serv = reactor->ptr;
+    swReactorThread *thread = swServer_get_thread(serv, reactor->id);
+
+    if (thread->paused_num > 0)
+    {
+        swReactorThread_check_paused(reactor);
+    }
+    if (thread->idle_slots)
+    {
+        swReactorThread_check_idle(reactor);
+    }
+    //nothing wakes up the thread when a worker drains, look at it again soon
+    if (thread->paused_num > 0)
+    {
+        reactor->timeout_msec = SW_PIPE_BACKLOG_CHECK_INTERVAL;
+    }
+    else
+    {
+        reactor->timeout_msec = thread->idle_slots ? 1000 : -1;
+    }
+}
+
 static void swHeartbeatThread_start(swServer *serv)
 {
     swThreadParam *param;
@@ -32,19 +32,42 @@ __thread swThreadG SwooleTG;
 int16_t sw_errno;
 char sw_error[SW_ERROR_MSG_SIZE];
 
+/**
+ * the listen socket of the port the reactor accepts on, -1 if the port is not accepted by it
+ */
+static int swServer_get_accept_socket(swServer *serv, swListenPort *ls, swReactor *reactor)
+{
+    //UDP
+    if (ls->type == SW_SOCK_UDP || ls->type == SW_SOCK_UDP6 || ls->type == SW_SOCK_UNIX_DGRAM)
+    {
+        return -1;
+    }
+    if (serv->factory_mode != SW_MODE_PROCESS || serv->single_thread)
+    {
+        return ls->sock;
+    }
+    //master thread
+    if (reactor->id == serv->reactor_num)
+    {
+        return ls->reactor_socks ? -1 : ls->sock;
+    }
+    return ls->reactor_socks ? ls->reactor_socks[reactor->id] : -1;
+}
+
 static void swServer_disable_accept(swReactor *reactor)
 {
     swListenPort *ls;
     swServer *serv = reactor->ptr;
+    int sock;
 
     LL_FOREACH(serv->listen_list, ls)
     {
-        //UDP
-        if (ls->type == SW_SOCK_UDP || ls->type == SW_SOCK_UDP6 || ls->type == SW_SOCK_UNIX_DGRAM)
+        sock = swServer_get_accept_socket(serv, ls, reactor);
+        if (sock < 0)
         {
             continue;
         }
-        reactor->del(reactor, ls->sock);
+        reactor->del(reactor, sock);
     }
 }
 
@@ -52,18 +75,35 @@ void swServer_enable_accept(swReactor *reactor)
 {
     swListenPort *ls;
     swServer *serv = reactor->ptr;
+    int sock;
 
     LL_FOREACH(serv->listen_list, ls)
     {
-        //UDP
-        if (ls->type == SW_SOCK_UDP || ls->type == SW_SOCK_UDP6 || ls->type == SW_SOCK_UNIX_DGRAM)
+        sock = swServer_get_accept_socket(serv, ls, reactor);
+        if (sock < 0)
         {
             continue;
         }
-        reactor->add(reactor, ls->sock, SW_FD_LISTEN);
+        reactor->add(reactor, sock, SW_FD_LISTEN);
     }
 }
 
+/**
+ * the reactor thread holding the fewest connections
+ */
+static int swServer_get_least_connection_reactor(swServer *serv)
+{
+    int i, reactor_id = 0;
+    for (i = 1; i < serv->reactor_num; i++)
+    {
+        if (serv->reactor_threads[i].connection_num < serv->reactor_threads[reactor_id].connection_num)
+        {
+            reactor_id = i;
+        }
+    }
+    return reactor_id;
+}
+
 void swServer_close_port(swServer *serv, enum swBool_type only_stream_port)
 {
     swListenPort *ls;
@@ -75,6 +115,14 @@ void swServer_close_port(swServer *serv, enum swBool_type only_stream_port)
             continue;
         }
         //stream socket
+        if (ls->reactor_socks)
+        {
+            int i;
+            for (i = 1; i < ls->reactor_sock_num; i++)
+            {
+                close(ls->reactor_socks[i]);
+            }
+        }
         close(ls->sock);
     }
 }
@@ -126,9 +174,22 @@ int swServer_master_onAccept(swReactor *reactor, swEvent *event)
             reactor_id = 0;
             sub_reactor = reactor;
         }
+        //accepted by the reactor thread on its own listen socket
+        else if (reactor->id < serv->reactor_num)
+        {
+            reactor_id = reactor->id;
+            sub_reactor = reactor;
+        }
         else
         {
-            reactor_id = new_fd % serv->reactor_num;
+            if (serv->reactor_dispatch_mode == SW_REACTOR_DISPATCH_LEAST_CONN)
+            {
+                reactor_id = swServer_get_least_connection_reactor(serv);
+            }
+            else
+            {
+                reactor_id = new_fd % serv->reactor_num;
+            }
             sub_reactor = &serv->reactor_threads[reactor_id].reactor;
         }
 
@@ -187,10 +248,11 @@ static int swServer_start_check(swServer *serv)
         swWarn("onPacket event callback must be set.");
         return SW_ERR;
     }
-    //disable notice when use SW_DISPATCH_ROUND and SW_DISPATCH_QUEUE
+    //disable notice when use SW_DISPATCH_ROUND, SW_DISPATCH_QUEUE and SW_DISPATCH_LEAST_LOAD
     if (serv->factory_mode == SW_MODE_PROCESS)
     {
-        if (serv->dispatch_mode == SW_DISPATCH_ROUND || serv->dispatch_mode == SW_DISPATCH_QUEUE)
+        if (serv->dispatch_mode == SW_DISPATCH_ROUND || serv->dispatch_mode == SW_DISPATCH_QUEUE
+                || serv->dispatch_mode == SW_DISPATCH_LEAST_LOAD)
         {
             if (!serv->enable_unsafe_event)
             {
@@ -321,6 +383,19 @@ void swServer_store_listen_socket(swServer *serv)
             swServer_set_minfd(serv, sockfd);
             swServer_set_maxfd(serv, sockfd);
         }
+        //the listen sockets of the other reactor threads
+        if (ls->reactor_socks)
+        {
+            int i;
+            for (i = 1; i < ls->reactor_sock_num; i++)
+            {
+                sockfd = ls->reactor_socks[i];
+                serv->connection_list[sockfd] = serv->connection_list[ls->sock];
+                serv->connection_list[sockfd].fd = sockfd;
+                swServer_set_minfd(serv, sockfd);
+                swServer_set_maxfd(serv, sockfd);
+            }
+        }
     }
 }
 
@@ -619,6 +694,10 @@ int swServer_start(swServer *serv)
             }
         }
     }
+    if (serv->task_worker_num > 0 && swTaskWorker_shm_create(serv) < 0)
+    {
+        return SW_ERR;
+    }
 
     /**
      * user worker process
@@ -634,6 +713,19 @@ int swServer_start(swServer *serv)
         }
     }
 
+#ifdef HAVE_REUSEPORT
+    /**
+     * before forking the manager, the listen sockets are shared with it
+     */
+    if (serv->factory_mode == SW_MODE_PROCESS && serv->enable_reuse_port && !serv->single_thread)
+    {
+        if (swReactorThread_reuse_port(serv) < 0)
+        {
+            return SW_ERR;
+        }
+    }
+#endif
+
     //factory start
     if (factory->start(factory) < 0)
     {
@@ -684,6 +776,7 @@ void swServer_init(swServer *serv)
     serv->reactor_num = SW_REACTOR_NUM > SW_REACTOR_MAX_THREAD ? SW_REACTOR_MAX_THREAD : SW_REACTOR_NUM;
 
     serv->dispatch_mode = SW_DISPATCH_FDMOD;
+    serv->reactor_dispatch_mode = SW_REACTOR_DISPATCH_FDMOD;
 
     serv->worker_num = SW_CPU_NUM;
     serv->max_connection = MIN(SW_MAX_CONNECTION, SwooleG.max_sockets);
@@ -705,6 +798,7 @@ void swServer_init(swServer *serv)
     serv->buffer_output_size = SW_BUFFER_OUTPUT_SIZE;
 
     serv->task_ipc_mode = SW_TASK_IPC_UNIXSOCK;
+    serv->task_shm_size = SW_TASK_SHM_SIZE;
 
     serv->enable_coroutine = 1;
 
@@ -845,6 +939,172 @@ int swServer_udp_send(swServer *serv, swSendData *resp)
     return ret;
 }
 
+#ifdef HAVE_SENDMMSG
+/**
+ * datagrams sent by the worker in one round of the event loop, written with one sendmmsg() at the end of the round,
+ * [head, num) are not sent yet
+ */
+static struct
+{
+    int fd;
+    uint8_t deferred;
+    uint32_t head;
+    uint32_t num;
+    uint32_t offset;
+    /* the socket was full, the rest of the batch is sent by the timer */
+    swTimer_node *retry_timer;
+    /* errno of a datagram rejected by the last flush */
+    int error;
+    char *buffer;
+    struct mmsghdr msgs[SW_UDP_SEND_BATCH];
+    struct iovec iov[SW_UDP_SEND_BATCH];
+    swSocketAddress addrs[SW_UDP_SEND_BATCH];
+} sw_udp_queue;
+
+static void swServer_udp_onRetry(swTimer *timer, swTimer_node *tnode);
+
+/**
+ * never waits for the socket, the datagrams left are retried by a timer
+ */
+static void swServer_udp_flush(void)
+{
+    int fd = sw_udp_queue.fd;
+
+    while (sw_udp_queue.head < sw_udp_queue.num)
+    {
+        int n = sendmmsg(fd, sw_udp_queue.msgs + sw_udp_queue.head, sw_udp_queue.num - sw_udp_queue.head, 0);
+        if (n >= 0)
+        {
+            sw_udp_queue.head += n;
+        }
+        else if (errno == EINTR)
+        {
+            continue;
+        }
+        else if (swConnection_error(errno) == SW_WAIT)
+        {
+            if (sw_udp_queue.retry_timer == NULL)
+            {
+                sw_udp_queue.retry_timer = swTimer_add(&SwooleG.timer, 1, 0, NULL, swServer_udp_onRetry);
+            }
+            return;
+        }
+        else
+        {
+            //the datagram at the head of the batch is rejected, drop it and go on with the rest
+            swSysError("sendmmsg(%d) failed.", fd);
+            sw_udp_queue.error = errno;
+            sw_udp_queue.head++;
+        }
+    }
+    sw_udp_queue.head = 0;
+    sw_udp_queue.num = 0;
+    sw_udp_queue.offset = 0;
+}
+
+static void swServer_udp_onRetry(swTimer *timer, swTimer_node *tnode)
+{
+    sw_udp_queue.retry_timer = NULL;
+    swServer_udp_flush();
+}
+
+static void swServer_udp_onDefer(void *data)
+{
+    sw_udp_queue.deferred = 0;
+    if (sw_udp_queue.retry_timer == NULL)
+    {
+        swServer_udp_flush();
+    }
+}
+
+static int swServer_udp_sendto_nowait(int server_sock, swSocketAddress *sa, char *data, uint32_t length)
+{
+    ssize_t n;
+    do
+    {
+        n = sendto(server_sock, data, length, 0, (struct sockaddr *) &sa->addr, sa->len);
+    } while (n < 0 && errno == EINTR);
+    return n;
+}
+#endif
+
+/**
+ * [Worker] send a datagram to the client, in the event loop it is queued and the result is the one of the queueing,
+ * once a queued datagram is rejected the queue is flushed and the datagrams are sent one by one until one succeeds
+ */
+int swServer_udp_sendto(swServer *serv, int server_sock, swSocketAddress *sa, char *data, uint32_t length)
+{
+#ifdef HAVE_SENDMMSG
+    swReactor *reactor = SwooleG.main_reactor;
+    //out of the event loop, e.g. onWorkerStart, onWorkerStop or the task workers
+    if (reactor == NULL || !reactor->start || !reactor->running || length > SW_UDP_SEND_BUFFER_SIZE)
+    {
+        goto _send;
+    }
+    if (sw_udp_queue.buffer == NULL)
+    {
+        sw_udp_queue.buffer = sw_malloc(SW_UDP_SEND_BUFFER_SIZE);
+        if (sw_udp_queue.buffer == NULL)
+        {
+            goto _send;
+        }
+    }
+    if (sw_udp_queue.error)
+    {
+        if (sw_udp_queue.retry_timer == NULL)
+        {
+            swServer_udp_flush();
+        }
+        int n = swServer_udp_sendto_nowait(server_sock, sa, data, length);
+        if (n >= 0)
+        {
+            sw_udp_queue.error = 0;
+        }
+        return n;
+    }
+    if (sw_udp_queue.num > 0
+            && (sw_udp_queue.fd != server_sock || sw_udp_queue.num == SW_UDP_SEND_BATCH
+                    || sw_udp_queue.offset + length > SW_UDP_SEND_BUFFER_SIZE))
+    {
+        if (sw_udp_queue.retry_timer == NULL)
+        {
+            swServer_udp_flush();
+        }
+        if (sw_udp_queue.num > 0)
+        {
+            //the socket is still full, like a non-blocking sendto()
+            errno = EAGAIN;
+            return SW_ERR;
+        }
+    }
+
+    uint32_t i = sw_udp_queue.num;
+    char *buf = sw_udp_queue.buffer + sw_udp_queue.offset;
+    memcpy(buf, data, length);
+    memcpy(&sw_udp_queue.addrs[i], sa, sizeof(*sa));
+    sw_udp_queue.iov[i].iov_base = buf;
+    sw_udp_queue.iov[i].iov_len = length;
+    bzero(&sw_udp_queue.msgs[i], sizeof(sw_udp_queue.msgs[i]));
+    sw_udp_queue.msgs[i].msg_hdr.msg_name = &sw_udp_queue.addrs[i].addr;
+    sw_udp_queue.msgs[i].msg_hdr.msg_namelen = sa->len;
+    sw_udp_queue.msgs[i].msg_hdr.msg_iov = &sw_udp_queue.iov[i];
+    sw_udp_queue.msgs[i].msg_hdr.msg_iovlen = 1;
+    sw_udp_queue.fd = server_sock;
+    sw_udp_queue.num++;
+    sw_udp_queue.offset += length;
+
+    if (!sw_udp_queue.deferred)
+    {
+        sw_udp_queue.deferred = 1;
+        reactor->defer(reactor, swServer_udp_onDefer, NULL);
+    }
+    return length;
+
+    _send:
+#endif
+    return swSocket_sendto_blocking(server_sock, data, length, 0, (struct sockaddr *) &sa->addr, sa->len);
+}
+
 /**
  * worker to master process
  */
@@ -978,8 +1238,7 @@ int swServer_master_send(swServer *serv, swSendData *_send)
     else
     {
         reactor = &(serv->reactor_threads[conn->from_id].reactor);
-        assert(fd % serv->reactor_num == reactor->id);
-        assert(fd % serv->reactor_num == SwooleTG.id);
+        assert(reactor->id == SwooleTG.id);
     }
 
     if (serv->factory_mode == SW_MODE_BASE && conn->overflow)
@@ -1013,6 +1272,7 @@ int swServer_master_send(swServer *serv, swSendData *_send)
      */
     else if (_send->info.type == SW_EVENT_PAUSE_RECV)
     {
+        conn->backpressure = 0;
         if (conn->events & SW_EVENT_WRITE)
         {
             return reactor->set(reactor, conn->fd, conn->fdtype | SW_EVENT_WRITE);
@@ -1027,6 +1287,7 @@ int swServer_master_send(swServer *serv, swSendData *_send)
      */
     else if (_send->info.type == SW_EVENT_RESUME_RECV)
     {
+        conn->backpressure = 0;
         if (conn->events & SW_EVENT_WRITE)
         {
             return reactor->set(reactor, conn->fd, conn->fdtype | SW_EVENT_READ | SW_EVENT_WRITE);
@@ -1115,8 +1376,8 @@ int swServer_master_send(swServer *serv, swSendData *_send)
     //send data
     else
     {
-        //connection is closed
-        if (conn->removed)
+        //connection is closed, a connection paused by the pipe backlog is still writable
+        if (conn->removed && !conn->backpressure)
         {
             swWarn("connection#%d is closed by client.", fd);
             return SW_ERR;
@@ -1161,8 +1422,24 @@ int swServer_master_send(swServer *serv, swSendData *_send)
     }
 
     //listen EPOLLOUT event
-    if (reactor->set(reactor, fd, SW_EVENT_TCP | SW_EVENT_WRITE | SW_EVENT_READ) < 0
-            && (errno == EBADF || errno == ENOENT))
+    int ret;
+    if (conn->backpressure)
+    {
+        //keep the reading paused until the worker drains its pipe backlog
+        if (conn->removed)
+        {
+            ret = reactor->add(reactor, fd, SW_EVENT_TCP | SW_EVENT_WRITE);
+        }
+        else
+        {
+            ret = reactor->set(reactor, fd, SW_EVENT_TCP | SW_EVENT_WRITE);
+        }
+    }
+    else
+    {
+        ret = reactor->set(reactor, fd, SW_EVENT_TCP | SW_EVENT_WRITE | SW_EVENT_READ);
+    }
+    if (ret < 0 && (errno == EBADF || errno == ENOENT))
     {
         goto close_fd;
     }
@@ -1760,13 +2037,12 @@ static swConnection* swServer_connection_new(swServer *serv, swListenPort *ls, i
 {
     swConnection* connection = NULL;
 
-    serv->stats->accept_count++;
+    sw_atomic_fetch_add(&serv->stats->accept_count, 1);
     sw_atomic_fetch_add(&serv->stats->connection_num, 1);
     sw_atomic_fetch_add(&ls->connection_num, 1);
-
-    if (fd > swServer_get_maxfd(serv))
+    if (serv->factory_mode == SW_MODE_PROCESS)
     {
-        swServer_set_maxfd(serv, fd);
+        sw_atomic_fetch_add(&serv->reactor_threads[reactor_id].connection_num, 1);
     }
 
     connection = &(serv->connection_list[fd]);
@@ -1818,6 +2094,11 @@ static swConnection* swServer_connection_new(swServer *serv, swListenPort *ls, i
 
     swSession *session;
     sw_spinlock(&serv->gs->spinlock);
+    //the reactor threads may accept at the same time
+    if (fd > swServer_get_maxfd(serv))
+    {
+        swServer_set_maxfd(serv, fd);
+    }
     int i;
     uint32_t session_id = serv->gs->session_round;
     //get session id
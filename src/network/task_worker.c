@@ -19,6 +19,27 @@
 
 static swEventData *g_current_task = NULL;
 
+/**
+ * shared arena of the task payloads too large for the pipe, a payload takes a run of adjacent slots,
+ * the slots are given back when the last reference to the payload is released
+ */
+typedef struct _swTaskShm
+{
+    sw_atomic_t lock;
+    uint32_t slot_num;
+    uint32_t cursor;
+    uint8_t *used;
+    char *memory;
+} swTaskShm;
+
+typedef struct
+{
+    sw_atomic_t refcount;
+    uint32_t slot_count;
+    size_t length;
+    char data[0];
+} swTaskShm_slot;
+
 static void swTaskWorker_signal_init(swProcessPool *pool);
 static int swTaskWorker_onPipeReceive(swReactor *reactor, swEvent *event);
 static int swTaskWorker_loop_async(swProcessPool *pool, swWorker *worker);
@@ -46,6 +67,13 @@ void swTaskWorker_init(swServer *serv)
     {
         pool->dispatch_mode = SW_DISPATCH_QUEUE;
     }
+    /**
+     * the pipes of the task workers are shared by all of them, only the blocking loop can steal
+     */
+    else if (serv->task_enable_steal && serv->task_ipc_mode == SW_TASK_IPC_UNIXSOCK && !serv->task_enable_coroutine)
+    {
+        pool->work_stealing = 1;
+    }
 }
 
 /**
@@ -83,11 +111,132 @@ int swTaskWorker_onTask(swProcessPool *pool, swEventData *task)
     return ret;
 }
 
+int swTaskWorker_shm_create(swServer *serv)
+{
+    uint32_t slot_num = serv->task_shm_size / SW_TASK_SHM_SLOT_SIZE;
+    if (slot_num == 0)
+    {
+        return SW_OK;
+    }
+    size_t used_size = SW_MEM_ALIGNED_SIZE_EX(slot_num, 8);
+    swTaskShm *shm = sw_shm_calloc(1, sizeof(swTaskShm) + used_size + (size_t) slot_num * SW_TASK_SHM_SLOT_SIZE);
+    if (shm == NULL)
+    {
+        swWarn("sw_shm_calloc(%u) for the task arena failed.", serv->task_shm_size);
+        return SW_ERR;
+    }
+    shm->slot_num = slot_num;
+    shm->used = (uint8_t *) (shm + 1);
+    shm->memory = (char *) shm->used + used_size;
+    serv->task_shm = shm;
+    return SW_OK;
+}
+
+static sw_inline swTaskShm_slot* swTaskShm_get(swTaskShm *shm, uint32_t index)
+{
+    return (swTaskShm_slot *) (shm->memory + (size_t) index * SW_TASK_SHM_SLOT_SIZE);
+}
+
+/**
+ * next fit, a run never wraps around the end of the arena
+ */
+static int swTaskShm_alloc(swTaskShm *shm, size_t length)
+{
+    uint32_t n = (sizeof(swTaskShm_slot) + length + SW_TASK_SHM_SLOT_SIZE - 1) / SW_TASK_SHM_SLOT_SIZE;
+    if (n > shm->slot_num)
+    {
+        return SW_ERR;
+    }
+
+    int index = SW_ERR;
+    uint32_t i, pos, run = 0;
+
+    sw_spinlock(&shm->lock);
+    for (i = 0; i < shm->slot_num + n; i++)
+    {
+        pos = (shm->cursor + i) % shm->slot_num;
+        if (pos == 0 || shm->used[pos])
+        {
+            run = 0;
+        }
+        if (shm->used[pos])
+        {
+            continue;
+        }
+        if (++run == n)
+        {
+            index = pos + 1 - n;
+            memset(shm->used + index, 1, n);
+            shm->cursor = (pos + 1) % shm->slot_num;
+            break;
+        }
+    }
+    sw_spinlock_release(&shm->lock);
+
+    if (index >= 0)
+    {
+        swTaskShm_slot *slot = swTaskShm_get(shm, index);
+        slot->refcount = 1;
+        slot->slot_count = n;
+        slot->length = length;
+    }
+    return index;
+}
+
+static void swTaskShm_release(swTaskShm *shm, uint32_t index)
+{
+    swTaskShm_slot *slot = swTaskShm_get(shm, index);
+    if (sw_atomic_sub_fetch(&slot->refcount, 1) == 0)
+    {
+        sw_spinlock(&shm->lock);
+        memset(shm->used + index, 0, slot->slot_count);
+        sw_spinlock_release(&shm->lock);
+    }
+}
+
+swString* swTaskWorker_shm_unpack(swPackage_task *pkg, int peek)
+{
+    swTaskShm *shm = SwooleG.serv ? SwooleG.serv->task_shm : NULL;
+    if (shm == NULL || pkg->shm_slot >= shm->slot_num)
+    {
+        swWarn("invalid task payload slot[%u].", pkg->shm_slot);
+        return NULL;
+    }
+
+    swTaskShm_slot *slot = swTaskShm_get(shm, pkg->shm_slot);
+    swString *buffer = SwooleTG.buffer_stack;
+    if (buffer->size < slot->length && swString_extend_align(buffer, slot->length) < 0)
+    {
+        return NULL;
+    }
+    memcpy(buffer->str, slot->data, slot->length);
+    buffer->length = slot->length;
+    if (!peek)
+    {
+        swTaskShm_release(shm, pkg->shm_slot);
+    }
+    return buffer;
+}
+
 int swTaskWorker_large_pack(swEventData *task, void *data, int data_len)
 {
     swPackage_task pkg;
     bzero(&pkg, sizeof(pkg));
 
+    swTaskShm *shm = SwooleG.serv ? SwooleG.serv->task_shm : NULL;
+    int index = shm ? swTaskShm_alloc(shm, data_len) : SW_ERR;
+    if (index >= 0)
+    {
+        memcpy(swTaskShm_get(shm, index)->data, data, data_len);
+        pkg.shm_slot = index;
+        pkg.length = data_len;
+        task->info.len = sizeof(swPackage_task);
+        swTask_type(task) |= SW_TASK_TMPFILE;
+        memcpy(task->data, &pkg, sizeof(swPackage_task));
+        return SW_OK;
+    }
+
+    //the arena is full, overflow to a tmpfile
     memcpy(pkg.tmpfile, SwooleG.task_tmpdir, SwooleG.task_tmpdir_len);
 
     //create temp file
@@ -206,6 +355,10 @@ static int swTaskWorker_onPipeReceive(swReactor *reactor, swEvent *event)
 
     if (read(event->fd, &task, sizeof(task)) > 0)
     {
+        if (task.info.type != SW_EVENT_PIPE_MESSAGE)
+        {
+            sw_atomic_fetch_sub(&worker->tasking_num, 1);
+        }
         worker->status = SW_WORKER_BUSY;
         worker->request_time = time(NULL);
         int retval = swTaskWorker_onTask(pool, &task);
@@ -16,9 +16,63 @@
 
 #include "swoole.h"
 
+/**
+ * hierarchical timing wheel, 1 msec per tick:
+ * root wheel 256 slots, then 4 levels of 64 slots, covering 2^32 msec
+ */
+#define SW_TIMER_WHEEL_ROOT_BITS    8
+#define SW_TIMER_WHEEL_LEVEL_BITS   6
+#define SW_TIMER_WHEEL_LEVEL_NUM    4
+#define SW_TIMER_WHEEL_ROOT_SIZE    (1 << SW_TIMER_WHEEL_ROOT_BITS)
+#define SW_TIMER_WHEEL_LEVEL_SIZE   (1 << SW_TIMER_WHEEL_LEVEL_BITS)
+#define SW_TIMER_WHEEL_ROOT_MASK    (SW_TIMER_WHEEL_ROOT_SIZE - 1)
+#define SW_TIMER_WHEEL_LEVEL_MASK   (SW_TIMER_WHEEL_LEVEL_SIZE - 1)
+#define SW_TIMER_WHEEL_MAX_SPAN     ((1LL << (SW_TIMER_WHEEL_ROOT_BITS + SW_TIMER_WHEEL_LEVEL_NUM * SW_TIMER_WHEEL_LEVEL_BITS)) - 1)
+#define SW_TIMER_WHEEL_LEVEL_SHIFT(l) (SW_TIMER_WHEEL_ROOT_BITS + (l) * SW_TIMER_WHEEL_LEVEL_BITS)
+
+typedef struct _swTimerWheel_block
+{
+    struct _swTimerWheel_block *next;
+    swTimer_node nodes[SW_TIMER_WHEEL_POOL_BLOCK];
+} swTimerWheel_block;
+
+struct _swTimerWheel
+{
+    /**
+     * next tick (relative msec) to be processed
+     */
+    int64_t current;
+    swTimer_node *root[SW_TIMER_WHEEL_ROOT_SIZE];
+    swTimer_node *levels[SW_TIMER_WHEEL_LEVEL_NUM][SW_TIMER_WHEEL_LEVEL_SIZE];
+    /**
+     * non-empty slot hints, may contain stale bits
+     */
+    uint64_t root_bitmap[SW_TIMER_WHEEL_ROOT_SIZE / 64];
+    uint64_t level_bitmap[SW_TIMER_WHEEL_LEVEL_NUM];
+    /**
+     * node pool
+     */
+    swTimer_node *free_list;
+    swTimerWheel_block *blocks;
+    /**
+     * timer id => node
+     */
+    swTimer_node **index;
+    uint32_t index_size;
+};
+
 static int swReactorTimer_init(long msec);
 static int swReactorTimer_set(swTimer *timer, long exec_msec);
 
+static swTimerWheel* swTimerWheel_new(int64_t now_msec);
+static void swTimerWheel_free(swTimerWheel *wheel);
+static swTimer_node* swTimerWheel_alloc(swTimerWheel *wheel);
+static void swTimerWheel_release(swTimerWheel *wheel, swTimer_node *tnode);
+static void swTimerWheel_link(swTimerWheel *wheel, swTimer_node *tnode);
+static int swTimerWheel_index_add(swTimerWheel *wheel, swTimer_node *tnode, uint32_t num);
+static void swTimerWheel_index_del(swTimerWheel *wheel, swTimer_node *tnode);
+static int swTimerWheel_select(swTimer *timer, int64_t now_msec);
+
 int swTimer_now(struct timeval *time)
 {
 #if defined(SW_USE_MONOTONIC_TIME) && defined(CLOCK_MONOTONIC)
@@ -47,18 +101,29 @@ static int swTimer_init(long msec)
         return SW_ERR;
     }
 
-    SwooleG.timer.heap = swHeap_new(1024, SW_MIN_HEAP);
-    if (!SwooleG.timer.heap)
+    if (SwooleG.use_timer_wheel)
     {
-        return SW_ERR;
+        SwooleG.timer.wheel = swTimerWheel_new(0);
+        if (!SwooleG.timer.wheel)
+        {
+            return SW_ERR;
+        }
     }
-
-    SwooleG.timer.map = swHashMap_new(SW_HASHMAP_INIT_BUCKET_N, NULL);
-    if (!SwooleG.timer.map)
+    else
     {
-        swHeap_free(SwooleG.timer.heap);
-        SwooleG.timer.heap = NULL;
-        return SW_ERR;
+        SwooleG.timer.heap = swHeap_new(1024, SW_MIN_HEAP);
+        if (!SwooleG.timer.heap)
+        {
+            return SW_ERR;
+        }
+
+        SwooleG.timer.map = swHashMap_new(SW_HASHMAP_INIT_BUCKET_N, NULL);
+        if (!SwooleG.timer.map)
+        {
+            swHeap_free(SwooleG.timer.heap);
+            SwooleG.timer.heap = NULL;
+            return SW_ERR;
+        }
     }
 
     SwooleG.timer._current_id = -1;
@@ -85,6 +150,11 @@ void swTimer_free(swTimer *timer)
     {
         swHeap_free(timer->heap);
     }
+    if (timer->wheel)
+    {
+        swTimerWheel_free(timer->wheel);
+        timer->wheel = NULL;
+    }
     timer->set(timer, -1);
 }
 
@@ -116,7 +186,7 @@ swTimer_node* swTimer_add(swTimer *timer, long _msec, int interval, void *data,
         return NULL;
     }
 
-    swTimer_node *tnode = sw_malloc(sizeof(swTimer_node));
+    swTimer_node *tnode = timer->wheel ? swTimerWheel_alloc(timer->wheel) : sw_malloc(sizeof(swTimer_node));
     if (unlikely(!tnode))
     {
         swSysError("malloc(%ld) failed.", sizeof(swTimer_node));
@@ -126,8 +196,7 @@ swTimer_node* swTimer_add(swTimer *timer, long _msec, int interval, void *data,
     int64_t now_msec = swTimer_get_relative_msec();
     if (unlikely(now_msec < 0))
     {
-        sw_free(tnode);
-        return NULL;
+        goto _free_node;
     }
 
     tnode->data = data;
@@ -137,6 +206,7 @@ swTimer_node* swTimer_add(swTimer *timer, long _msec, int interval, void *data,
     tnode->remove = 0;
     tnode->callback = callback;
     tnode->round = timer->round;
+    tnode->heap_node = NULL;
 
     if (timer->_next_msec < 0 || timer->_next_msec > _msec)
     {
@@ -151,20 +221,40 @@ swTimer_node* swTimer_add(swTimer *timer, long _msec, int interval, void *data,
         timer->_next_id = 2;
     }
 
-    tnode->heap_node = swHeap_push(timer->heap, tnode->exec_msec, tnode);
-    if (unlikely(tnode->heap_node == NULL))
+    if (timer->wheel)
     {
-        sw_free(tnode);
-        return NULL;
+        if (unlikely(swTimerWheel_index_add(timer->wheel, tnode, timer->num + 1) != SW_OK))
+        {
+            goto _free_node;
+        }
+        swTimerWheel_link(timer->wheel, tnode);
     }
-    if (unlikely(swHashMap_add_int(timer->map, tnode->id, tnode) != SW_OK))
+    else
     {
-        sw_free(tnode);
-        return NULL;
+        tnode->heap_node = swHeap_push(timer->heap, tnode->exec_msec, tnode);
+        if (unlikely(tnode->heap_node == NULL))
+        {
+            goto _free_node;
+        }
+        if (unlikely(swHashMap_add_int(timer->map, tnode->id, tnode) != SW_OK))
+        {
+            goto _free_node;
+        }
     }
     timer->num++;
     swTraceLog(SW_TRACE_TIMER, "id=%ld, exec_msec=%" PRId64 ", msec=%ld, round=%" PRIu64 ", exist=%u", tnode->id, tnode->exec_msec, _msec, tnode->round, timer->num);
     return tnode;
+
+    _free_node:
+    if (timer->wheel)
+    {
+        swTimerWheel_release(timer->wheel, tnode);
+    }
+    else
+    {
+        sw_free(tnode);
+    }
+    return NULL;
 }
 
 int swTimer_del(swTimer *timer, swTimer_node *tnode)
@@ -179,6 +269,14 @@ int swTimer_del(swTimer *timer, swTimer_node *tnode)
         swTraceLog(SW_TRACE_TIMER, "set-remove: id=%ld, exec_msec=%" PRId64 ", round=%" PRIu64 ", exist=%u", tnode->id, tnode->exec_msec, tnode->round, timer->num);
         return SW_TRUE;
     }
+    if (timer->wheel)
+    {
+        swTimerWheel_index_del(timer->wheel, tnode);
+        timer->num--;
+        swTraceLog(SW_TRACE_TIMER, "id=%ld, exec_msec=%" PRId64 ", round=%" PRIu64 ", exist=%u", tnode->id, tnode->exec_msec, tnode->round, timer->num);
+        swTimerWheel_release(timer->wheel, tnode);
+        return SW_TRUE;
+    }
     if (unlikely(swHashMap_del_int(timer->map, tnode->id) < 0))
     {
         return SW_ERR;
@@ -195,6 +293,51 @@ int swTimer_del(swTimer *timer, swTimer_node *tnode)
     return SW_TRUE;
 }
 
+swTimer_node* swTimer_get(swTimer *timer, long id)
+{
+    if (timer->wheel)
+    {
+        swTimer_node *tnode = timer->wheel->index[id & (timer->wheel->index_size - 1)];
+        while (tnode && tnode->id != id)
+        {
+            tnode = tnode->index_next;
+        }
+        return tnode;
+    }
+    return (swTimer_node*) swHashMap_find_int(timer->map, id);
+}
+
+/**
+ * the callback may only delete the node it is given
+ */
+void swTimer_each(swTimer *timer, swTimerEachCallback callback)
+{
+    swTimer_node *tnode;
+    if (timer->wheel)
+    {
+        uint32_t i;
+        swTimer_node *next;
+        for (i = 0; i < timer->wheel->index_size; i++)
+        {
+            for (tnode = timer->wheel->index[i]; tnode; tnode = next)
+            {
+                next = tnode->index_next;
+                callback(timer, tnode);
+            }
+        }
+        return;
+    }
+    if (!timer->map)
+    {
+        return;
+    }
+    uint64_t timer_id;
+    while ((tnode = (swTimer_node *) swHashMap_each_int(timer->map, &timer_id)))
+    {
+        callback(timer, tnode);
+    }
+}
+
 int swTimer_select(swTimer *timer)
 {
     int64_t now_msec = swTimer_get_relative_msec();
@@ -203,6 +346,11 @@ int swTimer_select(swTimer *timer)
         return SW_ERR;
     }
 
+    if (timer->wheel)
+    {
+        return swTimerWheel_select(timer, now_msec);
+    }
+
     swTimer_node *tnode = NULL;
     swHeap_node *tmp;
     long timer_id;
@@ -258,3 +406,357 @@ int swTimer_select(swTimer *timer)
     timer->round++;
     return SW_OK;
 }
+
+/*----------------------------------------timer wheel----------------------------------------*/
+
+static swTimerWheel* swTimerWheel_new(int64_t now_msec)
+{
+    swTimerWheel *wheel = sw_calloc(1, sizeof(swTimerWheel));
+    if (!wheel)
+    {
+        swSysError("calloc(%ld) failed.", sizeof(swTimerWheel));
+        return NULL;
+    }
+    wheel->index = sw_calloc(SW_TIMER_WHEEL_INDEX_INIT, sizeof(swTimer_node *));
+    if (!wheel->index)
+    {
+        swSysError("calloc(%ld) failed.", SW_TIMER_WHEEL_INDEX_INIT * sizeof(swTimer_node *));
+        sw_free(wheel);
+        return NULL;
+    }
+    wheel->index_size = SW_TIMER_WHEEL_INDEX_INIT;
+    wheel->current = now_msec;
+    return wheel;
+}
+
+static void swTimerWheel_free(swTimerWheel *wheel)
+{
+    swTimerWheel_block *block = wheel->blocks, *next;
+    while (block)
+    {
+        next = block->next;
+        sw_free(block);
+        block = next;
+    }
+    sw_free(wheel->index);
+    sw_free(wheel);
+}
+
+static swTimer_node* swTimerWheel_alloc(swTimerWheel *wheel)
+{
+    if (unlikely(wheel->free_list == NULL))
+    {
+        swTimerWheel_block *block = sw_malloc(sizeof(swTimerWheel_block));
+        if (!block)
+        {
+            return NULL;
+        }
+        int i;
+        for (i = SW_TIMER_WHEEL_POOL_BLOCK - 1; i >= 0; i--)
+        {
+            block->nodes[i].next = wheel->free_list;
+            wheel->free_list = &block->nodes[i];
+        }
+        block->next = wheel->blocks;
+        wheel->blocks = block;
+    }
+    swTimer_node *tnode = wheel->free_list;
+    wheel->free_list = tnode->next;
+    tnode->next = NULL;
+    tnode->pprev = NULL;
+    tnode->index_next = NULL;
+    return tnode;
+}
+
+static sw_inline void swTimerWheel_unlink(swTimer_node *tnode)
+{
+    if (tnode->pprev)
+    {
+        *tnode->pprev = tnode->next;
+        if (tnode->next)
+        {
+            tnode->next->pprev = tnode->pprev;
+        }
+        tnode->pprev = NULL;
+        tnode->next = NULL;
+    }
+}
+
+static sw_inline void swTimerWheel_push(swTimer_node **head, swTimer_node *tnode)
+{
+    tnode->next = *head;
+    if (*head)
+    {
+        (*head)->pprev = &tnode->next;
+    }
+    *head = tnode;
+    tnode->pprev = head;
+}
+
+static void swTimerWheel_release(swTimerWheel *wheel, swTimer_node *tnode)
+{
+    swTimerWheel_unlink(tnode);
+    tnode->next = wheel->free_list;
+    wheel->free_list = tnode;
+}
+
+static void swTimerWheel_link(swTimerWheel *wheel, swTimer_node *tnode)
+{
+    int64_t expires = tnode->exec_msec;
+    int64_t span = expires - wheel->current;
+    uint32_t i;
+
+    if (span < SW_TIMER_WHEEL_ROOT_SIZE)
+    {
+        //expired nodes go to the slot being processed
+        i = (span < 0 ? wheel->current : expires) & SW_TIMER_WHEEL_ROOT_MASK;
+        wheel->root_bitmap[i >> 6] |= 1ULL << (i & 63);
+        swTimerWheel_push(&wheel->root[i], tnode);
+        return;
+    }
+    if (span > SW_TIMER_WHEEL_MAX_SPAN)
+    {
+        //re-linked to the top level again after cascading
+        span = SW_TIMER_WHEEL_MAX_SPAN;
+        expires = wheel->current + span;
+    }
+    int level;
+    for (level = 0; level < SW_TIMER_WHEEL_LEVEL_NUM - 1; level++)
+    {
+        if (span < (1LL << SW_TIMER_WHEEL_LEVEL_SHIFT(level + 1)))
+        {
+            break;
+        }
+    }
+    i = (expires >> SW_TIMER_WHEEL_LEVEL_SHIFT(level)) & SW_TIMER_WHEEL_LEVEL_MASK;
+    wheel->level_bitmap[level] |= 1ULL << i;
+    swTimerWheel_push(&wheel->levels[level][i], tnode);
+}
+
+static uint32_t swTimerWheel_cascade(swTimerWheel *wheel, int level)
+{
+    uint32_t i = (wheel->current >> SW_TIMER_WHEEL_LEVEL_SHIFT(level)) & SW_TIMER_WHEEL_LEVEL_MASK;
+    swTimer_node *tnode = wheel->levels[level][i], *next;
+
+    wheel->levels[level][i] = NULL;
+    wheel->level_bitmap[level] &= ~(1ULL << i);
+    for (; tnode; tnode = next)
+    {
+        next = tnode->next;
+        tnode->pprev = NULL;
+        swTimerWheel_link(wheel, tnode);
+    }
+    return i;
+}
+
+static int swTimerWheel_index_add(swTimerWheel *wheel, swTimer_node *tnode, uint32_t num)
+{
+    uint32_t i;
+    if (unlikely(num > wheel->index_size))
+    {
+        uint32_t size = wheel->index_size * 2;
+        swTimer_node **index = sw_calloc(size, sizeof(swTimer_node *));
+        if (!index)
+        {
+            swSysError("calloc(%ld) failed.", size * sizeof(swTimer_node *));
+            return SW_ERR;
+        }
+        swTimer_node *node, *next;
+        for (i = 0; i < wheel->index_size; i++)
+        {
+            for (node = wheel->index[i]; node; node = next)
+            {
+                next = node->index_next;
+                node->index_next = index[node->id & (size - 1)];
+                index[node->id & (size - 1)] = node;
+            }
+        }
+        sw_free(wheel->index);
+        wheel->index = index;
+        wheel->index_size = size;
+    }
+    i = tnode->id & (wheel->index_size - 1);
+    tnode->index_next = wheel->index[i];
+    wheel->index[i] = tnode;
+    return SW_OK;
+}
+
+static void swTimerWheel_index_del(swTimerWheel *wheel, swTimer_node *tnode)
+{
+    swTimer_node **pp = &wheel->index[tnode->id & (wheel->index_size - 1)];
+    while (*pp)
+    {
+        if (*pp == tnode)
+        {
+            *pp = tnode->index_next;
+            tnode->index_next = NULL;
+            return;
+        }
+        pp = &(*pp)->index_next;
+    }
+}
+
+/**
+ * find the first hinted bit in [start, n), clearing stale hints on the way
+ */
+static int swTimerWheel_next_slot(uint64_t *bitmap, swTimer_node **slots, int start, int n)
+{
+    int i = start;
+    while (i < n)
+    {
+        uint64_t word = bitmap[i >> 6] >> (i & 63);
+        if (word == 0)
+        {
+            i = (i | 63) + 1;
+            continue;
+        }
+        i += __builtin_ctzll(word);
+        if (slots[i])
+        {
+            return i;
+        }
+        bitmap[i >> 6] &= ~(1ULL << (i & 63));
+        i++;
+    }
+    return -1;
+}
+
+/**
+ * the earliest tick at which the wheel has work to do: a root slot to run or a level to cascade
+ */
+static int64_t swTimerWheel_next_tick(swTimerWheel *wheel)
+{
+    int64_t current = wheel->current;
+    int64_t next_tick = -1;
+    int i, index, level;
+
+    index = current & SW_TIMER_WHEEL_ROOT_MASK;
+    if ((i = swTimerWheel_next_slot(wheel->root_bitmap, wheel->root, index, SW_TIMER_WHEEL_ROOT_SIZE)) >= 0)
+    {
+        return current - index + i;
+    }
+    if ((i = swTimerWheel_next_slot(wheel->root_bitmap, wheel->root, 0, index)) >= 0)
+    {
+        next_tick = current - index + SW_TIMER_WHEEL_ROOT_SIZE + i;
+    }
+
+    for (level = 0; level < SW_TIMER_WHEEL_LEVEL_NUM; level++)
+    {
+        int shift = SW_TIMER_WHEEL_LEVEL_SHIFT(level);
+        int64_t base = (current + (1LL << shift) - 1) >> shift;
+        index = base & SW_TIMER_WHEEL_LEVEL_MASK;
+        if ((i = swTimerWheel_next_slot(&wheel->level_bitmap[level], wheel->levels[level], index, SW_TIMER_WHEEL_LEVEL_SIZE)) < 0
+                && (i = swTimerWheel_next_slot(&wheel->level_bitmap[level], wheel->levels[level], 0, index)) < 0)
+        {
+            continue;
+        }
+        int64_t tick = (base + ((i - index) & SW_TIMER_WHEEL_LEVEL_MASK)) << shift;
+        if (next_tick < 0 || tick < next_tick)
+        {
+            next_tick = tick;
+        }
+    }
+    return next_tick;
+}
+
+static int swTimerWheel_select(swTimer *timer, int64_t now_msec)
+{
+    swTimerWheel *wheel = timer->wheel;
+    swTimer_node *pending, *deferred = NULL, *tnode;
+    uint32_t index;
+    int i, level;
+
+    swTraceLog(SW_TRACE_TIMER, "timer msec=%" PRId64 ", round=%" PRId64, now_msec, timer->round);
+    if (timer->num == 0 && wheel->current < now_msec)
+    {
+        wheel->current = now_msec;
+    }
+
+    while (wheel->current <= now_msec)
+    {
+        index = wheel->current & SW_TIMER_WHEEL_ROOT_MASK;
+        if (index == 0)
+        {
+            for (level = 0; level < SW_TIMER_WHEEL_LEVEL_NUM; level++)
+            {
+                if (swTimerWheel_cascade(wheel, level) != 0)
+                {
+                    break;
+                }
+            }
+        }
+        if (wheel->root[index] == NULL)
+        {
+            //jump to the next non-empty slot or the next cascade
+            wheel->root_bitmap[index >> 6] &= ~(1ULL << (index & 63));
+            i = swTimerWheel_next_slot(wheel->root_bitmap, wheel->root, index, SW_TIMER_WHEEL_ROOT_SIZE);
+            int64_t next_tick = wheel->current - index + (i < 0 ? SW_TIMER_WHEEL_ROOT_SIZE : i);
+            wheel->current = next_tick > now_msec + 1 ? now_msec + 1 : next_tick;
+            continue;
+        }
+
+        pending = wheel->root[index];
+        pending->pprev = &pending;
+        wheel->root[index] = NULL;
+        wheel->root_bitmap[index >> 6] &= ~(1ULL << (index & 63));
+        wheel->current++;
+
+        while ((tnode = pending))
+        {
+            swTimerWheel_unlink(tnode);
+            //added in this round, run it next time
+            if (tnode->round == timer->round)
+            {
+                swTimerWheel_push(&deferred, tnode);
+                continue;
+            }
+
+            timer->_current_id = tnode->id;
+            if (!tnode->remove)
+            {
+                swTraceLog(SW_TRACE_TIMER, "id=%ld, exec_msec=%" PRId64 ", round=%" PRIu64 ", exist=%u", tnode->id, tnode->exec_msec, tnode->round, timer->num - 1);
+                tnode->callback(timer, tnode);
+            }
+            timer->_current_id = -1;
+
+            //persistent timer
+            if (tnode->interval > 0 && !tnode->remove)
+            {
+                while (tnode->exec_msec <= now_msec)
+                {
+                    tnode->exec_msec += tnode->interval;
+                }
+                swTimerWheel_link(wheel, tnode);
+                continue;
+            }
+
+            timer->num--;
+            swTimerWheel_index_del(wheel, tnode);
+            swTimerWheel_release(wheel, tnode);
+        }
+    }
+
+    while ((tnode = deferred))
+    {
+        swTimerWheel_unlink(tnode);
+        swTimerWheel_link(wheel, tnode);
+    }
+
+    if (timer->num == 0)
+    {
+        timer->_next_msec = -1;
+        timer->set(timer, -1);
+    }
+    else
+    {
+        long next_msec = swTimerWheel_next_tick(wheel) - now_msec;
+        if (next_msec <= 0)
+        {
+            next_msec = 1;
+        }
+        timer->_next_msec = next_msec;
+        timer->set(timer, next_msec);
+    }
+    timer->round++;
+    return SW_OK;
+}
@@ -35,6 +35,10 @@ void swWorker_free(swWorker *worker)
     {
         sw_shm_free(worker->send_shm);
     }
+    if (worker->dispatch_shm)
+    {
+        worker->dispatch_shm->destroy(worker->dispatch_shm);
+    }
 }
 
 void swWorker_signal_init(void)
@@ -405,6 +409,17 @@ int swWorker_onTask(swFactory *factory, swEventData *task)
         break;
     }
 
+    //give the package back to the ring of the reactor thread
+    if (task->info.type == SW_EVENT_PACKAGE)
+    {
+        swString package;
+        memcpy(&package, task->data, sizeof(package));
+        sw_spinlock(&worker->dispatch_lock);
+        worker->dispatch_shm->free(worker->dispatch_shm, package.str);
+        worker->dispatch_shm_num--;
+        sw_spinlock_release(&worker->dispatch_lock);
+    }
+
     //worker idle
     worker->status = SW_WORKER_IDLE;
 
@@ -619,6 +634,12 @@ void swWorker_try_to_exit()
     {
         swAio_free();
     }
+#ifdef SW_USE_IOURING
+    if (SwooleAIO.iouring_init && SwooleAIO.task_num == 0)
+    {
+        swAio_iouring_free();
+    }
+#endif
 
     swDNSResolver_free();
 
@@ -800,7 +821,14 @@ static int swWorker_onPipeReceive(swReactor *reactor, swEvent *event)
 
     if (read(event->fd, &task, sizeof(task)) > 0)
     {
+        SwooleWG.request_pending = swEventData_is_request(task.info.type);
         ret = swWorker_onTask(factory, &task);
+        //done with the request dispatched by the reactor thread, unless its coroutine still runs
+        if (SwooleWG.request_pending)
+        {
+            SwooleWG.request_pending = 0;
+            sw_atomic_fetch_sub(&SwooleWG.worker->inflight_num, 1);
+        }
 #ifndef SW_WORKER_RECV_AGAIN
         /**
          * Big package
@@ -22,6 +22,10 @@
 #include <assert.h>
 #include <stddef.h>
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
 static const char *method_strings[] =
 {
     "DELETE", "GET", "HEAD", "POST", "PUT", "PATCH", "CONNECT", "OPTIONS", "TRACE", "COPY", "LOCK", "MKCOL", "MOVE",
@@ -249,11 +253,156 @@ void swHttpRequest_free(swConnection *conn)
 }
 
 /**
- * simple get headers info
+ * the first "\r\n\r\n" in [p, pe), 16 positions are matched at once
+ */
+static sw_inline char* swHttp_find_header_end(char *p, char *pe)
+{
+#ifdef __SSE2__
+    const __m128i cr = _mm_set1_epi8('\r');
+    const __m128i lf = _mm_set1_epi8('\n');
+    //the last load reads p[18]
+    for (; pe - p >= 16 + 3; p += 16)
+    {
+        __m128i m1 = _mm_and_si128(_mm_cmpeq_epi8(_mm_loadu_si128((__m128i *) p), cr),
+                _mm_cmpeq_epi8(_mm_loadu_si128((__m128i *) (p + 1)), lf));
+        __m128i m2 = _mm_and_si128(_mm_cmpeq_epi8(_mm_loadu_si128((__m128i *) (p + 2)), cr),
+                _mm_cmpeq_epi8(_mm_loadu_si128((__m128i *) (p + 3)), lf));
+        int mask = _mm_movemask_epi8(_mm_and_si128(m1, m2));
+        if (mask)
+        {
+            return p + __builtin_ctz(mask);
+        }
+    }
+#endif
+    for (; pe - p >= 4; p++)
+    {
+        if (*p == '\r' && memcmp(p, "\r\n\r\n", 4) == 0)
+        {
+            return p;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * the start of the line after [p], or [pe]
+ */
+static sw_inline char* swHttp_next_line(char *p, char *pe)
+{
+#ifdef __SSE2__
+    const __m128i lf = _mm_set1_epi8('\n');
+    for (; pe - p >= 16; p += 16)
+    {
+        int mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((__m128i *) p), lf));
+        if (mask)
+        {
+            return p + __builtin_ctz(mask) + 1;
+        }
+    }
+#endif
+    char *lf_p = memchr(p, '\n', pe - p);
+    return lf_p ? lf_p + 1 : pe;
+}
+
+static sw_inline char* swHttp_header_value(char *p, size_t name_length)
+{
+    p += name_length;
+    //skip space
+    if (*p == ' ')
+    {
+        p++;
+    }
+    return p;
+}
+
+static sw_inline char* swHttp_skip_space(char *p, char *pe)
+{
+    while (p < pe && (*p == ' ' || *p == '\t'))
+    {
+        p++;
+    }
+    return p;
+}
+
+/**
+ * "0", "0.", "0.0" ... "0.000"
+ */
+static sw_inline int swHttp_qvalue_is_zero(char *p, char *pe)
+{
+    if (p >= pe || *p != '0')
+    {
+        return SW_FALSE;
+    }
+    p++;
+    if (p < pe && *p == '.')
+    {
+        p++;
+        while (p < pe && *p == '0')
+        {
+            p++;
+        }
+    }
+    return !(p < pe && isdigit((unsigned char) *p));
+}
+
+/**
+ * the codings of the comma separated tokens, compared as whole tokens, "gzip;q=0" is refused
+ */
+static uint8_t swHttp_get_accept_encoding(char *p, char *pe)
+{
+    uint8_t accept = 0;
+    char *token_end, *coding, *param;
+    size_t coding_len;
+    int refused;
+
+    for (; p < pe; p = token_end + 1)
+    {
+        token_end = memchr(p, ',', pe - p);
+        if (token_end == NULL)
+        {
+            token_end = pe;
+        }
+        coding = swHttp_skip_space(p, token_end);
+        for (param = coding; param < token_end && *param != ';' && *param != ' ' && *param != '\t'; param++);
+        coding_len = param - coding;
+
+        refused = 0;
+        while ((param = memchr(param, ';', token_end - param)) != NULL)
+        {
+            param = swHttp_skip_space(param + 1, token_end);
+            if (token_end - param >= 2 && (param[0] | 0x20) == 'q' && param[1] == '=')
+            {
+                refused = swHttp_qvalue_is_zero(param + 2, token_end);
+            }
+        }
+        if (refused)
+        {
+            continue;
+        }
+        if (coding_len == sizeof("gzip") - 1 && strncasecmp(coding, SW_STRL("gzip")) == 0)
+        {
+            accept |= SW_HTTP_ACCEPT_GZIP;
+        }
+        else if (coding_len == sizeof("br") - 1 && strncasecmp(coding, SW_STRL("br")) == 0)
+        {
+            accept |= SW_HTTP_ACCEPT_BR;
+        }
+    }
+    return accept;
+}
+
+/**
+ * pick the fields the reactor needs in one pass over the header, the result is kept for the next recv
  * @return content-length exist
  */
 int swHttpRequest_get_header_info(swHttpRequest *request)
 {
+    //called again only while a request without Content-Length is incomplete
+    if (request->header_parsed)
+    {
+        return SW_ERR;
+    }
+
     swString *buffer = request->buffer;
     // header field start
     char *buf = buffer->str + buffer->offset;
@@ -264,103 +413,85 @@ int swHttpRequest_get_header_info(swHttpRequest *request)
     uint8_t got_len = 0;
 
     *(pe) = '\0';
-    for (p = buf + 1; p < pe; p++)
+    for (p = swHttp_next_line(buf, pe); p < pe; p = swHttp_next_line(p, pe))
     {
-        if (*p == '\n' && *(p-1) == '\r')
+        //only look at the lines that may hold one of the fields
+        switch (*p | 0x20)
         {
-            p++;
+        case 'c':
             if (strncasecmp(p, SW_STRL("Content-Length:")) == 0)
             {
-                // strlen("Content-Length:")
-                p += (sizeof("Content-Length:") - 1);
-                // skip one space
-                if (*p == ' ')
-                {
-                    p++;
-                }
+                p = swHttp_header_value(p, sizeof("Content-Length:") - 1);
                 request->content_length = atoi(p);
                 got_len = 1;
             }
             else if (strncasecmp(p, SW_STRL("Connection:")) == 0)
             {
-                // strlen("Connection:")
-                p += (sizeof("Connection:") - 1);
-                //skip space
-                if (*p == ' ')
-                {
-                    p++;
-                }
+                p = swHttp_header_value(p, sizeof("Connection:") - 1);
                 if (strncasecmp(p, SW_STRL("keep-alive")) == 0)
                 {
                     request->keep_alive = 1;
                 }
             }
+            break;
+        case 'a':
+            if (strncasecmp(p, SW_STRL("Accept-Encoding:")) == 0)
+            {
+                p += (sizeof("Accept-Encoding:") - 1);
+                char *eol = strchr(p, '\r');
+                request->accept_encoding |= swHttp_get_accept_encoding(p, eol ? eol : pe);
+            }
+            break;
+        case 'e':
+            if (strncasecmp(p, SW_STRL("Expect:")) == 0)
+            {
+                p = swHttp_header_value(p, sizeof("Expect:") - 1);
+                if (strncasecmp(p, SW_STRL("100-continue")) == 0)
+                {
+                    request->expect_continue = 1;
+                }
+            }
+            break;
+        default:
+            break;
         }
     }
     *(pe) = '\r';
+    request->header_parsed = 1;
 
     return got_len ? SW_OK: SW_ERR;
 }
 
 #ifdef SW_HTTP_100_CONTINUE
+/**
+ * found by swHttpRequest_get_header_info()
+ */
 int swHttpRequest_has_expect_header(swHttpRequest *request)
 {
-    swString *buffer = request->buffer;
-    //char *buf = buffer->str + buffer->offset;
-    char *buf = buffer->str;
-    //int len = buffer->length - buffer->offset;
-    int len = buffer->length;
-
-    char *pe = buf + len;
-    char *p;
-
-    for (p = buf; p < pe; p++)
-    {
-        if (*p == '\r' && pe - p > sizeof("\r\nExpect"))
-        {
-            p += 2;
-            if (strncasecmp(p, SW_STRL("Expect")) == 0)
-            {
-                p += sizeof("Expect: ") - 1;
-                if (strncasecmp(p, SW_STRL("100-continue")) == 0)
-                {
-                    return 1;
-                }
-                else
-                {
-                    return 0;
-                }
-            }
-            else
-            {
-                p++;
-            }
-        }
-    }
-    return 0;
+    return request->expect_continue;
 }
 #endif
 
 /**
- * header-length
+ * header-length, the scan goes on from where the last recv stopped
  */
 int swHttpRequest_get_header_length(swHttpRequest *request)
 {
     swString *buffer = request->buffer;
-    char *buf = buffer->str + buffer->offset;
-    int len = buffer->length - buffer->offset;
-
-    char *pe = buf + len;
-    char *p;
+    char *buf = buffer->str + MAX(buffer->offset, request->header_scan_offset);
+    char *pe = buffer->str + buffer->length;
 
-    for (p = buf; p < pe; p++)
+    char *p = swHttp_find_header_end(buf, pe);
+    if (p)
     {
-        if (*p == '\r' && p + 4 <= pe && memcmp(p, "\r\n\r\n", 4) == 0)
-        {
-            //strlen(header) + strlen("\r\n\r\n")
-            request->header_length = p - buffer->str + 4;
-            return SW_OK;
-        }
+        //strlen(header) + strlen("\r\n\r\n")
+        request->header_length = p - buffer->str + 4;
+        return SW_OK;
+    }
+    //the terminator may be split by the next recv
+    if (buffer->length > 3)
+    {
+        request->header_scan_offset = buffer->length - 3;
     }
     return SW_ERR;
 }
@@ -19,6 +19,10 @@
 #include "websocket.h"
 #include "connection.h"
 
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
 /*  The following is websocket data frame:
  +-+-+-+-+-------+-+-------------+-------------------------------+
  0                   1                   2                   3   |
@@ -92,6 +96,95 @@ ssize_t swWebSocket_get_package_length(swProtocol *protocol, swConnection *conn,
     return header_length + payload_length;
 }
 
+static void swWebSocket_mask_scalar(char *data, size_t length, char *mask_key)
+{
+    size_t i = 0;
+    uint64_t mask64;
+    uint32_t mask32;
+
+    memcpy(&mask32, mask_key, SW_WEBSOCKET_MASK_LEN);
+    mask64 = ((uint64_t) mask32 << 32) | mask32;
+    for (; i + sizeof(mask64) <= length; i += sizeof(mask64))
+    {
+        uint64_t chunk;
+        memcpy(&chunk, data + i, sizeof(chunk));
+        chunk ^= mask64;
+        memcpy(data + i, &chunk, sizeof(chunk));
+    }
+    for (; i < length; i++)
+    {
+        data[i] ^= mask_key[i % SW_WEBSOCKET_MASK_LEN];
+    }
+}
+
+#ifdef __SSE2__
+static void swWebSocket_mask_sse2(char *data, size_t length, char *mask_key)
+{
+    size_t i = 0;
+    int32_t mask32;
+
+    memcpy(&mask32, mask_key, SW_WEBSOCKET_MASK_LEN);
+    __m128i mask128 = _mm_set1_epi32(mask32);
+    for (; i + sizeof(mask128) <= length; i += sizeof(mask128))
+    {
+        __m128i chunk = _mm_loadu_si128((__m128i *) (data + i));
+        _mm_storeu_si128((__m128i *) (data + i), _mm_xor_si128(chunk, mask128));
+    }
+    //the vector width is a multiple of the mask length, so the tail starts at mask_key[0]
+    swWebSocket_mask_scalar(data + i, length - i, mask_key);
+}
+#endif
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#define SW_WEBSOCKET_MASK_AVX2 1
+__attribute__((target("avx2")))
+static void swWebSocket_mask_avx2(char *data, size_t length, char *mask_key)
+{
+    size_t i = 0;
+    int32_t mask32;
+
+    memcpy(&mask32, mask_key, SW_WEBSOCKET_MASK_LEN);
+    __m256i mask256 = _mm256_set1_epi32(mask32);
+    for (; i + sizeof(mask256) * 2 <= length; i += sizeof(mask256) * 2)
+    {
+        __m256i chunk1 = _mm256_loadu_si256((__m256i *) (data + i));
+        __m256i chunk2 = _mm256_loadu_si256((__m256i *) (data + i + sizeof(mask256)));
+        _mm256_storeu_si256((__m256i *) (data + i), _mm256_xor_si256(chunk1, mask256));
+        _mm256_storeu_si256((__m256i *) (data + i + sizeof(mask256)), _mm256_xor_si256(chunk2, mask256));
+    }
+    //leave the upper halves clean, otherwise every legacy SSE instruction after us pays the transition penalty
+    _mm256_zeroupper();
+    swWebSocket_mask_sse2(data + i, length - i, mask_key);
+}
+#endif
+
+static void (*swWebSocket_mask_impl)(char *data, size_t length, char *mask_key) = NULL;
+
+/**
+ * XOR the payload with the 4 bytes masking key, the kernel is picked once by the cpu features
+ */
+void swWebSocket_mask(char *data, size_t length, char *mask_key)
+{
+    if (unlikely(swWebSocket_mask_impl == NULL))
+    {
+#ifdef SW_WEBSOCKET_MASK_AVX2
+        if (__builtin_cpu_supports("avx2"))
+        {
+            swWebSocket_mask_impl = swWebSocket_mask_avx2;
+        }
+        else
+#endif
+        {
+#ifdef __SSE2__
+            swWebSocket_mask_impl = swWebSocket_mask_sse2;
+#else
+            swWebSocket_mask_impl = swWebSocket_mask_scalar;
+#endif
+        }
+    }
+    swWebSocket_mask_impl(data, length, mask_key);
+}
+
 void swWebSocket_encode(swString *buffer, char *data, size_t length, char opcode, uint8_t finish, uint8_t mask)
 {
     int pos = 0;
@@ -139,13 +232,7 @@ void swWebSocket_encode(swString *buffer, char *data, size_t length, char opcode
             size_t offset = buffer->length;
             // Warn: buffer may be extended, string pointer will change
             swString_append_ptr(buffer, data, length);
-            char *_data = buffer->str + offset;
-
-            int i;
-            for (i = 0; i < length; i++)
-            {
-                _data[i] ^= _mask_data[i % SW_WEBSOCKET_MASK_LEN];
-            }
+            swWebSocket_mask(buffer->str + offset, length, _mask_data);
         }
         else
         {
@@ -181,12 +268,7 @@ void swWebSocket_decode(swWebSocket_frame *frame, swString *data)
         char *mask_key = frame->mask_key;
         memcpy(mask_key, data->str + header_length, SW_WEBSOCKET_MASK_LEN);
         header_length += SW_WEBSOCKET_MASK_LEN;
-        buf = data->str + header_length;
-        int i;
-        for (i = 0; i < payload_length; i++)
-        {
-            buf[i] ^= mask_key[i % SW_WEBSOCKET_MASK_LEN];
-        }
+        swWebSocket_mask(data->str + header_length, payload_length, mask_key);
     }
     frame->payload_length = payload_length;
     frame->header_length = header_length;
@@ -114,6 +114,11 @@ int swReactor_empty(swReactor *reactor)
     {
         event_num--;
     }
+    //io_uring
+    if (SwooleAIO.iouring_init && SwooleAIO.task_num == 0)
+    {
+        event_num--;
+    }
     //signalfd
     if (swReactor_handle_isset(reactor, SW_FD_SIGNAL) && reactor->signal_listener_num == 0)
     {
@@ -879,6 +879,7 @@ PHP_MINIT_FUNCTION(swoole)
     swoole_mmap_init(module_number);
     swoole_channel_init(module_number);
     swoole_channel_coro_init(module_number);
+    swoole_connection_pool_coro_init(module_number);
     swoole_ringqueue_init(module_number);
     swoole_msgqueue_init(module_number);
 #ifdef SW_USE_HTTP2
@@ -1068,6 +1069,9 @@ PHP_RSHUTDOWN_FUNCTION(swoole)
     {
         swAio_free();
     }
+#ifdef SW_USE_IOURING
+    swAio_iouring_free();
+#endif
 
     SwooleWG.reactor_wait_onexit = 0;
     SWOOLE_G(req_status) = PHP_SWOOLE_RSHUTDOWN_END;
@@ -104,6 +104,7 @@ void swoole_async_init(int module_number)
     bzero(&SwooleAIO, sizeof(SwooleAIO));
     SwooleAIO.min_thread_count = SW_AIO_THREAD_MIN_NUM;
     SwooleAIO.max_thread_count = SW_AIO_THREAD_MAX_NUM;
+    SwooleAIO.use_iouring = 1;
 }
 
 static void php_swoole_dns_callback(char *domain, swDNSResolver_result *result, void *data)
@@ -921,6 +922,10 @@ PHP_FUNCTION(swoole_async_set)
     {
         SwooleAIO.max_thread_count = zval_get_long(v);
     }
+    if (php_swoole_array_get_value(vht, "use_iouring", v))
+    {
+        SwooleAIO.use_iouring = zval_is_true(v);
+    }
     if (php_swoole_array_get_value(vht, "display_errors", v))
     {
         SWOOLE_G(display_errors) = zval_is_true(v);
@@ -942,6 +947,17 @@ PHP_FUNCTION(swoole_async_set)
     {
         SwooleG.use_async_resolver = zval_is_true(v);
     }
+    if (php_swoole_array_get_value(vht, "use_timer_wheel", v))
+    {
+        if (SwooleG.timer.initialized)
+        {
+            swoole_php_fatal_error(E_WARNING, "timer has already been initialized, unable to change the timer backend.");
+        }
+        else
+        {
+            SwooleG.use_timer_wheel = zval_is_true(v);
+        }
+    }
     if (php_swoole_array_get_value(vht, "enable_coroutine", v))
     {
         SwooleG.enable_coroutine = zval_is_true(v);
@@ -75,6 +75,9 @@
 #define SW_BUFFER_SIZE_STD         8192
 #define SW_BUFFER_SIZE_BIG         65536
 #define SW_BUFFER_SIZE_UDP         65536
+#define SW_UDP_RECV_BATCH          16     //datagrams read by one recvmmsg()
+#define SW_UDP_SEND_BATCH          64     //datagrams written by one sendmmsg()
+#define SW_UDP_SEND_BUFFER_SIZE    (SW_BUFFER_SIZE_UDP * 4)
 // #define SW_BUFFER_RECV_TIME
 
 #define SW_SENDFILE_CHUNK_SIZE     65536
@@ -83,6 +86,9 @@
 #define SW_HASHMAP_KEY_MAXLEN      256
 #define SW_HASHMAP_INIT_BUCKET_N   32  // hashmap bucket num (default value for init)
 
+#define SW_TIMER_WHEEL_POOL_BLOCK  1024 // timer nodes allocated at once by the timer wheel
+#define SW_TIMER_WHEEL_INDEX_INIT  1024 // timer wheel id index bucket num (default value for init)
+
 #define SW_DATA_EOF                "\r\n\r\n"
 #define SW_DATA_EOF_MAXLEN         8
 
@@ -92,6 +98,8 @@
 #define SW_AIO_THREAD_MAX_NUM            1024
 #define SW_AIO_MAX_FILESIZE              (4*1024*1024)
 #define SW_AIO_EVENT_NUM                 128
+#define SW_AIO_QUEUE_SIZE                4096 // must be a power of 2
+#define SW_AIO_IOURING_ENTRIES           256
 #define SW_AIO_DEFAULT_CHUNK_SIZE        65536
 #define SW_AIO_MAX_CHUNK_SIZE            (1*1024*1024)
 #define SW_AIO_MAX_EVENTS                128
@@ -135,6 +143,7 @@
  * ringbuffer memory pool size
  */
 #define SW_BUFFER_OUTPUT_SIZE            (2*1024*1024)
+#define SW_PIPE_BACKLOG_CHECK_INTERVAL   10 // ms, a reactor thread looks if the workers its paused connections wait for have drained
 #define SW_BUFFER_INPUT_SIZE             (2*1024*1024)
 #define SW_BUFFER_MIN_SIZE               65536
 
@@ -160,12 +169,19 @@
 
 #define SW_TASK_TMP_FILE                 "/tmp/swoole.task.XXXXXX"
 #define SW_TASK_TMPDIR_SIZE              128
+#define SW_TASK_SHM_SIZE                 (16 * 1024 * 1024) // shared arena of the large task payloads, the tmpfile is the fallback
+#define SW_TASK_SHM_SLOT_SIZE            65536
+#define SW_TASK_STEAL_INTERVAL           10 // ms, an idle task worker looks for the tasks of the busy ones
 
 #define SW_FILE_CHUNK_SIZE               65536
 
 #define SW_TABLE_CONFLICT_PROPORTION     0.2 // 20%
 #define SW_TABLE_KEY_SIZE                64
 #define SW_TABLE_USE_SPINLOCK            1
+#define SW_TABLE_READ_RETRY              64 // optimistic read attempts before taking the row lock
+#define SW_TABLE_READ_PROBE_MAX          64 // longest probe an optimistic read can verify, longer ones take the row lock
+#define SW_TABLE_RESIZE_THRESHOLD        0.75 // open addressing table doubles once this share of size is used
+#define SW_TABLE_MIGRATE_BATCH           16 // old slots every writer migrates while resizing
 
 #define SW_SSL_BUFFER_SIZE               16384
 #define SW_SSL_CIPHER_LIST               "EECDH+AESGCM:EDH+AESGCM:AES256+EECDH:AES256+EDH"
@@ -200,12 +216,19 @@
 #define SW_HTTP_HEADER_KEY_SIZE          128
 #define SW_HTTP_HEADER_VALUE_SIZE        4096
 #define SW_HTTP_HEADER_BUFFER_SIZE       128
+#define SW_HTTP_REQUEST_HEADER_NUM       32        //headers of a request recorded without allocation
 #define SW_HTTP_UPLOAD_TMPDIR_SIZE       256
 #define SW_HTTP_DATE_FORMAT              "D, d M Y H:i:s T"
 #define SW_HTTP_RFC1123_DATE_GMT         "%a, %d %b %Y %T GMT"
 #define SW_HTTP_RFC1123_DATE_UTC         "%a, %d %b %Y %T UTC"
 #define SW_HTTP_RFC850_DATE              "%A, %d-%b-%y %T GMT"
 #define SW_HTTP_ASCTIME_DATE             "%a %b %e %T %Y"
+#define SW_HTTP_STATIC_CACHE_NUM         1024      //files cached by each reactor
+#define SW_HTTP_STATIC_CACHE_FILE_SIZE   65536     //larger files are sent with sendfile
+#define SW_HTTP_STATIC_CACHE_MEMORY_SIZE (16 * 1024 * 1024)
+#define SW_HTTP_STATIC_CACHE_REVALIDATE  1         //seconds between two stat() of a cached file
+#define SW_HTTP_COMPRESSION_CACHE_NUM    1024      //bodies kept compressed by each worker
+#define SW_HTTP_COMPRESSION_CACHE_MAX_SIZE (1024 * 1024)
 // #define SW_HTTP_100_CONTINUE
 
 /**
@@ -236,6 +259,7 @@
 #define SW_MYSQL_DEFAULT_PORT            3306
 #define SW_MYSQL_CONNECT_TIMEOUT         1.0
 #define SW_MYSQL_DEFAULT_CHARSET         33  // 0x21, utf8_general_ci
+#define SW_MYSQL_STREAM_BATCH_SIZE       256 // rows decoded ahead of fetch() when streaming
 
 /**
  * Redis Client
@@ -253,6 +277,11 @@
 #define SW_DEFAULT_C_STACK_SIZE          (2 *1024 * 1024)
 #define SW_MAX_CORO_NUM_LIMIT            9223372036854775807LL
 #define SW_MAX_CORO_NESTING_LEVEL        128
+#define SW_CORO_STACK_GUARD_PAGES        1
+#define SW_CORO_STACK_POOL_SIZE          8192 // idle stacks kept by each thread
+#define SW_CORO_STACK_POOL_TRIM_INTERVAL 1000 // msec, the pages of stacks idle for that long are released
+#define SW_CORO_CONNECTION_POOL_SIZE     64
+#define SW_CORO_CONNECTION_POOL_IDLE_TIME 60 // sec, idle connections above min_size are closed after that
 
 #define SW_CORO_SWAP_BAILOUT
 // #define SW_CORO_ZEND_TRY
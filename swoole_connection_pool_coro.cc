@@ -0,0 +1,522 @@
+/*
+ +----------------------------------------------------------------------+
+ | Swoole                                                               |
+ +----------------------------------------------------------------------+
+ | This source file is subject to version 2.0 of the Apache license,    |
+ | that is bundled with this package in the file LICENSE, and is        |
+ | available through the world-wide-web at the following url:           |
+ | http://www.apache.org/licenses/LICENSE-2.0.html                      |
+ | If you did not receive a copy of the Apache2.0 license and are unable|
+ | to obtain it through the world-wide-web, please send a note to       |
+ | license@swoole.com so we can mail you a copy immediately.            |
+ +----------------------------------------------------------------------+
+ | Author: Tianfeng Han  <mikan.tenny@gmail.com>                        |
+ +----------------------------------------------------------------------+
+ */
+
+#include "php_swoole.h"
+
+#ifdef SW_COROUTINE
+#include "swoole_coroutine.h"
+#include "channel.h"
+#include "socket.h"
+
+using namespace swoole;
+
+static zend_class_entry swoole_connection_pool_coro_ce;
+static zend_class_entry *swoole_connection_pool_coro_ce_ptr;
+static zend_object_handlers swoole_connection_pool_coro_handlers;
+
+/**
+ * an idle connection, the one with an undefined object is a free slot handed to a waiter,
+ * who has to create the connection by itself
+ */
+typedef struct
+{
+    zval object;
+    double last_used;
+} connection_pool_item;
+
+typedef struct
+{
+    Channel *idle;
+    zval constructor;
+    zend_fcall_info_cache fci_cache;
+    uint32_t size;
+    uint32_t min_size;
+    //connections created and not destroyed yet, borrowed ones included
+    uint32_t num;
+    double idle_time;
+    double wait_timeout;
+    bool check_liveness;
+    bool closed;
+    swTimer_node *reaper;
+    uint64_t created_num;
+    uint64_t reaped_num;
+    uint64_t broken_num;
+    uint64_t timeout_num;
+    zend_object std;
+} connection_pool_coro;
+
+static PHP_METHOD(swoole_connection_pool_coro, __construct);
+static PHP_METHOD(swoole_connection_pool_coro, set);
+static PHP_METHOD(swoole_connection_pool_coro, get);
+static PHP_METHOD(swoole_connection_pool_coro, put);
+static PHP_METHOD(swoole_connection_pool_coro, fill);
+static PHP_METHOD(swoole_connection_pool_coro, close);
+static PHP_METHOD(swoole_connection_pool_coro, stats);
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_swoole_connection_pool_coro_construct, 0, 0, 1)
+    ZEND_ARG_INFO(0, constructor)
+    ZEND_ARG_INFO(0, size)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_swoole_connection_pool_coro_set, 0, 0, 1)
+    ZEND_ARG_ARRAY_INFO(0, settings, 0)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_swoole_connection_pool_coro_get, 0, 0, 0)
+    ZEND_ARG_INFO(0, timeout)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_swoole_connection_pool_coro_put, 0, 0, 1)
+    ZEND_ARG_INFO(0, connection)
+ZEND_END_ARG_INFO()
+
+ZEND_BEGIN_ARG_INFO_EX(arginfo_swoole_void, 0, 0, 0)
+ZEND_END_ARG_INFO()
+
+static const zend_function_entry swoole_connection_pool_coro_methods[] =
+{
+    PHP_ME(swoole_connection_pool_coro, __construct, arginfo_swoole_connection_pool_coro_construct, ZEND_ACC_PUBLIC)
+    PHP_ME(swoole_connection_pool_coro, set, arginfo_swoole_connection_pool_coro_set, ZEND_ACC_PUBLIC)
+    PHP_ME(swoole_connection_pool_coro, get, arginfo_swoole_connection_pool_coro_get, ZEND_ACC_PUBLIC)
+    PHP_ME(swoole_connection_pool_coro, put, arginfo_swoole_connection_pool_coro_put, ZEND_ACC_PUBLIC)
+    PHP_ME(swoole_connection_pool_coro, fill, arginfo_swoole_void, ZEND_ACC_PUBLIC)
+    PHP_ME(swoole_connection_pool_coro, close, arginfo_swoole_void, ZEND_ACC_PUBLIC)
+    PHP_ME(swoole_connection_pool_coro, stats, arginfo_swoole_void, ZEND_ACC_PUBLIC)
+    PHP_FE_END
+};
+
+static sw_inline connection_pool_coro* swoole_connection_pool_coro_fetch_object(zend_object *obj)
+{
+    return (connection_pool_coro *) ((char *) obj - swoole_connection_pool_coro_handlers.offset);
+}
+
+static sw_inline connection_pool_coro* swoole_get_connection_pool(zval *zobject)
+{
+    connection_pool_coro *pool = swoole_connection_pool_coro_fetch_object(Z_OBJ_P(zobject));
+    if (UNEXPECTED(!pool->idle))
+    {
+        swoole_php_fatal_error(E_ERROR, "you must call ConnectionPool constructor first.");
+    }
+    return pool;
+}
+
+/**
+ * the coroutine clients keep the fd open after the peer is gone, tell it before lending the connection,
+ * the objects of the other classes are trusted
+ */
+static bool connection_pool_is_alive(zval *zobject)
+{
+    int fd;
+    if (!php_swoole_redis_coro_get_fd(zobject, &fd) && !php_swoole_mysql_coro_get_fd(zobject, &fd)
+#ifdef SW_USE_POSTGRESQL
+            && !php_swoole_postgresql_coro_get_fd(zobject, &fd)
+#endif
+    )
+    {
+        return true;
+    }
+    if (fd < 0)
+    {
+        return false;
+    }
+    swConnection *conn = swReactor_get(SwooleG.main_reactor, fd);
+    if (conn && conn->fdtype == SW_FD_CORO_SOCKET && conn->object)
+    {
+        return ((Socket *) conn->object)->check_liveness();
+    }
+    //mysql and postgresql are driven by the reactor directly
+    char buf;
+    ssize_t n = recv(fd, &buf, sizeof(buf), MSG_PEEK | MSG_DONTWAIT);
+    return !(n == 0 || (n < 0 && swConnection_error(errno) != SW_WAIT));
+}
+
+static void connection_pool_item_free(connection_pool_item *item)
+{
+    zval_ptr_dtor(&item->object);
+    efree(item);
+}
+
+static void connection_pool_reap(swTimer *timer, swTimer_node *tnode);
+
+/**
+ * the timer is armed only while there are connections to reap,
+ * so a pool at its minimum size never keeps the event loop alive
+ */
+static void connection_pool_arm_reaper(connection_pool_coro *pool)
+{
+    if (pool->reaper || pool->closed || pool->idle_time <= 0 || pool->num <= pool->min_size || pool->idle->is_empty())
+    {
+        return;
+    }
+    long msec = (long) (pool->idle_time * 1000);
+    pool->reaper = swTimer_add(&SwooleG.timer, msec > 0 ? msec : 1, 0, pool, connection_pool_reap);
+}
+
+/**
+ * the idle queue is FIFO, rotate it once and keep the connections used within idle_time
+ */
+static void connection_pool_reap(swTimer *timer, swTimer_node *tnode)
+{
+    connection_pool_coro *pool = (connection_pool_coro *) tnode->data;
+    pool->reaper = NULL;
+
+    double now = swoole_microtime();
+    size_t n = pool->idle->length();
+    for (size_t i = 0; i < n; i++)
+    {
+        connection_pool_item *item = (connection_pool_item *) pool->idle->pop_data();
+        if (pool->num > pool->min_size && now - item->last_used >= pool->idle_time)
+        {
+            connection_pool_item_free(item);
+            pool->num--;
+            pool->reaped_num++;
+        }
+        else
+        {
+            pool->idle->push(item);
+        }
+    }
+    connection_pool_arm_reaper(pool);
+}
+
+static bool connection_pool_create(connection_pool_coro *pool, zval *retval)
+{
+    if (sw_call_user_function_fast_ex(NULL, &pool->fci_cache, retval, 0, NULL) == FAILURE)
+    {
+        swoole_php_fatal_error(E_WARNING, "ConnectionPool constructor handler error.");
+        return false;
+    }
+    if (UNEXPECTED(EG(exception)) || Z_TYPE_P(retval) != IS_OBJECT)
+    {
+        zval_ptr_dtor(retval);
+        return false;
+    }
+    pool->created_num++;
+    return true;
+}
+
+static void connection_pool_push(connection_pool_coro *pool, zval *zobject)
+{
+    connection_pool_item *item = (connection_pool_item *) emalloc(sizeof(connection_pool_item));
+    ZVAL_COPY(&item->object, zobject);
+    item->last_used = swoole_microtime();
+    pool->idle->push(item);
+}
+
+static void connection_pool_clear(connection_pool_coro *pool)
+{
+    while (!pool->idle->is_empty())
+    {
+        connection_pool_item *item = (connection_pool_item *) pool->idle->pop_data();
+        if (!Z_ISUNDEF(item->object))
+        {
+            pool->num--;
+        }
+        connection_pool_item_free(item);
+    }
+    if (pool->reaper)
+    {
+        swTimer_del(&SwooleG.timer, pool->reaper);
+        pool->reaper = NULL;
+    }
+}
+
+static void swoole_connection_pool_coro_free_object(zend_object *object)
+{
+    connection_pool_coro *pool = swoole_connection_pool_coro_fetch_object(object);
+    if (pool->idle)
+    {
+        connection_pool_clear(pool);
+        delete pool->idle;
+        zval_ptr_dtor(&pool->constructor);
+    }
+    zend_object_std_dtor(&pool->std);
+}
+
+static zend_object *swoole_connection_pool_coro_create_object(zend_class_entry *ce)
+{
+    connection_pool_coro *pool = (connection_pool_coro *) ecalloc(1, sizeof(connection_pool_coro) + zend_object_properties_size(ce));
+    zend_object_std_init(&pool->std, ce);
+    object_properties_init(&pool->std, ce);
+    pool->std.handlers = &swoole_connection_pool_coro_handlers;
+    return &pool->std;
+}
+
+void swoole_connection_pool_coro_init(int module_number)
+{
+    SWOOLE_INIT_CLASS_ENTRY(swoole_connection_pool_coro, "Swoole\\Coroutine\\ConnectionPool", NULL, "Co\\ConnectionPool", swoole_connection_pool_coro_methods);
+    SWOOLE_SET_CLASS_SERIALIZABLE(swoole_connection_pool_coro, zend_class_serialize_deny, zend_class_unserialize_deny);
+    SWOOLE_SET_CLASS_CLONEABLE(swoole_connection_pool_coro, zend_class_clone_deny);
+    SWOOLE_SET_CLASS_UNSET_PROPERTY_HANDLER(swoole_connection_pool_coro, zend_class_unset_property_deny);
+    SWOOLE_SET_CLASS_CUSTOM_OBJECT(swoole_connection_pool_coro, swoole_connection_pool_coro_create_object, swoole_connection_pool_coro_free_object, connection_pool_coro, std);
+
+    zend_declare_property_long(swoole_connection_pool_coro_ce_ptr, ZEND_STRL("size"), 0, ZEND_ACC_PUBLIC);
+}
+
+static PHP_METHOD(swoole_connection_pool_coro, __construct)
+{
+    zval *constructor;
+    zend_long size = SW_CORO_CONNECTION_POOL_SIZE;
+
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "z|l", &constructor, &size) == FAILURE)
+    {
+        RETURN_FALSE;
+    }
+    if (size <= 0)
+    {
+        size = 1;
+    }
+
+    connection_pool_coro *pool = swoole_connection_pool_coro_fetch_object(Z_OBJ_P(getThis()));
+    if (pool->idle)
+    {
+        swoole_php_fatal_error(E_WARNING, "the constructor can only be called once.");
+        RETURN_FALSE;
+    }
+
+    char *func_name = NULL;
+    if (!sw_zend_is_callable_ex(constructor, NULL, 0, &func_name, NULL, &pool->fci_cache, NULL))
+    {
+        swoole_php_fatal_error(E_ERROR, "function '%s' is not callable", func_name);
+        return;
+    }
+    efree(func_name);
+
+    php_swoole_check_reactor();
+
+    ZVAL_COPY(&pool->constructor, constructor);
+    pool->idle = new Channel(size);
+    pool->size = size;
+    pool->idle_time = SW_CORO_CONNECTION_POOL_IDLE_TIME;
+    pool->wait_timeout = -1;
+    pool->check_liveness = true;
+    zend_update_property_long(swoole_connection_pool_coro_ce_ptr, getThis(), ZEND_STRL("size"), size);
+}
+
+static PHP_METHOD(swoole_connection_pool_coro, set)
+{
+    zval *zset;
+    zval *v;
+
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "a", &zset) == FAILURE)
+    {
+        RETURN_FALSE;
+    }
+
+    connection_pool_coro *pool = swoole_get_connection_pool(getThis());
+    HashTable *vht = Z_ARRVAL_P(zset);
+    if (php_swoole_array_get_value(vht, "min_size", v))
+    {
+        convert_to_long(v);
+        pool->min_size = MIN(MAX(Z_LVAL_P(v), 0), (zend_long) pool->size);
+    }
+    if (php_swoole_array_get_value(vht, "idle_time", v))
+    {
+        convert_to_double(v);
+        pool->idle_time = Z_DVAL_P(v);
+    }
+    if (php_swoole_array_get_value(vht, "wait_timeout", v))
+    {
+        convert_to_double(v);
+        pool->wait_timeout = Z_DVAL_P(v);
+    }
+    if (php_swoole_array_get_value(vht, "check_liveness", v))
+    {
+        pool->check_liveness = zval_is_true(v);
+    }
+    connection_pool_arm_reaper(pool);
+    RETURN_TRUE;
+}
+
+static PHP_METHOD(swoole_connection_pool_coro, get)
+{
+    PHPCoroutine::check();
+
+    connection_pool_coro *pool = swoole_get_connection_pool(getThis());
+    double timeout = pool->wait_timeout;
+
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "|d", &timeout) == FAILURE)
+    {
+        RETURN_FALSE;
+    }
+
+    double deadline = timeout > 0 ? swoole_microtime() + timeout : -1;
+    while (!pool->closed)
+    {
+        connection_pool_item *item;
+        if (!pool->idle->is_empty())
+        {
+            item = (connection_pool_item *) pool->idle->pop_data();
+        }
+        else if (pool->num < pool->size)
+        {
+            pool->num++;
+            item = NULL;
+        }
+        else
+        {
+            if (deadline > 0)
+            {
+                timeout = deadline - swoole_microtime();
+                if (timeout <= 0)
+                {
+                    pool->timeout_num++;
+                    RETURN_FALSE;
+                }
+            }
+            item = (connection_pool_item *) pool->idle->pop(timeout);
+            if (!item)
+            {
+                if (!pool->closed)
+                {
+                    pool->timeout_num++;
+                }
+                RETURN_FALSE;
+            }
+        }
+
+        if (item && Z_ISUNDEF(item->object))
+        {
+            //the slot of a broken connection
+            efree(item);
+            item = NULL;
+        }
+        if (!item)
+        {
+            if (!connection_pool_create(pool, return_value))
+            {
+                pool->num--;
+                RETURN_FALSE;
+            }
+            if (UNEXPECTED(pool->closed))
+            {
+                pool->num--;
+                zval_ptr_dtor(return_value);
+                RETURN_FALSE;
+            }
+            return;
+        }
+
+        if (!pool->check_liveness || connection_pool_is_alive(&item->object))
+        {
+            RETVAL_ZVAL(&item->object, 0, 0);
+            efree(item);
+            return;
+        }
+        swTraceLog(SW_TRACE_COROUTINE, "drop the broken connection of the pool");
+        connection_pool_item_free(item);
+        pool->num--;
+        pool->broken_num++;
+    }
+    RETURN_FALSE;
+}
+
+/**
+ * put(null) gives back the slot of a broken connection
+ */
+static PHP_METHOD(swoole_connection_pool_coro, put)
+{
+    zval *zobject;
+
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "z!", &zobject) == FAILURE)
+    {
+        RETURN_FALSE;
+    }
+
+    connection_pool_coro *pool = swoole_get_connection_pool(getThis());
+    if (pool->idle->length() >= pool->num)
+    {
+        swoole_php_fatal_error(E_WARNING, "no connection was borrowed from the pool.");
+        RETURN_FALSE;
+    }
+    if (pool->closed)
+    {
+        pool->num--;
+        RETURN_FALSE;
+    }
+    if (!zobject || Z_TYPE_P(zobject) != IS_OBJECT)
+    {
+        pool->broken_num++;
+        if (pool->idle->consumer_num() > 0)
+        {
+            connection_pool_item *item = (connection_pool_item *) emalloc(sizeof(connection_pool_item));
+            ZVAL_UNDEF(&item->object);
+            pool->idle->push(item);
+        }
+        else
+        {
+            pool->num--;
+        }
+        RETURN_TRUE;
+    }
+    connection_pool_push(pool, zobject);
+    connection_pool_arm_reaper(pool);
+    RETURN_TRUE;
+}
+
+static PHP_METHOD(swoole_connection_pool_coro, fill)
+{
+    PHPCoroutine::check();
+
+    connection_pool_coro *pool = swoole_get_connection_pool(getThis());
+    while (!pool->closed && pool->num < pool->min_size)
+    {
+        zval zobject;
+        pool->num++;
+        if (!connection_pool_create(pool, &zobject))
+        {
+            pool->num--;
+            RETURN_FALSE;
+        }
+        if (UNEXPECTED(pool->closed))
+        {
+            pool->num--;
+            zval_ptr_dtor(&zobject);
+            RETURN_FALSE;
+        }
+        connection_pool_push(pool, &zobject);
+        zval_ptr_dtor(&zobject);
+    }
+    RETURN_BOOL(!pool->closed);
+}
+
+static PHP_METHOD(swoole_connection_pool_coro, close)
+{
+    connection_pool_coro *pool = swoole_get_connection_pool(getThis());
+    if (pool->closed)
+    {
+        RETURN_FALSE;
+    }
+    pool->closed = true;
+    connection_pool_clear(pool);
+    RETURN_BOOL(pool->idle->close());
+}
+
+static PHP_METHOD(swoole_connection_pool_coro, stats)
+{
+    connection_pool_coro *pool = swoole_get_connection_pool(getThis());
+    array_init(return_value);
+    add_assoc_long_ex(return_value, ZEND_STRL("connection_num"), pool->num);
+    add_assoc_long_ex(return_value, ZEND_STRL("idle_num"), pool->idle->length());
+    add_assoc_long_ex(return_value, ZEND_STRL("waiter_num"), pool->idle->consumer_num());
+    add_assoc_long_ex(return_value, ZEND_STRL("min_size"), pool->min_size);
+    add_assoc_long_ex(return_value, ZEND_STRL("created_num"), pool->created_num);
+    add_assoc_long_ex(return_value, ZEND_STRL("reaped_num"), pool->reaped_num);
+    add_assoc_long_ex(return_value, ZEND_STRL("broken_num"), pool->broken_num);
+    add_assoc_long_ex(return_value, ZEND_STRL("timeout_num"), pool->timeout_num);
+}
+
+#endif
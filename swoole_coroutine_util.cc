@@ -469,6 +469,10 @@ static PHP_METHOD(swoole_coroutine_util, stats)
     add_assoc_long_ex(return_value, ZEND_STRL("c_stack_size"), Coroutine::get_stack_size());
     add_assoc_long_ex(return_value, ZEND_STRL("coroutine_num"), Coroutine::count());
     add_assoc_long_ex(return_value, ZEND_STRL("coroutine_peak_num"), Coroutine::get_peak_num());
+    add_assoc_long_ex(return_value, ZEND_STRL("stack_pool_num"), StackPool::count());
+    uint64_t stack_alloc_num = StackPool::get_hit() + StackPool::get_miss();
+    add_assoc_double_ex(return_value, ZEND_STRL("stack_pool_hit_rate"),
+            stack_alloc_num ? (double) StackPool::get_hit() / stack_alloc_num : 0);
 }
 
 static PHP_METHOD(swoole_coroutine_util, getCid)
@@ -52,6 +52,55 @@ enum http_compress_method
     HTTP_COMPRESS_BR,
 };
 
+enum http_request_lazy_property
+{
+    HTTP_REQUEST_LAZY_HEADER = 1u << 0,
+    HTTP_REQUEST_LAZY_SERVER = 1u << 1,
+    HTTP_REQUEST_LAZY_GET    = 1u << 2,
+    HTTP_REQUEST_LAZY_COOKIE = 1u << 3,
+    HTTP_REQUEST_LAZY_POST   = 1u << 4,
+};
+
+typedef struct
+{
+    const char *name;
+    uint32_t name_len;
+    uint32_t value_len;
+    const char *value;
+} http_header_slice;
+
+/**
+ * where the request arrays come from, they are built on the first access
+ * all the pointers are in the raw request, which lives as long as the request object
+ */
+typedef struct
+{
+    uint8_t pending;
+    uint16_t socket_type;
+    int version;
+    enum swoole_http_method method;
+
+    const char *path;
+    uint32_t path_len;
+    uint32_t query_len;
+    const char *query;
+    const char *cookie;
+    uint32_t cookie_len;
+    uint32_t post_len;
+    const char *post;
+
+    uint32_t header_num;
+    uint32_t header_size;
+    http_header_slice *headers;
+    http_header_slice _headers[SW_HTTP_REQUEST_HEADER_NUM];
+
+    time_t request_time;
+    double request_time_float;
+    time_t master_time;
+    int server_port;
+    swSocketAddress remote_addr;
+} http_request_lazy;
+
 typedef struct
 {
     enum swoole_http_method method;
@@ -66,6 +115,7 @@ typedef struct
     swString *post_buffer;
 #endif
     uint32_t post_length;
+    http_request_lazy *lazy;
 
     zval *zobject;
     zval *zserver;
@@ -168,6 +218,9 @@ z##name = ctx->class.z##name;
 #define http_strncasecmp(const_str, at, length) ((length >= sizeof(const_str)-1) &&\
         (strncasecmp(at, ZEND_STRL(const_str)) == 0))
 
+#define http_header_name_equals(const_str, at, length) ((length == sizeof(const_str)-1) &&\
+        (strncasecmp(at, ZEND_STRL(const_str)) == 0))
+
 #ifdef SW_USE_HTTP2
 /**
  * Http v2
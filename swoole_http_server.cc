@@ -36,6 +36,7 @@ extern "C"
 #include "websocket.h"
 #include "connection.h"
 #include "base64.h"
+#include "lru_cache.h"
 
 #ifdef SW_HAVE_ZLIB
 #include <zlib.h>
@@ -445,23 +446,20 @@ static int http_request_on_path(swoole_http_parser *parser, const char *at, size
     http_context *ctx = (http_context *) parser->data;
     ctx->request.path = estrndup(at, length);
     ctx->request.path_len = length;
+    ctx->request.lazy->path = at;
+    ctx->request.lazy->path_len = length;
     return 0;
 }
 
 static int http_request_on_query_string(swoole_http_parser *parser, const char *at, size_t length)
 {
     http_context *ctx = (http_context *) parser->data;
+    http_request_lazy *lazy = ctx->request.lazy;
 
-    //no need free, will free by treat_data
-    char *query = estrndup(at, length);
-    add_assoc_stringl_ex(ctx->request.zserver, ZEND_STRL("query_string"), query, length);
-
-    zval *zrequest_object = ctx->request.zobject;
-    zval *zget;
-    swoole_http_server_array_init(get, request);
-
-    //parse url params
-    sapi_module.treat_data(PARSE_STRING, query, zget);
+    //parsed on the first access of $request->get
+    lazy->query = at;
+    lazy->query_len = length;
+    lazy->pending |= HTTP_REQUEST_LAZY_GET;
 
     return 0;
 }
@@ -580,20 +578,18 @@ static int http_request_on_header_value(swoole_http_parser *parser, const char *
 {
     size_t offset = 0;
     http_context *ctx = (http_context *) parser->data;
-    zval *zrequest_object = ctx->request.zobject;
-    zval *header = ctx->request.zheader;
+    http_request_lazy *lazy = ctx->request.lazy;
+    char *header_name = ctx->current_header_name;
     size_t header_len = ctx->current_header_name_len;
-    char *header_name = zend_str_tolower_dup(ctx->current_header_name, header_len);
 
-    if (strncmp(header_name, "cookie", header_len) == 0)
+    if (http_header_name_equals("cookie", header_name, header_len))
     {
-        zval *zcookie;
-        swoole_http_server_array_init(cookie, request);
-        http_parse_cookie(zcookie, at, length);
-        efree(header_name);
+        lazy->cookie = at;
+        lazy->cookie_len = length;
+        lazy->pending |= HTTP_REQUEST_LAZY_COOKIE;
         return 0;
     }
-    else if (strncmp(header_name, "upgrade", header_len) == 0 && strncasecmp(at, "websocket", length) == 0)
+    else if (http_header_name_equals("upgrade", header_name, header_len) && strncasecmp(at, "websocket", length) == 0)
     {
         swConnection *conn = swWorker_get_connection(SwooleG.serv, ctx->fd);
         if (!conn)
@@ -609,7 +605,7 @@ static int http_request_on_header_value(swoole_http_parser *parser, const char *
     }
     else if (parser->method == PHP_HTTP_POST || parser->method == PHP_HTTP_PUT || parser->method == PHP_HTTP_DELETE || parser->method == PHP_HTTP_PATCH)
     {
-        if (strncmp(header_name, "content-type", header_len) == 0)
+        if (http_header_name_equals("content-type", header_name, header_len))
         {
             if (http_strncasecmp("application/x-www-form-urlencoded", at, length))
             {
@@ -650,15 +646,28 @@ static int http_request_on_header_value(swoole_http_parser *parser, const char *
         }
     }
 #ifdef SW_HAVE_ZLIB
-    else if (SwooleG.serv->http_compression && strncmp(header_name, "accept-encoding", header_len) == 0)
+    else if (SwooleG.serv->http_compression && http_header_name_equals("accept-encoding", header_name, header_len))
     {
         swoole_http_get_compression_method(ctx, at, length);
     }
 #endif
 
-    add_assoc_stringl_ex(header, header_name, header_len, (char *) at, length);
-
-    efree(header_name);
+    if (lazy->header_num == lazy->header_size)
+    {
+        http_header_slice *headers = (http_header_slice *) emalloc(sizeof(http_header_slice) * lazy->header_size * 2);
+        memcpy(headers, lazy->headers, sizeof(http_header_slice) * lazy->header_num);
+        if (lazy->headers != lazy->_headers)
+        {
+            efree(lazy->headers);
+        }
+        lazy->headers = headers;
+        lazy->header_size *= 2;
+    }
+    http_header_slice *header = &lazy->headers[lazy->header_num++];
+    header->name = header_name;
+    header->name_len = header_len;
+    header->value = at;
+    header->value_len = length;
 
     return 0;
 }
@@ -931,17 +940,15 @@ static int multipart_body_on_data_end(multipart_parser* p)
 static int http_request_on_body(swoole_http_parser *parser, const char *at, size_t length)
 {
     http_context *ctx = (http_context *) parser->data;
-    zval *zrequest_object = ctx->request.zobject;
-    char *body;
 
     ctx->request.post_length = length;
     if (SwooleG.serv->http_parse_post && ctx->request.post_form_urlencoded)
     {
-        zval *zpost;
-        swoole_http_server_array_init(post, request);
-        body = estrndup(at, length);
-
-        sapi_module.treat_data(PARSE_STRING, body, zpost);
+        //parsed on the first access of $request->post
+        http_request_lazy *lazy = ctx->request.lazy;
+        lazy->post = at;
+        lazy->post_len = length;
+        lazy->pending |= HTTP_REQUEST_LAZY_POST;
     }
     else if (ctx->mt_parser != NULL)
     {
@@ -990,6 +997,243 @@ static int http_request_message_complete(swoole_http_parser *parser)
     return 0;
 }
 
+/**
+ * the arrays of swoole_http_request, an array stays IS_UNDEF until it is built,
+ * so the property fetches cached by the VM fall back to the handlers below
+ */
+static const struct
+{
+    const char *name;
+    size_t length;
+    uint8_t flag;
+} http_request_lazy_properties[] =
+{
+    { ZEND_STRL("header"), HTTP_REQUEST_LAZY_HEADER },
+    { ZEND_STRL("server"), HTTP_REQUEST_LAZY_SERVER },
+    { ZEND_STRL("get"), HTTP_REQUEST_LAZY_GET },
+    { ZEND_STRL("cookie"), HTTP_REQUEST_LAZY_COOKIE },
+    { ZEND_STRL("post"), HTTP_REQUEST_LAZY_POST },
+};
+
+#define HTTP_REQUEST_LAZY_PROPERTY_NUM (sizeof(http_request_lazy_properties) / sizeof(http_request_lazy_properties[0]))
+
+static uint32_t http_request_lazy_offsets[HTTP_REQUEST_LAZY_PROPERTY_NUM];
+
+static http_request_lazy* http_request_lazy_new()
+{
+    http_request_lazy *lazy = (http_request_lazy *) emalloc(sizeof(http_request_lazy));
+    lazy->pending = HTTP_REQUEST_LAZY_HEADER | HTTP_REQUEST_LAZY_SERVER;
+    lazy->path = NULL;
+    lazy->path_len = 0;
+    lazy->query = NULL;
+    lazy->query_len = 0;
+    lazy->header_num = 0;
+    lazy->header_size = SW_HTTP_REQUEST_HEADER_NUM;
+    lazy->headers = lazy->_headers;
+    return lazy;
+}
+
+static void http_request_lazy_free(zend_object *object)
+{
+    http_request_lazy *lazy = (http_request_lazy *) swoole_get_property_by_handle(object->handle, 1);
+    if (!lazy)
+    {
+        return;
+    }
+    //the raw request is gone, the arrays never built are left null
+    for (uint32_t i = 0; i < HTTP_REQUEST_LAZY_PROPERTY_NUM; i++)
+    {
+        if (lazy->pending & http_request_lazy_properties[i].flag)
+        {
+            ZVAL_NULL(OBJ_PROP(object, http_request_lazy_offsets[i]));
+        }
+    }
+    if (lazy->headers != lazy->_headers)
+    {
+        efree(lazy->headers);
+    }
+    efree(lazy);
+    swoole_set_property_by_handle(object->handle, 1, NULL);
+}
+
+static void http_request_lazy_build(zend_object *object, http_request_lazy *lazy, uint32_t i)
+{
+    zval *zvalue = OBJ_PROP(object, http_request_lazy_offsets[i]);
+    lazy->pending &= ~http_request_lazy_properties[i].flag;
+    array_init(zvalue);
+
+    switch (http_request_lazy_properties[i].flag)
+    {
+    case HTTP_REQUEST_LAZY_HEADER:
+        for (uint32_t j = 0; j < lazy->header_num; j++)
+        {
+            http_header_slice *header = &lazy->headers[j];
+            char *header_name = zend_str_tolower_dup(header->name, header->name_len);
+            add_assoc_stringl_ex(zvalue, header_name, header->name_len, (char *) header->value, header->value_len);
+            efree(header_name);
+        }
+        break;
+    case HTTP_REQUEST_LAZY_SERVER:
+    {
+        swConnection conn;
+        conn.socket_type = lazy->socket_type;
+        conn.info = lazy->remote_addr;
+
+        if (lazy->query)
+        {
+            add_assoc_stringl_ex(zvalue, ZEND_STRL("query_string"), (char *) lazy->query, lazy->query_len);
+        }
+        add_assoc_string(zvalue, "request_method", (char * ) http_get_method_name(lazy->method));
+        add_assoc_stringl(zvalue, "request_uri", (char *) lazy->path, lazy->path_len);
+        add_assoc_stringl(zvalue, "path_info", (char *) lazy->path, lazy->path_len);
+        add_assoc_long_ex(zvalue, ZEND_STRL("request_time"), lazy->request_time);
+        add_assoc_double_ex(zvalue, ZEND_STRL("request_time_float"), lazy->request_time_float);
+        add_assoc_long(zvalue, "server_port", lazy->server_port);
+        add_assoc_long(zvalue, "remote_port", swConnection_get_port(&conn));
+        add_assoc_string(zvalue, "remote_addr", swConnection_get_ip(&conn));
+        add_assoc_long(zvalue, "master_time", lazy->master_time);
+        add_assoc_string(zvalue, "server_protocol", (char *) (lazy->version == 101 ? "HTTP/1.1" : "HTTP/1.0"));
+        break;
+    }
+    case HTTP_REQUEST_LAZY_GET:
+        //no need free, will free by treat_data
+        sapi_module.treat_data(PARSE_STRING, estrndup(lazy->query, lazy->query_len), zvalue);
+        break;
+    case HTTP_REQUEST_LAZY_COOKIE:
+        http_parse_cookie(zvalue, lazy->cookie, lazy->cookie_len);
+        break;
+    case HTTP_REQUEST_LAZY_POST:
+        sapi_module.treat_data(PARSE_STRING, estrndup(lazy->post, lazy->post_len), zvalue);
+        break;
+    default:
+        break;
+    }
+}
+
+/**
+ * @return the index of [zmember] if it is not built yet, or -1
+ */
+static sw_inline int http_request_lazy_find(zval *zobject, zval *zmember, http_request_lazy **lazy)
+{
+    *lazy = (http_request_lazy *) swoole_get_property(zobject, 1);
+    if (!*lazy || !(*lazy)->pending || Z_TYPE_P(zmember) != IS_STRING)
+    {
+        return -1;
+    }
+    for (uint32_t i = 0; i < HTTP_REQUEST_LAZY_PROPERTY_NUM; i++)
+    {
+        if (((*lazy)->pending & http_request_lazy_properties[i].flag)
+                && Z_STRLEN_P(zmember) == http_request_lazy_properties[i].length
+                && memcmp(Z_STRVAL_P(zmember), http_request_lazy_properties[i].name, Z_STRLEN_P(zmember)) == 0)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static sw_inline void http_request_lazy_fetch(zval *zobject, zval *zmember)
+{
+    http_request_lazy *lazy;
+    int i = http_request_lazy_find(zobject, zmember, &lazy);
+    if (i >= 0)
+    {
+        http_request_lazy_build(Z_OBJ_P(zobject), lazy, i);
+    }
+}
+
+static void http_request_lazy_fetch_all(zval *zobject)
+{
+    http_request_lazy *lazy = (http_request_lazy *) swoole_get_property(zobject, 1);
+    if (!lazy)
+    {
+        return;
+    }
+    for (uint32_t i = 0; lazy->pending && i < HTTP_REQUEST_LAZY_PROPERTY_NUM; i++)
+    {
+        if (lazy->pending & http_request_lazy_properties[i].flag)
+        {
+            http_request_lazy_build(Z_OBJ_P(zobject), lazy, i);
+        }
+    }
+}
+
+static zval* swoole_http_request_read_property(zval *zobject, zval *zmember, int type, void **cache_slot, zval *rv)
+{
+    http_request_lazy_fetch(zobject, zmember);
+    return std_object_handlers.read_property(zobject, zmember, type, cache_slot, rv);
+}
+
+static zval* swoole_http_request_get_property_ptr_ptr(zval *zobject, zval *zmember, int type, void **cache_slot)
+{
+    http_request_lazy_fetch(zobject, zmember);
+    return std_object_handlers.get_property_ptr_ptr(zobject, zmember, type, cache_slot);
+}
+
+static int swoole_http_request_has_property(zval *zobject, zval *zmember, int has_set_exists, void **cache_slot)
+{
+    http_request_lazy_fetch(zobject, zmember);
+    return std_object_handlers.has_property(zobject, zmember, has_set_exists, cache_slot);
+}
+
+#if PHP_VERSION_ID >= 70400
+static zval* swoole_http_request_write_property(zval *zobject, zval *zmember, zval *value, void **cache_slot)
+#else
+static void swoole_http_request_write_property(zval *zobject, zval *zmember, zval *value, void **cache_slot)
+#endif
+{
+    //overwritten before it was built
+    http_request_lazy *lazy;
+    int i = http_request_lazy_find(zobject, zmember, &lazy);
+    if (i >= 0)
+    {
+        lazy->pending &= ~http_request_lazy_properties[i].flag;
+    }
+#if PHP_VERSION_ID >= 70400
+    return std_object_handlers.write_property(zobject, zmember, value, cache_slot);
+#else
+    std_object_handlers.write_property(zobject, zmember, value, cache_slot);
+#endif
+}
+
+static HashTable* swoole_http_request_get_properties(zval *zobject)
+{
+    http_request_lazy_fetch_all(zobject);
+    return std_object_handlers.get_properties(zobject);
+}
+
+/**
+ * the default one calls get_properties() when it is overridden, the GC must not build the arrays
+ */
+static HashTable* swoole_http_request_get_gc(zval *zobject, zval **table, int *n)
+{
+    zend_object *object = Z_OBJ_P(zobject);
+    if (object->properties)
+    {
+        *table = NULL;
+        *n = 0;
+        return object->properties;
+    }
+    *table = object->properties_table;
+    *n = object->ce->default_properties_count;
+    return NULL;
+}
+
+static zend_object *swoole_http_request_create_object(zend_class_entry *ce)
+{
+    zend_object *object;
+    object = zend_objects_new(ce);
+    object->handlers = &swoole_http_request_handlers;
+    object_properties_init(object, ce);
+    return object;
+}
+
+static void swoole_http_request_free_object(zend_object *object)
+{
+    http_request_lazy_free(object);
+    zend_object_std_dtor(object);
+}
+
 int php_swoole_http_onReceive(swServer *serv, swEventData *req)
 {
     int fd = req->info.fd;
@@ -1022,9 +1266,10 @@ int php_swoole_http_onReceive(swServer *serv, swEventData *req)
 
     http_context *ctx = swoole_http_context_new(fd);
     swoole_http_parser *parser = &ctx->parser;
-    zval *zserver = ctx->request.zserver;
+    http_request_lazy *lazy = http_request_lazy_new();
 
     parser->data = ctx;
+    ctx->request.lazy = lazy;
 
     zval *zdata = sw_malloc_zval();
     php_swoole_get_recv_data(zdata, req, NULL, 0);
@@ -1041,6 +1286,7 @@ int php_swoole_http_onReceive(swServer *serv, swEventData *req)
     if (n < 0)
     {
         sw_zval_free(zdata);
+        swoole_set_property(ctx->request.zobject, 1, lazy);
         swWarn("swoole_http_parser_execute failed.");
         if (conn->websocket_status == WEBSOCKET_STATUS_CONNECTION)
         {
@@ -1053,16 +1299,14 @@ int php_swoole_http_onReceive(swServer *serv, swEventData *req)
         zval _zresponse_object = *ctx->response.zobject, *zresponse_object = &_zresponse_object;
 
         ctx->keepalive = swoole_http_should_keep_alive(parser);
-        const char *method_name = http_get_method_name(parser->method);
 
-        add_assoc_string(zserver, "request_method", (char * ) method_name);
-        add_assoc_stringl(zserver, "request_uri", ctx->request.path, ctx->request.path_len);
-        add_assoc_stringl(zserver, "path_info", ctx->request.path, ctx->request.path_len);
-        add_assoc_long_ex(zserver, ZEND_STRL("request_time"), serv->gs->now);
+        //$request->server is built on the first access
+        lazy->method = (enum swoole_http_method) parser->method;
+        lazy->version = ctx->request.version;
+        lazy->request_time = serv->gs->now;
+        lazy->request_time_float = swoole_microtime();
 
-        // Add REQUEST_TIME_FLOAT
-        double now_float = swoole_microtime();
-        add_assoc_double_ex(zserver, ZEND_STRL("request_time_float"), now_float);
+        swoole_set_property(zrequest_object, 1, lazy);
 
         swConnection *conn = swWorker_get_connection(serv, fd);
         if (!conn)
@@ -1074,11 +1318,18 @@ int php_swoole_http_onReceive(swServer *serv, swEventData *req)
 
         swoole_set_property(zrequest_object, 0, zdata);
 
-        add_assoc_long(zserver, "server_port", swConnection_get_port(&serv->connection_list[conn->from_fd]));
-        add_assoc_long(zserver, "remote_port", swConnection_get_port(conn));
-        add_assoc_string(zserver, "remote_addr", swConnection_get_ip(conn));
-        add_assoc_long(zserver, "master_time", conn->last_time);
-        add_assoc_string(zserver, "server_protocol", (char *) (ctx->request.version == 101 ? "HTTP/1.1" : "HTTP/1.0"));
+        lazy->server_port = swConnection_get_port(&serv->connection_list[conn->from_fd]);
+        lazy->socket_type = conn->socket_type;
+        lazy->remote_addr = conn->info;
+        lazy->master_time = conn->last_time;
+
+        for (uint32_t i = 0; i < HTTP_REQUEST_LAZY_PROPERTY_NUM; i++)
+        {
+            if (lazy->pending & http_request_lazy_properties[i].flag)
+            {
+                ZVAL_UNDEF(OBJ_PROP(Z_OBJ_P(zrequest_object), http_request_lazy_offsets[i]));
+            }
+        }
 
         // begin to check and call registerd callback
         zend_fcall_info_cache *fci_cache = NULL;
@@ -1168,6 +1419,13 @@ void swoole_http_server_init(int module_number)
     SWOOLE_SET_CLASS_SERIALIZABLE(swoole_http_request, zend_class_serialize_deny, zend_class_unserialize_deny);
     SWOOLE_SET_CLASS_CLONEABLE(swoole_http_request, zend_class_clone_deny);
     SWOOLE_SET_CLASS_UNSET_PROPERTY_HANDLER(swoole_http_request, zend_class_unset_property_deny);
+    SWOOLE_SET_CLASS_CREATE_AND_FREE(swoole_http_request, swoole_http_request_create_object, swoole_http_request_free_object);
+    swoole_http_request_handlers.read_property = swoole_http_request_read_property;
+    swoole_http_request_handlers.write_property = swoole_http_request_write_property;
+    swoole_http_request_handlers.get_property_ptr_ptr = swoole_http_request_get_property_ptr_ptr;
+    swoole_http_request_handlers.has_property = swoole_http_request_has_property;
+    swoole_http_request_handlers.get_properties = swoole_http_request_get_properties;
+    swoole_http_request_handlers.get_gc = swoole_http_request_get_gc;
 
     zend_declare_property_long(swoole_http_request_ce_ptr, ZEND_STRL("fd"), 0, ZEND_ACC_PUBLIC);
 #ifdef SW_USE_HTTP2
@@ -1181,6 +1439,12 @@ void swoole_http_server_init(int module_number)
     zend_declare_property_null(swoole_http_request_ce_ptr, ZEND_STRL("files"), ZEND_ACC_PUBLIC);
     zend_declare_property_null(swoole_http_request_ce_ptr, ZEND_STRL("post"), ZEND_ACC_PUBLIC);
     zend_declare_property_null(swoole_http_request_ce_ptr, ZEND_STRL("tmpfiles"), ZEND_ACC_PUBLIC);
+    for (uint32_t i = 0; i < HTTP_REQUEST_LAZY_PROPERTY_NUM; i++)
+    {
+        zend_property_info *property_info = (zend_property_info *) zend_hash_str_find_ptr(&swoole_http_request_ce_ptr->properties_info,
+                http_request_lazy_properties[i].name, http_request_lazy_properties[i].length);
+        http_request_lazy_offsets[i] = property_info->offset;
+    }
 
     SWOOLE_INIT_CLASS_ENTRY(swoole_http_response, "Swoole\\Http\\Response", "swoole_http_response", NULL, swoole_http_response_methods);
     SWOOLE_SET_CLASS_SERIALIZABLE(swoole_http_response, zend_class_serialize_deny, zend_class_unserialize_deny);
@@ -1223,12 +1487,6 @@ http_context* swoole_http_context_new(int fd)
     php_vmstat.new_http_request ++;
 #endif
 
-    zval *zheader;
-    swoole_http_server_array_init(header, request);
-
-    zval *zserver;
-    swoole_http_server_array_init(server, request);
-
     ctx->fd = fd;
 
     return ctx;
@@ -1461,6 +1719,7 @@ static PHP_METHOD(swoole_http_request, __destruct)
         }
         SW_HASHTABLE_FOREACH_END();
     }
+    http_request_lazy_free(Z_OBJ_P(getThis()));
     zval *zdata = (zval *) swoole_get_property(getThis(), 0);
     if (zdata)
     {
@@ -1789,7 +2048,7 @@ const char* swoole_http_get_content_encoding(http_context *ctx)
     }
 }
 
-int swoole_http_response_compress(swString *body, int method, int level)
+static int http_response_compress(swString *body, int method, int level)
 {
     int encoding;
     //gzip: 0x1f
@@ -1899,6 +2158,73 @@ int swoole_http_response_compress(swString *body, int method, int level)
     }
     return SW_ERR;
 }
+
+/**
+ * compressed bodies of the worker, the key is only remembered the first time a body is seen,
+ * the body and its compressed form are kept from the second time on
+ */
+static LRUCache *http_compression_cache = nullptr;
+
+struct http_compression_cache_entry
+{
+    std::string body;
+    std::string encoded;
+};
+
+int swoole_http_response_compress(swString *body, int method, int level)
+{
+    swServer *serv = SwooleG.serv;
+    if (serv == NULL || serv->http_compression_cache == 0 || body->length > SW_HTTP_COMPRESSION_CACHE_MAX_SIZE)
+    {
+        return http_response_compress(body, method, level);
+    }
+    if (http_compression_cache == nullptr)
+    {
+        http_compression_cache = new LRUCache(serv->http_compression_cache);
+    }
+
+    struct
+    {
+        zend_ulong hash;
+        uint32_t length;
+        int8_t method;
+        int8_t level;
+    } key;
+    bzero(&key, sizeof(key));
+    key.hash = zend_inline_hash_func(body->str, body->length);
+    key.length = body->length;
+    key.method = method;
+    key.level = level;
+    std::string cache_key((char *) &key, sizeof(key));
+
+    auto entry = std::static_pointer_cast<http_compression_cache_entry>(http_compression_cache->get(cache_key));
+    if (entry && entry->body.length() == body->length && memcmp(entry->body.data(), body->str, body->length) == 0)
+    {
+        size_t length = entry->encoded.length();
+        if (length > swoole_zlib_buffer->size && swString_extend(swoole_zlib_buffer, length) < 0)
+        {
+            return SW_ERR;
+        }
+        memcpy(swoole_zlib_buffer->str, entry->encoded.data(), length);
+        swoole_zlib_buffer->length = length;
+        return SW_OK;
+    }
+
+    if (http_response_compress(body, method, level) != SW_OK)
+    {
+        return SW_ERR;
+    }
+    if (entry == nullptr)
+    {
+        http_compression_cache->set(cache_key, std::make_shared<http_compression_cache_entry>());
+    }
+    else
+    {
+        entry->body.assign(body->str, body->length);
+        entry->encoded.assign(swoole_zlib_buffer->str, swoole_zlib_buffer->length);
+    }
+    return SW_OK;
+}
 #endif
 
 static PHP_METHOD(swoole_http_response, initHeader)
@@ -42,6 +42,12 @@ class http2_stream
         ctx = swoole_http_context_new(_fd);
         ctx->stream = (void *) this;
         stream_id = _stream_id;
+
+        zval *zrequest_object = ctx->request.zobject;
+        zval *zheader;
+        swoole_http_server_array_init(header, request);
+        zval *zserver;
+        swoole_http_server_array_init(server, request);
         send_window = SW_HTTP2_DEFAULT_WINDOW_SIZE;
         recv_window = SW_HTTP2_DEFAULT_WINDOW_SIZE;
     }
@@ -1740,6 +1740,13 @@ static sw_inline int mysql_read_rows(mysql_client *client)
     //RecordSet parse
     while (n_buf > 0)
     {
+#ifdef SW_COROUTINE
+        // the rest is decoded after the rows are fetched
+        if (client->streaming && zend_hash_num_elements(Z_ARRVAL_P(client->response.result_array)) >= client->connector.stream_batch)
+        {
+            return SW_AGAIN;
+        }
+#endif
         // Ensure that we've received the complete packet
         if (mysql_ensure_packet(p, n_buf) == SW_ERR)
         {
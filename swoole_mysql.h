@@ -258,6 +258,8 @@ typedef struct
     char *database;
     zend_bool strict_type;
     zend_bool fetch_mode;
+    uint32_t stream_batch; /* rows decoded ahead of fetch() at most, 0 to buffer the whole result set */
+    uint32_t statement_cache_size; /* prepared statements kept per connection, 0 to disable the cache */
 
     size_t host_len;
     size_t user_len;
@@ -364,6 +366,17 @@ typedef struct _mysql_client
     mysql_io_status iowait;
     zval *result;
     long cid;
+    /* the rows of the result set are handed out by fetch() as they arrive */
+    zend_bool streaming;
+    zend_bool stream_eof;
+    zend_bool stream_error;
+    zend_bool stream_paused;
+    zend_ulong stream_offset;
+    zval *stream_result;
+    mysql_statement *stream_statement;
+    zval _stream_statement;
+    /* the statements prepared on this connection, keyed by the sql */
+    struct _mysql_statement_cache *statement_cache;
 #endif
     uint8_t state;
     uint32_t switch_check :1; /* check if server request auth switch */
@@ -21,14 +21,25 @@
 #ifdef SW_COROUTINE
 #include "swoole_coroutine.h"
 #include "swoole_mysql.h"
+#include "lru_cache.h"
 
 using namespace swoole;
 
+struct _mysql_statement_cache
+{
+    LRUCache statements; /* sql => the Statement object */
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+
+    explicit _mysql_statement_cache(size_t capacity) : statements(capacity) { }
+};
+
 static PHP_METHOD(swoole_mysql_coro, __construct);
 static PHP_METHOD(swoole_mysql_coro, __destruct);
 static PHP_METHOD(swoole_mysql_coro, connect);
 static PHP_METHOD(swoole_mysql_coro, query);
 static PHP_METHOD(swoole_mysql_coro, recv);
+static PHP_METHOD(swoole_mysql_coro, fetch);
 static PHP_METHOD(swoole_mysql_coro, nextResult);
 #ifdef SW_USE_MYSQLND
 static PHP_METHOD(swoole_mysql_coro, escape);
@@ -39,6 +50,7 @@ static PHP_METHOD(swoole_mysql_coro, rollback);
 static PHP_METHOD(swoole_mysql_coro, prepare);
 static PHP_METHOD(swoole_mysql_coro, setDefer);
 static PHP_METHOD(swoole_mysql_coro, getDefer);
+static PHP_METHOD(swoole_mysql_coro, getStatementCacheStats);
 static PHP_METHOD(swoole_mysql_coro, close);
 
 static PHP_METHOD(swoole_mysql_coro_statement, __destruct);
@@ -120,6 +132,7 @@ static const zend_function_entry swoole_mysql_coro_methods[] =
     PHP_ME(swoole_mysql_coro, connect, arginfo_swoole_mysql_coro_connect, ZEND_ACC_PUBLIC)
     PHP_ME(swoole_mysql_coro, query, arginfo_swoole_mysql_coro_query, ZEND_ACC_PUBLIC)
     PHP_ME(swoole_mysql_coro, recv, arginfo_swoole_void, ZEND_ACC_PUBLIC)
+    PHP_ME(swoole_mysql_coro, fetch, arginfo_swoole_void, ZEND_ACC_PUBLIC)
     PHP_ME(swoole_mysql_coro, nextResult, arginfo_swoole_void, ZEND_ACC_PUBLIC)
 #ifdef SW_USE_MYSQLND
     PHP_ME(swoole_mysql_coro, escape, arginfo_swoole_mysql_coro_escape, ZEND_ACC_PUBLIC)
@@ -130,6 +143,7 @@ static const zend_function_entry swoole_mysql_coro_methods[] =
     PHP_ME(swoole_mysql_coro, prepare, arginfo_swoole_mysql_coro_prepare, ZEND_ACC_PUBLIC)
     PHP_ME(swoole_mysql_coro, setDefer, arginfo_swoole_mysql_coro_setDefer, ZEND_ACC_PUBLIC)
     PHP_ME(swoole_mysql_coro, getDefer, arginfo_swoole_void, ZEND_ACC_PUBLIC)
+    PHP_ME(swoole_mysql_coro, getStatementCacheStats, arginfo_swoole_void, ZEND_ACC_PUBLIC)
     PHP_ME(swoole_mysql_coro, close, arginfo_swoole_void, ZEND_ACC_PUBLIC)
     PHP_FE_END
 };
@@ -201,6 +215,17 @@ void swoole_mysql_coro_init(int module_number)
     zend_declare_property_long(swoole_mysql_coro_statement_ce_ptr, ZEND_STRL("errno"), 0, ZEND_ACC_PUBLIC);
 }
 
+int php_swoole_mysql_coro_get_fd(zval *zobject, int *fd)
+{
+    if (!instanceof_function(Z_OBJCE_P(zobject), swoole_mysql_coro_ce_ptr))
+    {
+        return SW_FALSE;
+    }
+    mysql_client *client = (mysql_client *) swoole_get_object(zobject);
+    *fd = client && client->cli && client->connected ? client->fd : -1;
+    return SW_TRUE;
+}
+
 int mysql_query(zval *zobject, mysql_client *client, swString *sql, zval *callback);
 
 static int swoole_mysql_coro_execute(zval *zobject, mysql_client *client, zval *params)
@@ -378,6 +403,10 @@ static int swoole_mysql_coro_parse_response(mysql_client *client, zval **result,
             client->response.l_server_msg = strlen(errmsg);
             if (client->response.result_array)
             {
+                if (client->response.result_array == client->stream_result)
+                {
+                    client->stream_result = nullptr;
+                }
                 sw_zval_free(client->response.result_array);
                 client->response.result_array = nullptr;
             }
@@ -477,7 +506,7 @@ static int swoole_mysql_coro_parse_response(mysql_client *client, zval **result,
     // ResultSet
     else
     {
-        if (client->connector.fetch_mode && client->cmd == SW_MYSQL_COM_STMT_EXECUTE)
+        if (!client->streaming && client->connector.fetch_mode && client->cmd == SW_MYSQL_COM_STMT_EXECUTE)
         {
             if (client->statement->result)
             {
@@ -517,6 +546,221 @@ static void swoole_mysql_coro_parse_end(mysql_client *client, swString *buffer)
     client->cmd = SW_MYSQL_COM_NULL;
 }
 
+static void swoole_mysql_coro_stream_free(mysql_client *client)
+{
+    if (client->stream_result)
+    {
+        if (client->stream_result == client->response.result_array)
+        {
+            client->response.result_array = NULL;
+        }
+        sw_zval_free(client->stream_result);
+        client->stream_result = NULL;
+    }
+    if (client->stream_paused && client->cli)
+    {
+        SwooleG.main_reactor->set(SwooleG.main_reactor, client->fd, PHP_SWOOLE_FD_MYSQL_CORO | SW_EVENT_READ);
+    }
+    client->streaming = 0;
+    client->stream_eof = 0;
+    client->stream_error = 0;
+    client->stream_paused = 0;
+    client->stream_offset = 0;
+    if (client->stream_statement)
+    {
+        client->stream_statement = NULL;
+        zval_ptr_dtor(&client->_stream_statement);
+    }
+}
+
+static sw_inline bool swoole_mysql_coro_stream_busy(mysql_client *client)
+{
+    if (client->streaming)
+    {
+        swoole_php_fatal_error(E_WARNING, "the rows of the last result set are not fetched yet.");
+        return true;
+    }
+    return false;
+}
+
+static void swoole_mysql_coro_stream_resume(mysql_client *client, zval *result)
+{
+    zval *retval = NULL;
+    client->suspending = 0;
+    client->iowait = SW_MYSQL_CORO_STATUS_READY;
+    client->cid = 0;
+    php_coro_context *context = (php_coro_context *) swoole_get_property(client->object, 0);
+    int ret = PHPCoroutine::resume_m(context, result, retval);
+    if (ret == SW_CORO_ERR_END && retval)
+    {
+        zval_ptr_dtor(retval);
+    }
+}
+
+/**
+ * decode what has been received of a streamed result set, query() returns once the columns are known,
+ * fetch() is woken up by the rows, the socket is not read while stream_batch rows wait for fetch()
+ */
+static void swoole_mysql_coro_stream_parse(mysql_client *client)
+{
+    swString *buffer = MYSQL_RESPONSE_BUFFER;
+    bool started = client->stream_result != NULL;
+    zval *result = NULL;
+
+    if (swoole_mysql_coro_parse_response(client, &result, 0) == SW_AGAIN)
+    {
+        if (!client->response.result_array)
+        {
+            return;
+        }
+        if (!started)
+        {
+            client->stream_result = client->response.result_array;
+        }
+        if (!client->stream_paused && zend_hash_num_elements(Z_ARRVAL_P(client->stream_result)) >= client->connector.stream_batch)
+        {
+            SwooleG.main_reactor->set(SwooleG.main_reactor, client->fd, PHP_SWOOLE_FD_MYSQL_CORO);
+            client->stream_paused = 1;
+        }
+        if (!client->cid)
+        {
+            return;
+        }
+        if (!started)
+        {
+            zval ztrue;
+            ZVAL_TRUE(&ztrue);
+            swoole_mysql_coro_stream_resume(client, &ztrue);
+        }
+        else if (zend_hash_num_elements(Z_ARRVAL_P(client->stream_result)) > 0)
+        {
+            swoole_mysql_coro_stream_resume(client, NULL);
+        }
+        return;
+    }
+
+    swoole_mysql_coro_parse_end(client, buffer);
+    if (client->stream_paused)
+    {
+        SwooleG.main_reactor->set(SwooleG.main_reactor, client->fd, PHP_SWOOLE_FD_MYSQL_CORO | SW_EVENT_READ);
+        client->stream_paused = 0;
+    }
+    if (Z_TYPE_P(result) == IS_ARRAY)
+    {
+        // the whole result set has arrived
+        client->stream_result = result;
+        client->stream_eof = 1;
+        if (started)
+        {
+            result = NULL;
+        }
+        else
+        {
+            result = sw_malloc_zval();
+            ZVAL_TRUE(result);
+        }
+    }
+    else if (started)
+    {
+        // an error packet ends the rows
+        client->stream_eof = 1;
+        client->stream_error = 1;
+        sw_zval_free(result);
+        result = NULL;
+    }
+    else
+    {
+        // not a result set
+        swoole_mysql_coro_stream_free(client);
+    }
+
+    if (client->cid)
+    {
+        swoole_mysql_coro_stream_resume(client, result);
+    }
+    if (result)
+    {
+        sw_zval_free(result);
+    }
+}
+
+/**
+ * drop the decoded packets, the buffer of a streamed result set stays at the size of a batch
+ */
+static sw_inline void swoole_mysql_coro_stream_compact(swString *buffer)
+{
+    if (buffer->offset > 0)
+    {
+        buffer->length -= buffer->offset;
+        memmove(buffer->str, buffer->str + buffer->offset, buffer->length);
+        buffer->offset = 0;
+    }
+}
+
+static void swoole_mysql_coro_stream_fetch(mysql_client *client, zval *return_value)
+{
+    while (1)
+    {
+        zval *rows = client->stream_result;
+        if (rows && zend_hash_num_elements(Z_ARRVAL_P(rows)) > 0)
+        {
+            zval *row = zend_hash_index_find(Z_ARRVAL_P(rows), client->stream_offset);
+            ZVAL_COPY(return_value, row);
+            zend_hash_index_del(Z_ARRVAL_P(rows), client->stream_offset);
+            client->stream_offset++;
+            if (zend_hash_num_elements(Z_ARRVAL_P(rows)) == 0)
+            {
+                // reuse the buckets for the next batch
+                zend_hash_clean(Z_ARRVAL_P(rows));
+                client->stream_offset = 0;
+            }
+            return;
+        }
+        if (client->stream_eof)
+        {
+            bool error = client->stream_error;
+            swoole_mysql_coro_stream_free(client);
+            if (error)
+            {
+                RETURN_FALSE;
+            }
+            RETURN_NULL();
+        }
+
+        // the rows received already come first
+        swString *buffer = MYSQL_RESPONSE_BUFFER;
+        off_t offset = buffer->offset;
+        if ((size_t) offset < buffer->length)
+        {
+            swoole_mysql_coro_stream_parse(client);
+            if (client->stream_eof || buffer->offset != offset)
+            {
+                continue;
+            }
+        }
+        if (client->stream_paused)
+        {
+            swoole_mysql_coro_stream_compact(buffer);
+            SwooleG.main_reactor->set(SwooleG.main_reactor, client->fd, PHP_SWOOLE_FD_MYSQL_CORO | SW_EVENT_READ);
+            client->stream_paused = 0;
+        }
+
+        php_coro_context *context = (php_coro_context *) swoole_get_property(client->object, 0);
+        if (PHPCoroutine::socket_timeout > 0)
+        {
+            client->timer = swTimer_add(&SwooleG.timer, (long) (PHPCoroutine::socket_timeout * 1000), 0, context, swoole_mysql_coro_onTimeout);
+        }
+        client->suspending = 1;
+        client->cid = PHPCoroutine::get_cid();
+        PHPCoroutine::yield_m(return_value, context);
+        if (!client->streaming)
+        {
+            // closed or timed out
+            return;
+        }
+    }
+}
+
 static int swoole_mysql_coro_statement_free(mysql_statement *stmt)
 {
     if (stmt->object)
@@ -564,6 +808,46 @@ static int swoole_mysql_coro_statement_close(mysql_statement *stmt)
     return SW_OK;
 }
 
+/**
+ * a statement is reused as long as it is attached to the connection,
+ * the ones freed by close() are prepared again on the next use after reconnecting
+ */
+static bool swoole_mysql_coro_statement_cache_get(mysql_client *client, swString *sql, zval *return_value)
+{
+    _mysql_statement_cache *cache = client->statement_cache;
+    if (!cache)
+    {
+        cache = client->statement_cache = new _mysql_statement_cache(client->connector.statement_cache_size);
+    }
+    std::string key(sql->str, sql->length);
+    zval *statement = (zval *) cache->statements.get(key).get();
+    if (statement && swoole_get_object(statement))
+    {
+        cache->hits++;
+        RETVAL_ZVAL(statement, 1, 0);
+        return true;
+    }
+    cache->misses++;
+    return false;
+}
+
+static void swoole_mysql_coro_statement_cache_set(mysql_client *client, swString *sql, zval *statement)
+{
+    zval *value = sw_zval_dup(statement);
+    Z_TRY_ADDREF_P(value);
+    // the evicted statement is closed once the last reference to it is gone
+    client->statement_cache->statements.set(std::string(sql->str, sql->length), std::shared_ptr<void>(value, sw_zval_free));
+}
+
+static void swoole_mysql_coro_statement_cache_free(mysql_client *client)
+{
+    if (client->statement_cache)
+    {
+        delete client->statement_cache;
+        client->statement_cache = NULL;
+    }
+}
+
 static int swoole_mysql_coro_close(zval *zobject)
 {
     mysql_client *client = (mysql_client *) swoole_get_object(zobject);
@@ -591,6 +875,7 @@ static int swoole_mysql_coro_close(zval *zobject)
         client->connected = 0;
     }
 
+    swoole_mysql_coro_stream_free(client);
     zend_update_property_bool(swoole_mysql_coro_ce_ptr, zobject, ZEND_STRL("connected"), 0);
     SwooleG.main_reactor->del(SwooleG.main_reactor, client->fd);
 
@@ -637,6 +922,11 @@ static PHP_METHOD(swoole_mysql_coro, __construct)
 
 static PHP_METHOD(swoole_mysql_coro, __destruct)
 {
+    mysql_client *client = (mysql_client *) swoole_get_object(getThis());
+    if (client)
+    {
+        swoole_mysql_coro_statement_cache_free(client);
+    }
 }
 
 static PHP_METHOD(swoole_mysql_coro, connect)
@@ -753,6 +1043,20 @@ static PHP_METHOD(swoole_mysql_coro, connect)
         connector->fetch_mode = zval_is_true(value);
     }
 
+    if (php_swoole_array_get_value(_ht, "stream", value) && zval_is_true(value))
+    {
+        connector->stream_batch = SW_MYSQL_STREAM_BATCH_SIZE;
+        if (php_swoole_array_get_value(_ht, "stream_batch", value))
+        {
+            connector->stream_batch = MAX(zval_get_long(value), 1);
+        }
+    }
+
+    if (php_swoole_array_get_value(_ht, "statement_cache", value))
+    {
+        connector->statement_cache_size = MAX(zval_get_long(value), 0);
+    }
+
     swClient *cli = (swClient *) emalloc(sizeof(swClient));
     int type = SW_SOCK_TCP;
 
@@ -870,6 +1174,11 @@ static PHP_METHOD(swoole_mysql_coro, query)
 
     PHPCoroutine::check_bind("mysql client", client->cid);
 
+    if (swoole_mysql_coro_stream_busy(client))
+    {
+        RETURN_FALSE;
+    }
+
     double timeout = PHPCoroutine::socket_timeout;
 
     if (zend_parse_parameters(ZEND_NUM_ARGS(), "s|d", &sql.str, &sql.length, &timeout) == FAILURE)
@@ -903,11 +1212,23 @@ static PHP_METHOD(swoole_mysql_coro, query)
         client->iowait = SW_MYSQL_CORO_STATUS_WAIT;
         RETURN_TRUE;
     }
+    client->streaming = client->connector.stream_batch > 0;
     client->suspending = 1;
     client->cid = PHPCoroutine::get_cid();
     PHPCoroutine::yield_m(return_value, context);
 }
 
+static PHP_METHOD(swoole_mysql_coro, fetch)
+{
+    mysql_client *client = (mysql_client *) swoole_get_object(getThis());
+    if (!client || !client->streaming || client->stream_statement)
+    {
+        RETURN_FALSE;
+    }
+    PHPCoroutine::check_bind("mysql client", client->cid);
+    swoole_mysql_coro_stream_fetch(client, return_value);
+}
+
 static PHP_METHOD(swoole_mysql_coro, nextResult)
 {
     mysql_client *client = (mysql_client *) swoole_get_object(getThis());
@@ -965,6 +1286,11 @@ static void swoole_mysql_coro_query_transcation(const char* command, uint8_t in_
         RETURN_FALSE;
     }
 
+    if (swoole_mysql_coro_stream_busy(client))
+    {
+        RETURN_FALSE;
+    }
+
     if (in_transaction && client->transaction)
     {
         zend_throw_exception(swoole_mysql_coro_exception_ce_ptr, "There is already an active transaction.", 21);
@@ -1029,6 +1355,16 @@ static PHP_METHOD(swoole_mysql_coro, getDefer)
     RETURN_BOOL(client->defer);
 }
 
+static PHP_METHOD(swoole_mysql_coro, getStatementCacheStats)
+{
+    mysql_client *client = (mysql_client *) swoole_get_object(getThis());
+    _mysql_statement_cache *cache = client ? client->statement_cache : NULL;
+    array_init(return_value);
+    add_assoc_long(return_value, "capacity", client ? client->connector.statement_cache_size : 0);
+    add_assoc_long(return_value, "hits", cache ? cache->hits : 0);
+    add_assoc_long(return_value, "misses", cache ? cache->misses : 0);
+}
+
 static PHP_METHOD(swoole_mysql_coro, setDefer)
 {
     zend_bool defer = 1;
@@ -1102,6 +1438,11 @@ static PHP_METHOD(swoole_mysql_coro, prepare)
 
     PHPCoroutine::check_bind("mysql client", client->cid);
 
+    if (swoole_mysql_coro_stream_busy(client))
+    {
+        RETURN_FALSE;
+    }
+
     double timeout = PHPCoroutine::socket_timeout;
 
     if (zend_parse_parameters(ZEND_NUM_ARGS(), "s|d", &sql.str, &sql.length, &timeout) == FAILURE)
@@ -1114,6 +1455,12 @@ static PHP_METHOD(swoole_mysql_coro, prepare)
         RETURN_FALSE;
     }
 
+    bool use_cache = client->connector.statement_cache_size > 0 && !client->defer;
+    if (use_cache && swoole_mysql_coro_statement_cache_get(client, &sql, return_value))
+    {
+        return;
+    }
+
     if (client->buffer)
     {
         swString_clear(client->buffer);
@@ -1154,6 +1501,11 @@ static PHP_METHOD(swoole_mysql_coro, prepare)
     client->suspending = 1;
     client->cid = PHPCoroutine::get_cid();
     PHPCoroutine::yield_m(return_value, context);
+
+    if (use_cache && Z_TYPE_P(return_value) == IS_OBJECT && client->statement_cache)
+    {
+        swoole_mysql_coro_statement_cache_set(client, &sql, return_value);
+    }
 }
 
 static PHP_METHOD(swoole_mysql_coro_statement, execute)
@@ -1180,6 +1532,11 @@ static PHP_METHOD(swoole_mysql_coro_statement, execute)
         RETURN_FALSE;
     }
 
+    if (swoole_mysql_coro_stream_busy(client))
+    {
+        RETURN_FALSE;
+    }
+
     if (stmt->buffer)
     {
         swString_clear(stmt->buffer);
@@ -1204,6 +1561,13 @@ static PHP_METHOD(swoole_mysql_coro_statement, execute)
         client->iowait = SW_MYSQL_CORO_STATUS_WAIT;
         RETURN_TRUE;
     }
+    if (client->connector.stream_batch > 0)
+    {
+        // the statement is kept until its rows are fetched
+        client->streaming = 1;
+        client->stream_statement = stmt;
+        ZVAL_COPY(&client->_stream_statement, getThis());
+    }
     client->suspending = 1;
     client->cid = PHPCoroutine::get_cid();
     PHPCoroutine::yield_m(return_value, context);
@@ -1217,6 +1581,13 @@ static PHP_METHOD(swoole_mysql_coro_statement, fetch)
         RETURN_FALSE;
     }
 
+    if (stmt->client->streaming && stmt->client->stream_statement == stmt)
+    {
+        PHPCoroutine::check_bind("mysql client", stmt->client->cid);
+        swoole_mysql_coro_stream_fetch(stmt->client, return_value);
+        return;
+    }
+
     if (!stmt->client->connector.fetch_mode)
     {
         RETURN_FALSE;
@@ -1271,6 +1642,30 @@ static PHP_METHOD(swoole_mysql_coro_statement, fetchAll)
         RETURN_FALSE;
     }
 
+    if (stmt->client->streaming && stmt->client->stream_statement == stmt)
+    {
+        mysql_client *client = stmt->client;
+        PHPCoroutine::check_bind("mysql client", client->cid);
+        array_init(return_value);
+        while (1)
+        {
+            zval row;
+            ZVAL_NULL(&row);
+            swoole_mysql_coro_stream_fetch(client, &row);
+            if (Z_TYPE(row) != IS_ARRAY)
+            {
+                if (Z_TYPE(row) == IS_FALSE)
+                {
+                    zval_ptr_dtor(return_value);
+                    RETURN_FALSE;
+                }
+                break;
+            }
+            add_next_index_zval(return_value, &row);
+        }
+        return;
+    }
+
     if (!stmt->client->connector.fetch_mode)
     {
         RETURN_FALSE;
@@ -1424,6 +1819,7 @@ static void swoole_mysql_coro_free_object(zend_object *object)
         {
             swString_free(client->buffer);
         }
+        swoole_mysql_coro_statement_cache_free(client);
         efree(client);
         swoole_set_object_by_handle(handle, NULL);
     }
@@ -1800,6 +2196,15 @@ static int swoole_mysql_coro_onRead(swReactor *reactor, swEvent *event)
 
     while(1)
     {
+        if (client->streaming && buffer->length == buffer->size)
+        {
+            swoole_mysql_coro_stream_compact(buffer);
+            if (buffer->length == buffer->size && swString_extend(buffer, buffer->size * 2) < 0)
+            {
+                swoole_php_fatal_error(E_ERROR, "malloc failed.");
+                reactor->del(SwooleG.main_reactor, event->fd);
+            }
+        }
         ret = recv(sock, buffer->str + buffer->length, buffer->size - buffer->length, 0);
         swTraceLog(SW_TRACE_MYSQL_CLIENT, "recv-ret=%d, buffer-length=%zu.", ret, buffer->length);
         if (ret < 0)
@@ -1875,7 +2280,7 @@ static int swoole_mysql_coro_onRead(swReactor *reactor, swEvent *event)
         {
             buffer->length += ret;
             //recv again
-            if (buffer->length == buffer->size)
+            if (buffer->length == buffer->size && !client->streaming)
             {
                 if (swString_extend(buffer, buffer->size * 2) < 0)
                 {
@@ -1887,6 +2292,13 @@ static int swoole_mysql_coro_onRead(swReactor *reactor, swEvent *event)
 
             _parse_response:
 
+            if (client->streaming)
+            {
+                // one read at a time, the rest stays in the socket until the rows are fetched
+                swoole_mysql_coro_stream_parse(client);
+                return SW_OK;
+            }
+
             if (client->tmp_result)
             {
                 _check_over:
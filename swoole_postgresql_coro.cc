@@ -19,9 +19,35 @@
 #ifdef SW_USE_POSTGRESQL
 #include "swoole_postgresql_coro.h"
 #include "swoole_coroutine.h"
+#include "lru_cache.h"
+
+#include <string>
+#include <vector>
+#include <unordered_map>
 
 using namespace swoole;
 
+struct pg_statement
+{
+    std::string name;
+    uint32_t session;
+};
+
+struct _pg_statement_cache
+{
+    std::vector<std::string> garbage; /* evicted statements, deallocated before the next miss is prepared */
+    LRUCache statements; /* sql => pg_statement */
+    std::unordered_map<std::string, std::string> names; /* stmtname given to prepare() => sql */
+    size_t capacity;
+    uint32_t session = 0; /* bumped by connect(), the statements of the former connection are gone with it */
+    uint64_t count = 0;
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    bool failed = false;
+
+    explicit _pg_statement_cache(size_t _capacity) : statements(_capacity), capacity(_capacity) { }
+};
+
 static PHP_METHOD(swoole_postgresql_coro, __construct);
 static PHP_METHOD(swoole_postgresql_coro, __destruct);
 static PHP_METHOD(swoole_postgresql_coro, connect);
@@ -36,6 +62,7 @@ static PHP_METHOD(swoole_postgresql_coro, fetchObject);
 static PHP_METHOD(swoole_postgresql_coro, fetchAssoc);
 static PHP_METHOD(swoole_postgresql_coro, fetchArray);
 static PHP_METHOD(swoole_postgresql_coro, fetchRow);
+static PHP_METHOD(swoole_postgresql_coro, getStatementCacheStats);
 
 static void php_pgsql_fetch_hash(INTERNAL_FUNCTION_PARAMETERS, zend_long result_type, int into_object);
 
@@ -56,6 +83,7 @@ ZEND_END_ARG_INFO()
 
 ZEND_BEGIN_ARG_INFO_EX(arginfo_pg_connect, 0, 0, -1)
     ZEND_ARG_INFO(0, conninfo)
+    ZEND_ARG_ARRAY_INFO(0, options, 0)
 ZEND_END_ARG_INFO()
 
 ZEND_BEGIN_ARG_INFO_EX(arginfo_pg_query, 0, 0, 0)
@@ -129,6 +157,7 @@ static const zend_function_entry swoole_postgresql_coro_methods[] =
     PHP_ME(swoole_postgresql_coro, fetchAssoc, arginfo_pg_fetch_assoc, ZEND_ACC_PUBLIC)
     PHP_ME(swoole_postgresql_coro, fetchArray, arginfo_pg_fetch_array, ZEND_ACC_PUBLIC)
     PHP_ME(swoole_postgresql_coro, fetchRow, arginfo_pg_fetch_row, ZEND_ACC_PUBLIC)
+    PHP_ME(swoole_postgresql_coro, getStatementCacheStats, arginfo_swoole_void, ZEND_ACC_PUBLIC)
     PHP_ME(swoole_postgresql_coro, __destruct, arginfo_swoole_void, ZEND_ACC_PUBLIC)
     PHP_FE_END
 };
@@ -153,6 +182,17 @@ void swoole_postgresql_coro_init(int module_number)
     REGISTER_LONG_CONSTANT("SW_PGSQL_BOTH", PGSQL_BOTH, CONST_CS | CONST_PERSISTENT);
 }
 
+int php_swoole_postgresql_coro_get_fd(zval *zobject, int *fd)
+{
+    if (!instanceof_function(Z_OBJCE_P(zobject), swoole_postgresql_coro_ce_ptr))
+    {
+        return SW_FALSE;
+    }
+    pg_object *object = (pg_object *) swoole_get_object(zobject);
+    *fd = object && object->conn ? object->fd : -1;
+    return SW_TRUE;
+}
+
 static PHP_METHOD(swoole_postgresql_coro, __construct)
 {
     PHPCoroutine::check();
@@ -165,10 +205,13 @@ static PHP_METHOD(swoole_postgresql_coro, __construct)
 static PHP_METHOD(swoole_postgresql_coro, connect)
 {
     zval *conninfo;
+    zval *options = NULL;
     PGconn * pgsql;
 
-    ZEND_PARSE_PARAMETERS_START(1, 1)
+    ZEND_PARSE_PARAMETERS_START(1, 2)
         Z_PARAM_ZVAL(conninfo)
+        Z_PARAM_OPTIONAL
+        Z_PARAM_ARRAY(options)
     ZEND_PARSE_PARAMETERS_END_EX(RETURN_FALSE);
 
     pgsql = PQconnectStart(Z_STRVAL_P(conninfo));
@@ -211,6 +254,19 @@ static PHP_METHOD(swoole_postgresql_coro, connect)
     _socket->object = object;
     _socket->active = 0;
 
+    zval *value;
+    if (options && php_swoole_array_get_value(Z_ARRVAL_P(options), "statement_cache", value) && zval_get_long(value) > 0
+            && !object->statement_cache)
+    {
+        object->statement_cache = new _pg_statement_cache(zval_get_long(value));
+    }
+    if (object->statement_cache)
+    {
+        // a new session, the cached statements are prepared again on their first use
+        object->statement_cache->session++;
+        object->statement_cache->garbage.clear();
+    }
+
     php_coro_context *context = (php_coro_context *) swoole_get_property(getThis(), 0);
     if (!context)
     {
@@ -526,10 +582,50 @@ static  int prepare_result_parse(pg_object *object)
     zval *retval = NULL;
     zval return_value;
     php_coro_context *context = (php_coro_context *) swoole_get_property(object->object, 0);
+    PGresult *pgsql_result;
+
+    /**
+     * a request may return several results ("DEALLOCATE a;DEALLOCATE b;"), read what arrived
+     * without blocking and resume the coroutine after the last one
+     */
+    if (!PQconsumeInput(object->conn))
+    {
+        object->prepare_failed = 1;
+        goto _resume;
+    }
+    while (!PQisBusy(object->conn))
+    {
+        pgsql_result = PQgetResult(object->conn);
+        if (pgsql_result == NULL)
+        {
+            goto _resume;
+        }
+        if (PQresultStatus(pgsql_result) != PGRES_COMMAND_OK)
+        {
+            object->prepare_failed = 1;
+        }
+        PQclear(pgsql_result);
+    }
+    return SW_OK;
 
-    /* Wait to finish sending buffer */
-    //res = PQflush(object->conn);
-    ZVAL_TRUE(&return_value);
+    _resume:
+    if (!object->prepare_failed)
+    {
+        ZVAL_TRUE(&return_value);
+        zend_update_property_null(swoole_postgresql_coro_ce_ptr, object->object, "error", 5);
+    }
+    else
+    {
+        char *err_msg = PQerrorMessage(object->conn);
+        swWarn("Prepare failed: [%s]", err_msg);
+        ZVAL_FALSE(&return_value);
+        zend_update_property_string(swoole_postgresql_coro_ce_ptr, object->object, "error", 5, err_msg);
+    }
+    object->prepare_failed = 0;
+    if (object->statement_cache)
+    {
+        object->statement_cache->failed = Z_TYPE(return_value) == IS_FALSE;
+    }
     ret = PHPCoroutine::resume_m(context, &return_value, retval);
 
     if (ret == SW_CORO_END && retval)
@@ -585,6 +681,71 @@ static PHP_METHOD(swoole_postgresql_coro, query)
     PHPCoroutine::yield_m(return_value, context);
 }
 
+/**
+ * the results of the previous prepare are all consumed by prepare_result_parse, nothing to drain here
+ */
+static bool swoole_pgsql_coro_statement_send(pg_object *object, zval *zobject, const char *sql, const char *name, zval *return_value)
+{
+    object->request_type = PREPARE;
+    int ret = name ? PQsendPrepare(object->conn, name, sql, 0, NULL) : PQsendQuery(object->conn, sql);
+    if (!ret)
+    {
+        swWarn("error:[%s]", PQerrorMessage(object->conn));
+        return false;
+    }
+
+    php_coro_context *context = (php_coro_context *) swoole_get_property(zobject, 0);
+    context->state = SW_CORO_CONTEXT_RUNNING;
+    context->coro_params = *zobject;
+    PHPCoroutine::yield_m(return_value, context);
+    return !object->statement_cache->failed;
+}
+
+/**
+ * find the server side statement of the sql, a miss prepares it under a name of our own,
+ * the statements evicted before are deallocated first
+ */
+static bool swoole_pgsql_coro_statement_get(pg_object *object, zval *zobject, const std::string &sql, std::string &name, zval *return_value)
+{
+    _pg_statement_cache *cache = object->statement_cache;
+    pg_statement *stmt = (pg_statement *) cache->statements.get(sql).get();
+    if (stmt && stmt->session == cache->session)
+    {
+        cache->hits++;
+        name = stmt->name;
+        return true;
+    }
+    cache->misses++;
+
+    if (!cache->garbage.empty())
+    {
+        std::string deallocate;
+        for (auto &garbage : cache->garbage)
+        {
+            deallocate += "DEALLOCATE " + garbage + ";";
+        }
+        cache->garbage.clear();
+        swoole_pgsql_coro_statement_send(object, zobject, deallocate.c_str(), NULL, return_value);
+    }
+
+    name = "swoole_stmt_" + std::to_string(++cache->count);
+    if (!swoole_pgsql_coro_statement_send(object, zobject, sql.c_str(), name.c_str(), return_value))
+    {
+        return false;
+    }
+
+    stmt = new pg_statement{name, cache->session};
+    cache->statements.set(sql, std::shared_ptr<void>(stmt, [cache](pg_statement *evicted)
+    {
+        if (evicted->session == cache->session)
+        {
+            cache->garbage.push_back(evicted->name);
+        }
+        delete evicted;
+    }));
+    return true;
+}
+
 static PHP_METHOD(swoole_postgresql_coro, prepare)
 {
     zval *query, *stmtname;
@@ -601,6 +762,13 @@ static PHP_METHOD(swoole_postgresql_coro, prepare)
     object->request_type = PREPARE;
     pgsql = object->conn;
 
+    if (object->statement_cache)
+    {
+        std::string sql(Z_STRVAL_P(query), Z_STRLEN_P(query));
+        std::string name;
+        object->statement_cache->names[std::string(Z_STRVAL_P(stmtname), Z_STRLEN_P(stmtname))] = sql;
+        RETURN_BOOL(swoole_pgsql_coro_statement_get(object, getThis(), sql, name, return_value));
+    }
 
     is_non_blocking = PQisnonblocking(pgsql);
 
@@ -659,9 +827,23 @@ static PHP_METHOD(swoole_postgresql_coro, execute)
     ZEND_PARSE_PARAMETERS_END_EX(RETURN_FALSE);
 
     pg_object *object = (pg_object *) swoole_get_object(getThis());
-    object->request_type = NORMAL_QUERY;
     pgsql = object->conn;
 
+    const char *name = Z_STRVAL_P(stmtname);
+    std::string server_name;
+    if (object->statement_cache)
+    {
+        auto iter = object->statement_cache->names.find(std::string(Z_STRVAL_P(stmtname), Z_STRLEN_P(stmtname)));
+        if (iter != object->statement_cache->names.end())
+        {
+            if (!swoole_pgsql_coro_statement_get(object, getThis(), iter->second, server_name, return_value))
+            {
+                RETURN_FALSE;
+            }
+            name = server_name.c_str();
+        }
+    }
+    object->request_type = NORMAL_QUERY;
 
     is_non_blocking = PQisnonblocking(pgsql);
 
@@ -702,7 +884,7 @@ static PHP_METHOD(swoole_postgresql_coro, execute)
         } ZEND_HASH_FOREACH_END();
     }
 
-    if (PQsendQueryPrepared(pgsql, Z_STRVAL_P(stmtname), num_params, (const char * const *)params, NULL, NULL, 0)) {
+    if (PQsendQueryPrepared(pgsql, name, num_params, (const char * const *)params, NULL, NULL, 0)) {
         _php_pgsql_free_params(params, num_params);
     } else if (is_non_blocking) {
         _php_pgsql_free_params(params, num_params);
@@ -713,7 +895,7 @@ static PHP_METHOD(swoole_postgresql_coro, execute)
             PQreset(pgsql);
         }
         */
-        if (!PQsendQueryPrepared(pgsql, Z_STRVAL_P(stmtname), num_params, (const char * const *)params, NULL, NULL, 0)) {
+        if (!PQsendQueryPrepared(pgsql, name, num_params, (const char * const *)params, NULL, NULL, 0)) {
             _php_pgsql_free_params(params, num_params);
             RETURN_FALSE;
         }
@@ -1246,6 +1428,16 @@ static int swoole_pgsql_coro_onError(swReactor *reactor, swEvent *event)
     return SW_OK;
 }
 
+static PHP_METHOD(swoole_postgresql_coro, getStatementCacheStats)
+{
+    pg_object *object = (pg_object *) swoole_get_object(getThis());
+    _pg_statement_cache *cache = object ? object->statement_cache : NULL;
+    array_init(return_value);
+    add_assoc_long(return_value, "capacity", cache ? cache->capacity : 0);
+    add_assoc_long(return_value, "hits", cache ? cache->hits : 0);
+    add_assoc_long(return_value, "misses", cache ? cache->misses : 0);
+}
+
 static PHP_METHOD(swoole_postgresql_coro, __destruct)
 {
     SW_PREVENT_USER_DESTRUCT;
@@ -1275,6 +1467,10 @@ static int swoole_postgresql_coro_close(zval *zobject)
 
     _socket->object = NULL;
     _socket->active = 0;
+    if (object->statement_cache)
+    {
+        delete object->statement_cache;
+    }
     efree(object);
     swoole_set_object(zobject, NULL);
 
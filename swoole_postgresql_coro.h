@@ -35,6 +35,10 @@ typedef struct _php_pgsql_object {
     int fd;
     double timeout;
     swTimer_node *timer;
+    /* the statements prepared on this connection, keyed by the sql */
+    struct _pg_statement_cache *statement_cache;
+    /* a result of the pending prepare failed, more results may follow */
+    int prepare_failed;
 } pg_object;
 
 #define PGSQL_ASSOC           1<<0
@@ -689,6 +689,14 @@ void php_swoole_process_clean()
         swTraceLog(SW_TRACE_PHP, "destroy reactor");
     }
 
+#ifdef SW_USE_IOURING
+    /**
+     * the ring is shared with the parent, release it after the reactor so that
+     * the eventfd is not removed from the epoll set of the parent
+     */
+    swAio_iouring_free();
+#endif
+
     SwooleG.memory_pool = swMemoryGlobal_new(SW_GLOBAL_MEMORY_PAGESIZE, 1);
     if (SwooleG.memory_pool == NULL)
     {
@@ -23,6 +23,8 @@
 
 #include "ext/standard/php_var.h"
 
+#include <vector>
+
 using namespace swoole;
 
 #define SW_REDIS_COMMAND_ALLOC_ARGS_ARR zval *z_args = (zval *) emalloc(argc*sizeof(zval));
@@ -877,6 +879,16 @@ ZEND_END_ARG_INFO()
         efree(argv); \
     }
 
+/**
+ * a coroutine waiting for the reply of an auto-pipelined command
+ */
+typedef struct
+{
+    Coroutine *co;
+    redisReply *reply;
+    bool done;
+} swRedisPipelineWaiter;
+
 typedef struct
 {
     redisContext *context;
@@ -891,6 +903,12 @@ typedef struct
     zval *zobject;
     zval _zobject;
     bool subscribe;
+    bool auto_pipeline;
+    /* the coroutine sending the current batch and reading its replies */
+    Coroutine *pipeline_leader;
+    /* the commands of the next batch and their coroutines */
+    swString *pipeline_buffer;
+    std::vector<swRedisPipelineWaiter *> *pipeline_waiters;
 } swRedisClient;
 
 typedef struct
@@ -1158,10 +1176,153 @@ static bool redis_select_db(swRedisClient *redis, long db_number)
     return ret;
 }
 
+static void redis_pipeline_resume(void *data)
+{
+    ((Coroutine *) data)->resume();
+}
+
+/**
+ * send the commands queued so far in one write and hand the replies out in order,
+ * the commands queued meanwhile make the next batch, led by the first of them
+ */
+static void redis_pipeline_flush(swRedisClient *redis)
+{
+    swString *buffer = redis->pipeline_buffer;
+    std::vector<swRedisPipelineWaiter *> *waiters = redis->pipeline_waiters;
+    redis->pipeline_buffer = nullptr;
+    redis->pipeline_waiters = nullptr;
+
+    bool ok = swoole_redis_coro_keep_liveness(redis);
+    if (ok)
+    {
+        redisContext *context = redis->context;
+        Socket *socket = swoole_redis_coro_get_socket(context);
+        context->err = 0;
+        zend_update_property_long(swoole_redis_coro_ce_ptr, redis->zobject, ZEND_STRL("errType"), 0);
+        zend_update_property_long(swoole_redis_coro_ce_ptr, redis->zobject, ZEND_STRL("errCode"), 0);
+        zend_update_property_string(swoole_redis_coro_ce_ptr, redis->zobject, ZEND_STRL("errMsg"), "");
+        if (socket->send_all(buffer->str, buffer->length) != (ssize_t) buffer->length)
+        {
+            zend_update_property_long(swoole_redis_coro_ce_ptr, redis->zobject, ZEND_STRL("errType"), SW_REDIS_ERR_IO);
+            zend_update_property_long(swoole_redis_coro_ce_ptr, redis->zobject, ZEND_STRL("errCode"), socket->errCode);
+            zend_update_property_string(swoole_redis_coro_ce_ptr, redis->zobject, ZEND_STRL("errMsg"), socket->errMsg);
+            swoole_redis_coro_close(redis);
+            ok = false;
+        }
+        for (size_t i = 0; ok && i < waiters->size(); i++)
+        {
+            if (redisGetReply(context, (void **) &(*waiters)[i]->reply) != REDIS_OK)
+            {
+                zend_update_property_long(swoole_redis_coro_ce_ptr, redis->zobject, ZEND_STRL("errType"), context->err);
+                zend_update_property_long(swoole_redis_coro_ce_ptr, redis->zobject, ZEND_STRL("errCode"), sw_redis_convert_err(context->err));
+                zend_update_property_string(swoole_redis_coro_ce_ptr, redis->zobject, ZEND_STRL("errMsg"), context->errstr);
+                (*waiters)[i]->reply = nullptr;
+                swoole_redis_coro_close(redis);
+                ok = false;
+            }
+        }
+    }
+    swString_free(buffer);
+
+    redis->pipeline_leader = nullptr;
+    if (redis->pipeline_waiters)
+    {
+        redis->pipeline_leader = redis->pipeline_waiters->front()->co;
+        SwooleG.main_reactor->defer(SwooleG.main_reactor, redis_pipeline_resume, redis->pipeline_leader);
+    }
+
+    Coroutine *current = Coroutine::get_current();
+    for (auto waiter : *waiters)
+    {
+        waiter->done = true;
+        if (waiter->co != current)
+        {
+            waiter->co->resume();
+        }
+    }
+    delete waiters;
+}
+
+/**
+ * the commands changing the state of the connection would apply to the commands
+ * of the other coroutines in the same batch, they cannot be auto-pipelined
+ */
+static bool redis_pipeline_refuse(swRedisClient *redis, const char *cmd, size_t cmd_len)
+{
+    static const char *stateful_commands[] = { "MULTI", "EXEC", "DISCARD", "WATCH", "UNWATCH", "SELECT" };
+    for (size_t i = 0; i < sizeof(stateful_commands) / sizeof(stateful_commands[0]); i++)
+    {
+        if (strlen(stateful_commands[i]) == cmd_len && strncasecmp(stateful_commands[i], cmd, cmd_len) == 0)
+        {
+            char errmsg[128];
+            sw_snprintf(errmsg, sizeof(errmsg), "%s cannot be used with auto_pipeline.", stateful_commands[i]);
+            zend_update_property_long(swoole_redis_coro_ce_ptr, redis->zobject, ZEND_STRL("errType"), SW_REDIS_ERR_OTHER);
+            zend_update_property_long(swoole_redis_coro_ce_ptr, redis->zobject, ZEND_STRL("errCode"), sw_redis_convert_err(SW_REDIS_ERR_OTHER));
+            zend_update_property_string(swoole_redis_coro_ce_ptr, redis->zobject, ZEND_STRL("errMsg"), errmsg);
+            return true;
+        }
+    }
+    return false;
+}
+
+static void redis_pipeline_request(swRedisClient *redis, int argc, char **argv, size_t *argvlen, zval *return_value)
+{
+    if (redis_pipeline_refuse(redis, argv[0], argvlen[0]))
+    {
+        ZVAL_FALSE(return_value);
+        return;
+    }
+    char *cmd;
+    int len = redisFormatCommandArgv(&cmd, argc, (const char **) argv, (const size_t *) argvlen);
+    if (len < 0)
+    {
+        zend_update_property_long(swoole_redis_coro_ce_ptr, redis->zobject, ZEND_STRL("errType"), SW_REDIS_ERR_OOM);
+        zend_update_property_long(swoole_redis_coro_ce_ptr, redis->zobject, ZEND_STRL("errCode"), sw_redis_convert_err(SW_REDIS_ERR_OOM));
+        zend_update_property_string(swoole_redis_coro_ce_ptr, redis->zobject, ZEND_STRL("errMsg"), "cannot allocate the command.");
+        ZVAL_FALSE(return_value);
+        return;
+    }
+    if (!redis->pipeline_buffer)
+    {
+        redis->pipeline_buffer = swString_new(SW_BUFFER_SIZE_STD);
+        redis->pipeline_waiters = new std::vector<swRedisPipelineWaiter *>;
+    }
+    swString_append_ptr(redis->pipeline_buffer, cmd, len);
+    redisFreeCommand(cmd);
+
+    swRedisPipelineWaiter waiter = { Coroutine::get_current(), nullptr, false };
+    redis->pipeline_waiters->push_back(&waiter);
+    if (!redis->pipeline_leader)
+    {
+        // lead after the other coroutines of this loop have queued their commands
+        redis->pipeline_leader = waiter.co;
+        SwooleG.main_reactor->defer(SwooleG.main_reactor, redis_pipeline_resume, waiter.co);
+    }
+    waiter.co->yield();
+    if (!waiter.done)
+    {
+        redis_pipeline_flush(redis);
+    }
+
+    if (waiter.reply)
+    {
+        swoole_redis_coro_parse_result(redis, return_value, waiter.reply);
+        freeReplyObject(waiter.reply);
+    }
+    else
+    {
+        ZVAL_FALSE(return_value);
+    }
+}
+
 static void redis_request(swRedisClient *redis, int argc, char **argv, size_t *argvlen, zval *return_value, bool retry)
 {
     redisReply *reply = nullptr;
-    if (!swoole_redis_coro_keep_liveness(redis))
+    if (redis->auto_pipeline && !redis->defer && !redis->subscribe && redis->pipeline_leader != Coroutine::get_current())
+    {
+        redis_pipeline_request(redis, argc, argv, argvlen, return_value);
+    }
+    else if (!swoole_redis_coro_keep_liveness(redis))
     {
         ZVAL_FALSE(return_value);
     }
@@ -1910,6 +2071,17 @@ void swoole_redis_coro_init(int module_number)
     SWOOLE_DEFINE(REDIS_ERR_ALLOC);
 }
 
+int php_swoole_redis_coro_get_fd(zval *zobject, int *fd)
+{
+    if (!instanceof_function(Z_OBJCE_P(zobject), swoole_redis_coro_ce_ptr))
+    {
+        return SW_FALSE;
+    }
+    swRedisClient *redis = (swRedisClient *) swoole_get_object(zobject);
+    *fd = redis && redis->context ? redis->context->fd : -1;
+    return SW_TRUE;
+}
+
 static void swoole_redis_coro_set_options(swRedisClient *redis, zval* zoptions, bool backward_compatibility = false)
 {
     zval *zsettings = sw_zend_read_property_array(swoole_redis_coro_ce_ptr, redis->zobject, ZEND_STRL("setting"), 1);
@@ -1954,6 +2126,10 @@ static void swoole_redis_coro_set_options(swRedisClient *redis, zval* zoptions,
     {
         redis->reconnect_interval = (uint8_t) MIN(zval_get_long(ztmp), UINT8_MAX);
     }
+    if (php_swoole_array_get_value(vht, "auto_pipeline", ztmp))
+    {
+        redis->auto_pipeline = zval_is_true(ztmp);
+    }
 }
 
 static PHP_METHOD(swoole_redis_coro, __construct)
@@ -2192,6 +2368,27 @@ static PHP_METHOD(swoole_redis_coro, __destruct)
         swoole_redis_coro_close(redis);
     }
     swoole_set_object(getThis(), NULL);
+    if (redis->pipeline_buffer)
+    {
+        std::vector<swRedisPipelineWaiter *> *waiters = redis->pipeline_waiters;
+        swString_free(redis->pipeline_buffer);
+        redis->pipeline_buffer = nullptr;
+        redis->pipeline_waiters = nullptr;
+        zend_update_property_long(swoole_redis_coro_ce_ptr, redis->zobject, ZEND_STRL("errType"), SW_REDIS_ERR_CLOSED);
+        zend_update_property_long(swoole_redis_coro_ce_ptr, redis->zobject, ZEND_STRL("errCode"), sw_redis_convert_err(SW_REDIS_ERR_CLOSED));
+        zend_update_property_string(swoole_redis_coro_ce_ptr, redis->zobject, ZEND_STRL("errMsg"), "the client has been destroyed.");
+        // the commands were never sent, the waiters get false, the leader is resumed by its deferred callback
+        for (auto waiter : *waiters)
+        {
+            waiter->reply = nullptr;
+            waiter->done = true;
+            if (waiter->co != redis->pipeline_leader)
+            {
+                waiter->co->resume();
+            }
+        }
+        delete waiters;
+    }
     efree(redis);
 }
 
@@ -4037,6 +4234,10 @@ static PHP_METHOD(swoole_redis_coro, select)
     ZEND_PARSE_PARAMETERS_END_EX(RETURN_FALSE);
 
     SW_REDIS_COMMAND_CHECK
+    if (redis->auto_pipeline && redis_pipeline_refuse(redis, ZEND_STRL("SELECT")))
+    {
+        RETURN_FALSE;
+    }
     zval *zsetting = sw_zend_read_property_array(swoole_redis_coro_ce_ptr, getThis(), ZEND_STRL("setting"), 1);
     add_assoc_long(zsetting, "database", db_number);
     RETURN_BOOL(redis_select_db(redis, db_number));
@@ -960,6 +960,23 @@ static zval* php_swoole_server_add_port(swServer *serv, swListenPort *port)
     return port_object;
 }
 
+static void php_swoole_server_request_done(void *data)
+{
+    sw_atomic_fetch_sub(&SwooleWG.worker->inflight_num, 1);
+}
+
+/**
+ * the first coroutine started by a request callback keeps the request in flight until it ends
+ */
+static void php_swoole_server_onCoroStart(void *data)
+{
+    if (SwooleWG.request_pending)
+    {
+        SwooleWG.request_pending = 0;
+        PHPCoroutine::defer(php_swoole_server_request_done, NULL);
+    }
+}
+
 void php_swoole_server_before_start(swServer *serv, zval *zobject)
 {
     /**
@@ -976,6 +993,11 @@ void php_swoole_server_before_start(swServer *serv, zval *zobject)
     Z_TRY_ADDREF_P(zobject);
     serv->ptr2 = sw_zval_dup(zobject);
 
+    if (serv->factory_mode == SW_MODE_PROCESS)
+    {
+        swoole_add_hook(SW_GLOBAL_HOOK_ON_CORO_START, php_swoole_server_onCoroStart, 1);
+    }
+
     if (serv->send_yield)
     {
         if (serv->onClose == NULL)
@@ -2548,6 +2570,18 @@ static PHP_METHOD(swoole_server, set)
     {
         serv->dispatch_mode = (uint8_t) zval_get_long(v);
     }
+    //reactor_dispatch_mode
+    if (php_swoole_array_get_value(vht, "reactor_dispatch_mode", v))
+    {
+        serv->reactor_dispatch_mode = (uint8_t) zval_get_long(v);
+    }
+#if defined(HAVE_REUSEPORT) && defined(HAVE_EPOLL)
+    //listen socket of each reactor thread
+    if (php_swoole_array_get_value(vht, "enable_reuse_port", v))
+    {
+        serv->enable_reuse_port = zval_is_true(v) && swoole_version_compare(SwooleG.uname.release, "3.9.0") >= 0;
+    }
+#endif
     //dispatch function
     if (php_swoole_array_get_value(vht, "dispatch_func", v))
     {
@@ -2632,6 +2666,11 @@ static PHP_METHOD(swoole_server, set)
             serv->task_enable_coroutine = 0;
         }
     }
+    //task work stealing
+    if (php_swoole_array_get_value(vht, "task_enable_steal", v))
+    {
+        serv->task_enable_steal = zval_is_true(v);
+    }
     //task_worker_num
     if (php_swoole_array_get_value(vht, "task_worker_num", v))
     {
@@ -2683,6 +2722,11 @@ static PHP_METHOD(swoole_server, set)
         SwooleG.task_tmpdir = (char*) sw_malloc(Z_STRLEN_P(v) + sizeof(SW_TASK_TMP_FILE) + 1);
         SwooleG.task_tmpdir_len = sw_snprintf(SwooleG.task_tmpdir, SW_TASK_TMPDIR_SIZE, "%s/swoole.task.XXXXXX", Z_STRVAL_P(v)) + 1;
     }
+    //shared memory for the large task payloads, 0 to use tmpfiles only
+    if (php_swoole_array_get_value(vht, "task_shm_size", v))
+    {
+        serv->task_shm_size = (uint32_t) MAX(zval_get_long(v), 0);
+    }
     //task_max_request
     if (php_swoole_array_get_value(vht, "task_max_request", v))
     {
@@ -2787,6 +2831,11 @@ static PHP_METHOD(swoole_server, set)
         }
         serv->http_compression_level = level;
     }
+    if (php_swoole_array_get_value(vht, "http_compression_cache", v))
+    {
+        zend_long num = Z_TYPE_P(v) == IS_TRUE ? SW_HTTP_COMPRESSION_CACHE_NUM : zval_get_long(v);
+        serv->http_compression_cache = num > 0 ? num : 0;
+    }
 #endif
     //temporary directory for HTTP uploaded file.
     if (php_swoole_array_get_value(vht, "upload_tmp_dir", v))
@@ -2842,6 +2891,22 @@ static PHP_METHOD(swoole_server, set)
     {
         serv->buffer_output_size = (uint32_t) zval_get_long(v);
     }
+    /**
+     * shared memory for big packages from reactor threads to a worker, 0 to disable
+     */
+    if (php_swoole_array_get_value(vht, "dispatch_shm_size", v))
+    {
+        serv->dispatch_shm_size = (uint32_t) zval_get_long(v);
+    }
+    //pipe backlog budget of a worker
+    if (php_swoole_array_get_value(vht, "pipe_backlog_size", v))
+    {
+        serv->pipe_backlog_size = (uint32_t) zval_get_long(v);
+    }
+    if (php_swoole_array_get_value(vht, "pipe_backlog_num", v))
+    {
+        serv->pipe_backlog_num = (uint32_t) zval_get_long(v);
+    }
     //message queue key
     if (php_swoole_array_get_value(vht, "message_queue_key", v))
     {
@@ -3216,16 +3281,12 @@ static PHP_METHOD(swoole_server, sendto)
         server_socket = ipv6 ?  serv->udp_socket_ipv6 : serv->udp_socket_ipv4;
     }
 
-    int ret;
-    if (ipv6)
+    swSocketAddress sa;
+    if (swSocket_udp_address(&sa, ipv6, ip, port) < 0)
     {
-        ret = swSocket_udp_sendto6(server_socket, ip, port, data, len);
-    }
-    else
-    {
-        ret = swSocket_udp_sendto(server_socket, ip, port, data, len);
+        RETURN_FALSE;
     }
-    SW_CHECK_RETURN(ret);
+    SW_CHECK_RETURN(swServer_udp_sendto(serv, server_socket, &sa, data, len));
 }
 
 static PHP_METHOD(swoole_server, sendfile)
@@ -3387,6 +3448,48 @@ static PHP_METHOD(swoole_server, stats)
             add_assoc_long_ex(return_value, ZEND_STRL("task_queue_bytes"), queue_bytes);
         }
     }
+    else if (serv->task_ipc_mode == SW_TASK_IPC_UNIXSOCK && serv->task_worker_num > 0)
+    {
+        swProcessPool *pool = &serv->gs->task_workers;
+        zval task_queue_depth;
+        array_init(&task_queue_depth);
+        for (int i = 0; i < pool->worker_num; i++)
+        {
+            add_index_long(&task_queue_depth, i, MAX((int) pool->workers[i].tasking_num, 0));
+        }
+        add_assoc_zval_ex(return_value, ZEND_STRL("task_queue_depth"), &task_queue_depth);
+        if (pool->work_stealing)
+        {
+            add_assoc_long_ex(return_value, ZEND_STRL("task_steal_count"), pool->steal_count);
+        }
+    }
+
+    if (serv->factory_mode == SW_MODE_PROCESS)
+    {
+        zval pipe_backlog_size, pipe_backlog_num, worker_inflight_num;
+        array_init(&pipe_backlog_size);
+        array_init(&pipe_backlog_num);
+        array_init(&worker_inflight_num);
+        for (int i = 0; i < serv->worker_num; i++)
+        {
+            add_index_long(&pipe_backlog_size, i, serv->workers[i].pipe_backlog_size);
+            add_index_long(&pipe_backlog_num, i, serv->workers[i].pipe_backlog_num);
+            add_index_long(&worker_inflight_num, i, MAX((int) serv->workers[i].inflight_num, 0));
+        }
+        add_assoc_zval_ex(return_value, ZEND_STRL("pipe_backlog_size"), &pipe_backlog_size);
+        add_assoc_zval_ex(return_value, ZEND_STRL("pipe_backlog_num"), &pipe_backlog_num);
+        add_assoc_zval_ex(return_value, ZEND_STRL("worker_inflight_num"), &worker_inflight_num);
+        if (serv->dispatch_shm_size > 0)
+        {
+            zval dispatch_shm_num;
+            array_init(&dispatch_shm_num);
+            for (int i = 0; i < serv->worker_num; i++)
+            {
+                add_index_long(&dispatch_shm_num, i, serv->workers[i].dispatch_shm_num);
+            }
+            add_assoc_zval_ex(return_value, ZEND_STRL("dispatch_shm_num"), &dispatch_shm_num);
+        }
+    }
 
 #ifdef SW_COROUTINE
     add_assoc_long_ex(return_value, ZEND_STRL("coroutine_num"), Coroutine::count());
@@ -3498,6 +3601,10 @@ static PHP_METHOD(swoole_server, taskwait)
     }
 
     int _dst_worker_id = (int) dst_worker_id;
+    if (_dst_worker_id >= 0)
+    {
+        swTask_type(&buf) |= SW_TASK_NOSTEAL;
+    }
 
     //coroutine
     if (PHPCoroutine::get_cid() >= 0)
@@ -3510,6 +3617,11 @@ static PHP_METHOD(swoole_server, taskwait)
 
     uint64_t notify;
     swEventData *task_result = &(serv->task_result[SwooleWG.id]);
+    //the result of a timed out taskwait, release its payload
+    if (task_result->info.type == SW_EVENT_FINISH && (swTask_type(task_result) & SW_TASK_TMPFILE))
+    {
+        swTaskWorker_large_unpack(task_result);
+    }
     bzero(task_result, sizeof(swEventData));
     swPipe *task_notify_pipe = &serv->task_notify[SwooleWG.id];
     int efd = task_notify_pipe->getFd(task_notify_pipe, 0);
@@ -3531,6 +3643,8 @@ static PHP_METHOD(swoole_server, taskwait)
                     continue;
                 }
                 zval *task_notify_data = php_swoole_task_unpack(task_result);
+                //consumed
+                task_result->info.type = 0;
                 if (task_notify_data == NULL)
                 {
                     RETURN_FALSE;
@@ -3854,6 +3968,10 @@ static PHP_METHOD(swoole_server, task)
     swTask_type(&buf) |= SW_TASK_NONBLOCK;
 
     int _dst_worker_id = (int) dst_worker_id;
+    if (_dst_worker_id >= 0)
+    {
+        swTask_type(&buf) |= SW_TASK_NOSTEAL;
+    }
     sw_atomic_fetch_add(&serv->stats->tasking_num, 1);
 
     if (swProcessPool_dispatch(&serv->gs->task_workers, &buf, &_dst_worker_id) >= 0)
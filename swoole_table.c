@@ -32,6 +32,8 @@ ZEND_END_ARG_INFO()
 ZEND_BEGIN_ARG_INFO_EX(arginfo_swoole_table_construct, 0, 0, 1)
     ZEND_ARG_INFO(0, table_size)
     ZEND_ARG_INFO(0, conflict_proportion)
+    ZEND_ARG_INFO(0, layout)
+    ZEND_ARG_INFO(0, max_size)
 ZEND_END_ARG_INFO()
 
 ZEND_BEGIN_ARG_INFO_EX(arginfo_swoole_table_column, 0, 0, 2)
@@ -265,6 +267,8 @@ void swoole_table_init(int module_number)
     zend_declare_class_constant_long(swoole_table_ce_ptr, ZEND_STRL("TYPE_INT"), SW_TABLE_INT);
     zend_declare_class_constant_long(swoole_table_ce_ptr, ZEND_STRL("TYPE_STRING"), SW_TABLE_STRING);
     zend_declare_class_constant_long(swoole_table_ce_ptr, ZEND_STRL("TYPE_FLOAT"), SW_TABLE_FLOAT);
+    zend_declare_class_constant_long(swoole_table_ce_ptr, ZEND_STRL("LAYOUT_CHAIN"), SW_TABLE_LAYOUT_CHAIN);
+    zend_declare_class_constant_long(swoole_table_ce_ptr, ZEND_STRL("LAYOUT_OPEN_ADDRESSING"), SW_TABLE_LAYOUT_OPEN_ADDRESSING);
 
     SWOOLE_INIT_CLASS_ENTRY(swoole_table_row, "Swoole\\Table\\Row", "swoole_table_row", NULL, swoole_table_row_methods);
     SWOOLE_SET_CLASS_SERIALIZABLE(swoole_table_row, zend_class_serialize_deny, zend_class_unserialize_deny);
@@ -285,11 +289,18 @@ PHP_METHOD(swoole_table, __construct)
 {
     zend_long table_size;
     double conflict_proportion = SW_TABLE_CONFLICT_PROPORTION;
+    zend_long layout = SW_TABLE_LAYOUT_CHAIN;
+    zend_long max_size = 0;
 
-    if (zend_parse_parameters(ZEND_NUM_ARGS(), "l|d", &table_size, &conflict_proportion) == FAILURE)
+    if (zend_parse_parameters(ZEND_NUM_ARGS(), "l|dll", &table_size, &conflict_proportion, &layout, &max_size) == FAILURE)
     {
         RETURN_FALSE;
     }
+    if (layout != SW_TABLE_LAYOUT_CHAIN && layout != SW_TABLE_LAYOUT_OPEN_ADDRESSING)
+    {
+        zend_throw_exception_ex(swoole_exception_ce_ptr, SW_ERROR_INVALID_PARAMS, "unknown table layout[" ZEND_LONG_FMT "].", layout);
+        RETURN_FALSE;
+    }
 
     swTable *table = swTable_new(table_size, conflict_proportion);
     if (table == NULL)
@@ -297,6 +308,23 @@ PHP_METHOD(swoole_table, __construct)
         zend_throw_exception(swoole_exception_ce_ptr, "global memory allocation failure.", SW_ERROR_MALLOC_FAIL);
         RETURN_FALSE;
     }
+    table->layout = layout;
+    if (max_size > table->size)
+    {
+        if (layout != SW_TABLE_LAYOUT_OPEN_ADDRESSING)
+        {
+            swoole_php_fatal_error(E_WARNING, "only the open addressing layout can grow online, max_size is ignored.");
+        }
+        else
+        {
+            //a power of two, like the size
+            table->max_size = table->size;
+            while (table->max_size < max_size && table->max_size < 0x80000000)
+            {
+                table->max_size *= 2;
+            }
+        }
+    }
     swoole_set_object(getThis(), table);
 }
 
@@ -594,7 +622,6 @@ static PHP_METHOD(swoole_table, get)
         RETURN_FALSE;
     }
 
-    swTableRow *_rowlock = NULL;
     swTable *table = swoole_get_object(getThis());
     if (!table->memory)
     {
@@ -602,7 +629,7 @@ static PHP_METHOD(swoole_table, get)
         RETURN_FALSE;
     }
 
-    swTableRow *row = swTableRow_get(table, key, keylen, &_rowlock);
+    swTableRow *row = swTableRow_read(table, key, keylen);
     if (!row)
     {
         RETVAL_FALSE;
@@ -615,7 +642,6 @@ static PHP_METHOD(swoole_table, get)
     {
         php_swoole_table_row2array(table, row, return_value);
     }
-    swTableRow_unlock(_rowlock);
 }
 
 static PHP_METHOD(swoole_table, offsetGet)
@@ -630,7 +656,6 @@ static PHP_METHOD(swoole_table, offsetGet)
         RETURN_FALSE;
     }
 
-    swTableRow *_rowlock = NULL;
     swTable *table = swoole_get_object(getThis());
     if (!table->memory)
     {
@@ -641,7 +666,7 @@ static PHP_METHOD(swoole_table, offsetGet)
     zval *value;
     SW_MAKE_STD_ZVAL(value);
 
-    swTableRow *row = swTableRow_get(table, key, keylen, &_rowlock);
+    swTableRow *row = swTableRow_read(table, key, keylen);
     if (!row)
     {
         array_init(value);
@@ -650,7 +675,6 @@ static PHP_METHOD(swoole_table, offsetGet)
     {
         php_swoole_table_row2array(table, row, value);
     }
-    swTableRow_unlock(_rowlock);
 
     object_init_ex(return_value, swoole_table_row_ce_ptr);
     zend_update_property(swoole_table_row_ce_ptr, return_value, ZEND_STRL("value"), value);
@@ -676,9 +700,7 @@ static PHP_METHOD(swoole_table, exist)
         RETURN_FALSE;
     }
 
-    swTableRow *_rowlock = NULL;
-    swTableRow *row = swTableRow_get(table, key, keylen, &_rowlock);
-    swTableRow_unlock(_rowlock);
+    swTableRow *row = swTableRow_read(table, key, keylen);
     if (!row)
     {
         RETURN_FALSE;
@@ -781,9 +803,10 @@ static PHP_METHOD(swoole_table, current)
         RETURN_FALSE;
     }
     swTableRow *row = swTable_iterator_current(table);
-    swTableRow_lock(row);
+    swTableRow *_rowlock = swTableRow_get_lock(table, row);
+    swTableRow_lock(_rowlock);
     php_swoole_table_row2array(table, row, return_value);
-    swTableRow_unlock(row);
+    swTableRow_unlock(_rowlock);
 }
 
 static PHP_METHOD(swoole_table, key)
@@ -795,9 +818,10 @@ static PHP_METHOD(swoole_table, key)
         RETURN_FALSE;
     }
     swTableRow *row = swTable_iterator_current(table);
-    swTableRow_lock(row);
+    swTableRow *_rowlock = swTableRow_get_lock(table, row);
+    swTableRow_lock(_rowlock);
     RETVAL_STRING(row->key);
-    swTableRow_unlock(row);
+    swTableRow_unlock(_rowlock);
 }
 
 static PHP_METHOD(swoole_table, next)
@@ -42,28 +42,24 @@ typedef struct _swTimer_callback
 
 static int php_swoole_del_timer(swTimer_node *tnode);
 
-void php_swoole_clear_all_timer()
+static void php_swoole_clear_timer(swTimer *timer, swTimer_node *tnode)
 {
-    if (!SwooleG.timer.map)
+    if (tnode->type != SW_TIMER_TYPE_PHP)
     {
         return;
     }
-    uint64_t timer_id;
-    //kill user process
-    while (1)
+    php_swoole_del_timer(tnode);
+    swTimer_del(timer, tnode);
+}
+
+void php_swoole_clear_all_timer()
+{
+    if (!SwooleG.timer.initialized)
     {
-        swTimer_node *tnode = (swTimer_node *) swHashMap_each_int(SwooleG.timer.map, &timer_id);
-        if (tnode == NULL)
-        {
-            break;
-        }
-        if (tnode->type != SW_TIMER_TYPE_PHP)
-        {
-            continue;
-        }
-        php_swoole_del_timer(tnode);
-        swTimer_del(&SwooleG.timer, tnode);
+        return;
     }
+    //kill user process
+    swTimer_each(&SwooleG.timer, php_swoole_clear_timer);
 }
 
 long php_swoole_add_timer(long ms, zval *callback, zval *param, int persistent)
@@ -288,7 +288,7 @@ void php_swoole_sha1(const char *str, int _len, unsigned char *digest)
 
 static int websocket_handshake(swServer *serv, swListenPort *port, http_context *ctx)
 {
-    zval *header = ctx->request.zheader;
+    zval *header = sw_zend_read_property(swoole_http_request_ce_ptr, ctx->request.zobject, ZEND_STRL("header"), 1);
     HashTable *ht = Z_ARRVAL_P(header);
     zval *pData;
 
@@ -35,47 +35,67 @@ var_dump(co::stats());
 --EXPECTF--
 
 default 2M
-array(3) {
+array(5) {
   ["c_stack_size"]=>
   int(2097152)
   ["coroutine_num"]=>
   int(0)
   ["coroutine_peak_num"]=>
   int(0)
+  ["stack_pool_num"]=>
+  int(0)
+  ["stack_pool_hit_rate"]=>
+  float(0)
 }
 1M
-array(3) {
+array(5) {
   ["c_stack_size"]=>
   int(1048576)
   ["coroutine_num"]=>
   int(100)
   ["coroutine_peak_num"]=>
   int(100)
+  ["stack_pool_num"]=>
+  int(0)
+  ["stack_pool_hit_rate"]=>
+  float(0)
 }
 4K
-array(3) {
+array(5) {
   ["c_stack_size"]=>
   int(4096)
   ["coroutine_num"]=>
   int(200)
   ["coroutine_peak_num"]=>
   int(200)
+  ["stack_pool_num"]=>
+  int(0)
+  ["stack_pool_hit_rate"]=>
+  float(0)
 }
 16M
-array(3) {
+array(5) {
   ["c_stack_size"]=>
   int(16777216)
   ["coroutine_num"]=>
   int(300)
   ["coroutine_peak_num"]=>
   int(300)
+  ["stack_pool_num"]=>
+  int(0)
+  ["stack_pool_hit_rate"]=>
+  float(0)
 }
 16M
-array(3) {
+array(5) {
   ["c_stack_size"]=>
   int(16777216)
   ["coroutine_num"]=>
   int(400)
   ["coroutine_peak_num"]=>
   int(400)
+  ["stack_pool_num"]=>
+  int(0)
+  ["stack_pool_hit_rate"]=>
+  float(0)
 }
@@ -0,0 +1,68 @@
+--TEST--
+swoole_coroutine: connection pool with waiters, timeouts and idle reaping
+--SKIPIF--
+<?php require __DIR__ . '/../include/skipif.inc'; ?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+go(function () {
+    $id = 0;
+    $pool = new Co\ConnectionPool(function () use (&$id) {
+        co::sleep(0.001);
+        $conn = new stdClass;
+        $conn->id = ++$id;
+        return $conn;
+    }, 2);
+    $pool->set(['min_size' => 1, 'idle_time' => 0.1]);
+    assert($pool->fill());
+    assert($pool->stats()['idle_num'] === 1);
+
+    $a = $pool->get();
+    $b = $pool->get();
+    assert($a->id === 1 and $b->id === 2);
+    //the pool is exhausted
+    assert($pool->get(0.01) === false);
+    assert($pool->stats()['timeout_num'] === 1);
+
+    go(function () use ($pool, $b) {
+        co::sleep(0.01);
+        $pool->put($b);
+    });
+    assert($pool->get(1) === $b);
+    assert($pool->stats()['waiter_num'] === 0);
+
+    //a broken connection gives its slot back
+    go(function () use ($pool) {
+        co::sleep(0.01);
+        $pool->put(null);
+    });
+    assert($pool->get(1)->id === 3);
+    assert($pool->stats()['broken_num'] === 1);
+
+    $pool->put($a);
+    co::sleep(0.3);
+    $stats = $pool->stats();
+    assert($stats['connection_num'] === 1 and $stats['idle_num'] === 0 and $stats['created_num'] === 3);
+
+    $redis_pool = new Co\ConnectionPool(function () {
+        $redis = new Co\Redis;
+        return $redis->connect(REDIS_SERVER_HOST, REDIS_SERVER_PORT) ? $redis : false;
+    });
+    $redis = $redis_pool->get();
+    assert($redis->set('pool', 'ok'));
+    $redis->close();
+    $redis_pool->put($redis);
+    //the closed one is dropped
+    $redis = $redis_pool->get();
+    assert($redis->get('pool') === 'ok');
+    assert($redis_pool->stats()['broken_num'] === 1);
+
+    assert($pool->close());
+    assert($pool->get() === false);
+    echo "DONE\n";
+});
+swoole_event_wait();
+?>
+--EXPECT--
+DONE
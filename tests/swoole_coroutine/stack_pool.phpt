@@ -0,0 +1,30 @@
+--TEST--
+swoole_coroutine: reuse the c stacks of finished coroutines
+--SKIPIF--
+<?php require __DIR__ . '/../include/skipif.inc'; ?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+for ($i = 0; $i < 100; $i++) {
+    go(function () { });
+}
+assert(Co::stats()['stack_pool_num'] === 1);
+assert(Co::stats()['stack_pool_hit_rate'] === 0.99);
+
+for ($i = 0; $i < 10; $i++) {
+    go(function () {
+        co::sleep(0.001);
+    });
+}
+swoole_event_wait();
+assert(Co::stats()['stack_pool_num'] === 10);
+
+//the stacks of the old size are released
+co::set(['c_stack_size' => 1024 * 1024]);
+go(function () { });
+assert(Co::stats()['stack_pool_num'] === 1);
+echo "DONE\n";
+?>
+--EXPECT--
+DONE
@@ -0,0 +1,81 @@
+--TEST--
+swoole_http_server: cached compression and precompressed static files
+--SKIPIF--
+<?php require  __DIR__ . '/../include/skipif.inc'; ?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+$root = sys_get_temp_dir() . '/swoole_gzip_static_' . getmypid();
+@mkdir($root);
+$script = str_repeat('console.log("hello");', 100);
+file_put_contents("{$root}/app.js", $script);
+file_put_contents("{$root}/app.js.gz", gzencode($script));
+
+function gzipGet(string $url, &$headers = null, string $accept = 'gzip'): string
+{
+    $context = stream_context_create(['http' => ['header' => "Accept-Encoding: {$accept}\r\n"]]);
+    $data = file_get_contents($url, false, $context);
+    $headers = $http_response_header;
+    return in_array('Content-Encoding: gzip', $headers) ? gzdecode($data) : $data;
+}
+
+$pm = new ProcessManager;
+$pm->parentFunc = function ($pid) use ($pm, $script)
+{
+    $base = "http://127.0.0.1:{$pm->getFreePort()}";
+    //the same body is compressed once and then served from the cache
+    for ($i = 0; $i < 3; $i++) {
+        assert(gzipGet("{$base}/json", $headers) === json_encode(range(1, 1000)));
+        assert(in_array('Content-Encoding: gzip', $headers));
+        assert(gzipGet("{$base}/json?n={$i}") === json_encode(range(1, 1000 + $i)));
+    }
+    //the static handler picks app.js.gz
+    assert(gzipGet("{$base}/app.js", $headers) === $script);
+    assert(in_array('Content-Encoding: gzip', $headers));
+    assert(in_array('Content-Type: application/javascript', $headers));
+    assert(file_get_contents("{$base}/app.js") === $script);
+    //the codings are whole tokens, q=0 refuses one
+    assert(gzipGet("{$base}/app.js", $headers, 'GZIP, br;q=0.5') === $script);
+    assert(in_array('Content-Encoding: gzip', $headers));
+    assert(gzipGet("{$base}/app.js", $headers, 'gzip;q=0') === $script);
+    assert(!in_array('Content-Encoding: gzip', $headers));
+    assert(gzipGet("{$base}/app.js", $headers, 'identity, gzip ; q=0.000') === $script);
+    assert(!in_array('Content-Encoding: gzip', $headers));
+    assert(gzipGet("{$base}/app.js", $headers, 'x-gzip') === $script);
+    assert(!in_array('Content-Encoding: gzip', $headers));
+    echo "DONE\n";
+    swoole_process::kill($pid);
+};
+
+$pm->childFunc = function () use ($pm, $root)
+{
+    $http = new swoole_http_server('127.0.0.1', $pm->getFreePort(), SWOOLE_BASE, SWOOLE_SOCK_TCP);
+
+    $http->set([
+        'log_file' => '/dev/null',
+        'http_compression' => true,
+        'http_compression_cache' => 16,
+        'enable_static_handler' => true,
+        'document_root' => $root,
+    ]);
+
+    $http->on("WorkerStart", function ($serv, $wid) use ($pm) {
+        $pm->wakeup();
+    });
+
+    $http->on("request", function ($request, swoole_http_response $response) {
+        $response->end(json_encode(range(1, 1000 + ($request->get['n'] ?? 0))));
+    });
+
+    $http->start();
+};
+
+$pm->childFirst();
+$pm->run();
+unlink("{$root}/app.js");
+unlink("{$root}/app.js.gz");
+@rmdir($root);
+?>
+--EXPECT--
+DONE
@@ -0,0 +1,51 @@
+--TEST--
+swoole_http_server: request headers split across many packets
+--SKIPIF--
+<?php require __DIR__ . '/../include/skipif.inc'; ?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+$pm = new ProcessManager;
+$pm->parentFunc = function ($pid) use ($pm) {
+    $client = stream_socket_client("tcp://127.0.0.1:{$pm->getFreePort()}");
+    $body = str_repeat('x', 1000);
+    $request = "POST /post HTTP/1.1\r\nHost: 127.0.0.1\r\nX-Padding: " . str_repeat('a', 200) .
+        "\r\nCONTENT-LENGTH: " . strlen($body) . "\r\ncOnNeCtIoN: keep-alive\r\n\r\n";
+    //the terminator itself is split too
+    foreach (str_split($request, 7) as $chunk) {
+        fwrite($client, $chunk);
+        usleep(1000);
+    }
+    fwrite($client, $body);
+    $response = fread($client, 8192);
+    assert(strpos($response, 'Connection: keep-alive') !== false);
+    assert(substr($response, -4) === '1000');
+
+    //the connection is kept for the next request
+    fwrite($client, "GET /get HTTP/1.1\r\nHost: 127.0.0.1\r\n\r");
+    usleep(10000);
+    fwrite($client, "\n");
+    $response = fread($client, 8192);
+    assert(substr($response, -1) === '0');
+    echo "DONE\n";
+    $pm->kill();
+};
+
+$pm->childFunc = function () use ($pm) {
+    $http = new swoole_http_server('127.0.0.1', $pm->getFreePort(), SWOOLE_BASE);
+    $http->set(['log_file' => '/dev/null']);
+    $http->on("WorkerStart", function ($serv, $wid) use ($pm) {
+        $pm->wakeup();
+    });
+    $http->on("request", function (swoole_http_request $request, swoole_http_response $response) {
+        $response->end(strlen($request->rawContent()));
+    });
+    $http->start();
+};
+
+$pm->childFirst();
+$pm->run();
+?>
+--EXPECT--
+DONE
@@ -0,0 +1,50 @@
+--TEST--
+swoole_http_server: request arrays are built on the first access
+--SKIPIF--
+<?php require __DIR__ . '/../include/skipif.inc'; ?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+$pm = new ProcessManager;
+$pm->parentFunc = function ($pid) use ($pm) {
+    $client = stream_socket_client("tcp://127.0.0.1:{$pm->getFreePort()}");
+    $body = 'a=1&b[]=2';
+    fwrite($client, "POST /index.php?id=7&name=swoole HTTP/1.1\r\nHost: 127.0.0.1\r\nX-Token: abc\r\n" .
+        "Cookie: uid=9; lang=zh\r\nContent-Type: application/x-www-form-urlencoded\r\n" .
+        "Content-Length: " . strlen($body) . "\r\n\r\n{$body}");
+    $response = fread($client, 8192);
+    list(, $result) = explode("\r\n\r\n", $response, 2);
+    echo $result, "\n";
+    $pm->kill();
+};
+
+$pm->childFunc = function () use ($pm) {
+    $http = new swoole_http_server('127.0.0.1', $pm->getFreePort(), SWOOLE_BASE);
+    $http->set(['log_file' => '/dev/null']);
+    $http->on("WorkerStart", function ($serv, $wid) use ($pm) {
+        $pm->wakeup();
+    });
+    $http->on("request", function (swoole_http_request $request, swoole_http_response $response) {
+        assert($request->get === ['id' => '7', 'name' => 'swoole']);
+        assert(isset($request->cookie['uid']) and $request->cookie['lang'] === 'zh');
+        assert($request->post === ['a' => '1', 'b' => ['2']]);
+        assert(!isset($request->header['cookie']));
+        $request->header['x-token'] .= 'd';
+        assert($request->header['x-token'] === 'abcd');
+        //overwritten before it is built
+        $request->server = ['request_uri' => '/'];
+        $vars = get_object_vars($request);
+        assert($vars['server'] === ['request_uri' => '/']);
+        assert($vars['files'] === null);
+        $response->end('OK');
+        assert($request->header['host'] === '127.0.0.1');
+    });
+    $http->start();
+};
+
+$pm->childFirst();
+$pm->run();
+?>
+--EXPECT--
+OK
@@ -0,0 +1,60 @@
+--TEST--
+swoole_http_server: cached static files are revalidated against the file system
+--SKIPIF--
+<?php require __DIR__ . '/../include/skipif.inc'; ?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+$root = sys_get_temp_dir() . '/swoole_static_' . getmypid();
+@mkdir($root);
+file_put_contents("{$root}/app.css", 'body { color: red; }');
+
+$pm = new ProcessManager;
+$pm->parentFunc = function ($pid) use ($pm, $root) {
+    $url = "http://127.0.0.1:{$pm->getFreePort()}/app.css";
+    for ($i = 0; $i < 3; $i++) {
+        assert(file_get_contents($url) === 'body { color: red; }');
+    }
+    $last_modified = gmdate('D, d M Y H:i:s', filemtime("{$root}/app.css")) . ' GMT';
+    $context = stream_context_create(['http' => ['header' => "If-Modified-Since: {$last_modified}"]]);
+    file_get_contents($url, false, $context);
+    assert(strpos($http_response_header[0], '304') !== false);
+
+    //changes show up after one revalidation interval
+    sleep(1);
+    file_put_contents("{$root}/app.css", 'body { color: blue; }');
+    touch("{$root}/app.css", time() + 2);
+    sleep(1);
+    assert(file_get_contents($url) === 'body { color: blue; }');
+
+    //a removed file goes to the request callback
+    unlink("{$root}/app.css");
+    sleep(1);
+    assert(file_get_contents($url) === 'dynamic');
+    echo "DONE\n";
+    $pm->kill();
+};
+
+$pm->childFunc = function () use ($pm, $root) {
+    $http = new swoole_http_server('127.0.0.1', $pm->getFreePort(), SWOOLE_BASE);
+    $http->set([
+        'log_file' => '/dev/null',
+        'enable_static_handler' => true,
+        'document_root' => $root,
+    ]);
+    $http->on("WorkerStart", function ($serv, $wid) use ($pm) {
+        $pm->wakeup();
+    });
+    $http->on("request", function (swoole_http_request $request, swoole_http_response $response) {
+        $response->end('dynamic');
+    });
+    $http->start();
+};
+
+$pm->childFirst();
+$pm->run();
+@rmdir($root);
+?>
+--EXPECT--
+DONE
@@ -0,0 +1,60 @@
+--TEST--
+swoole_http_server: the static file cache evicts the least recently used files
+--SKIPIF--
+<?php require __DIR__ . '/../include/skipif.inc'; ?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+// more than SW_HTTP_STATIC_CACHE_NUM
+const FILE_N = 1500;
+
+$root = sys_get_temp_dir() . '/swoole_static_lru_' . getmypid();
+@mkdir($root);
+for ($i = 0; $i < FILE_N; $i++) {
+    file_put_contents("{$root}/{$i}.txt", "file {$i}");
+}
+
+$pm = new ProcessManager;
+$pm->parentFunc = function ($pid) use ($pm, $root) {
+    $url = "http://127.0.0.1:{$pm->getFreePort()}";
+    for ($round = 0; $round < 2; $round++) {
+        for ($i = 0; $i < FILE_N; $i++) {
+            // the first file is kept hot while the others are evicted around it
+            assert(file_get_contents("{$url}/0.txt") === 'file 0');
+            assert(file_get_contents("{$url}/{$i}.txt") === "file {$i}");
+        }
+    }
+    sleep(1);
+    file_put_contents("{$root}/0.txt", 'changed');
+    touch("{$root}/0.txt", time() + 2);
+    sleep(1);
+    assert(file_get_contents("{$url}/0.txt") === 'changed');
+    echo "DONE\n";
+    $pm->kill();
+};
+
+$pm->childFunc = function () use ($pm, $root) {
+    $http = new swoole_http_server('127.0.0.1', $pm->getFreePort(), SWOOLE_BASE);
+    $http->set([
+        'log_file' => '/dev/null',
+        'enable_static_handler' => true,
+        'document_root' => $root,
+    ]);
+    $http->on("WorkerStart", function ($serv, $wid) use ($pm) {
+        $pm->wakeup();
+    });
+    $http->on("request", function (swoole_http_request $request, swoole_http_response $response) {
+        $response->end('dynamic');
+    });
+    $http->start();
+};
+
+$pm->childFirst();
+$pm->run();
+for ($i = 0; $i < FILE_N; $i++) {
+    @unlink("{$root}/{$i}.txt");
+}
+@rmdir($root);
+?>
+--EXPECT--
+DONE
@@ -0,0 +1,42 @@
+--TEST--
+swoole_mysql_coro: reuse the prepared statements of a connection
+--SKIPIF--
+<?php require __DIR__ . '/../include/skipif.inc'; ?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+go(function () {
+    $db = new Swoole\Coroutine\Mysql;
+    $server = [
+        'host' => MYSQL_SERVER_HOST,
+        'user' => MYSQL_SERVER_USER,
+        'password' => MYSQL_SERVER_PWD,
+        'database' => MYSQL_SERVER_DB,
+        'statement_cache' => 2
+    ];
+    assert($db->connect($server));
+
+    $stmt1 = $db->prepare('SELECT ? + 1 AS n');
+    assert($stmt1->execute([1])[0]['n'] == 2);
+    $stmt2 = $db->prepare('SELECT ? + 1 AS n');
+    assert($stmt2 === $stmt1);
+    assert($stmt2->execute([2])[0]['n'] == 3);
+
+    // the least recently used one is evicted
+    assert($db->prepare('SELECT ? + 2 AS n')->execute([1])[0]['n'] == 3);
+    assert($db->prepare('SELECT ? + 3 AS n')->execute([1])[0]['n'] == 4);
+    assert($db->prepare('SELECT ? + 1 AS n') !== $stmt1);
+    assert($db->getStatementCacheStats() === ['capacity' => 2, 'hits' => 1, 'misses' => 4]);
+
+    // prepared again after reconnecting
+    $db->close();
+    assert($db->connect($server));
+    $stmt = $db->prepare('SELECT ? + 3 AS n');
+    assert($stmt->execute([2])[0]['n'] == 5);
+    assert($db->prepare('SELECT ? + 3 AS n') === $stmt);
+    assert($db->getStatementCacheStats()['misses'] === 5);
+    echo "DONE\n";
+});
+?>
+--EXPECT--
+DONE
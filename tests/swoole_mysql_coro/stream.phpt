@@ -0,0 +1,52 @@
+--TEST--
+swoole_mysql_coro: stream the rows of a result set
+--SKIPIF--
+<?php require __DIR__ . '/../include/skipif.inc'; ?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+go(function () {
+    $db = new Swoole\Coroutine\Mysql;
+    $server = [
+        'host' => MYSQL_SERVER_HOST,
+        'user' => MYSQL_SERVER_USER,
+        'password' => MYSQL_SERVER_PWD,
+        'database' => MYSQL_SERVER_DB,
+        'stream' => true,
+        'stream_batch' => 8
+    ];
+    assert($db->connect($server));
+
+    $table_name = get_safe_random(16);
+    $row_num = [100, 200, 1000, 3000][PRESSURE_LEVEL];
+    assert($db->query("CREATE TABLE {$table_name} (\nid bigint PRIMARY KEY AUTO_INCREMENT,\n`content` text NOT NULL\n);"));
+    $statement = $db->prepare("INSERT INTO {$table_name} (`content`) VALUES " . rtrim(str_repeat('(?), ', $row_num), ', '));
+    $random = [];
+    for ($n = 0; $n < $row_num; $n++) {
+        $random[$n] = get_safe_random(64);
+    }
+    assert($statement->execute($random));
+
+    // query() returns once the columns are known
+    assert($db->query("SELECT * FROM {$table_name}") === true);
+    assert(@$db->query('SELECT 1') === false);
+    $n = 0;
+    while ($row = $db->fetch()) {
+        assert($row['content'] === $random[$n++]);
+    }
+    assert($row === null);
+    assert($n === $row_num);
+
+    $statement = $db->prepare("SELECT * FROM {$table_name} WHERE id > ?");
+    assert($statement->execute([0]) === true);
+    assert($statement->fetch()['content'] === $random[0]);
+    $rest = $statement->fetchAll();
+    assert(count($rest) === $row_num - 1);
+    assert(end($rest)['content'] === $random[$row_num - 1]);
+
+    assert($db->query("DROP TABLE {$table_name}") === true);
+    echo "DONE\n";
+});
+?>
+--EXPECT--
+DONE
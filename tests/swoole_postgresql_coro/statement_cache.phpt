@@ -0,0 +1,50 @@
+--TEST--
+swoole_postgresql_coro: prepare and execute through the statement cache
+--SKIPIF--
+<?php
+require __DIR__ . '/../include/skipif.inc';
+skip_if_class_not_exist('Swoole\Coroutine\PostgreSQL');
+?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+$conninfo = getenv('SWOOLE_PGSQL_CONNINFO') ?: 'host=127.0.0.1 port=5432 dbname=test user=root password=root';
+
+go(function () use ($conninfo) {
+    $pg = new Swoole\Coroutine\PostgreSQL;
+    assert($pg->connect($conninfo, ['statement_cache' => 2]));
+
+    $select = function (string $name, int $n) use ($pg) {
+        $result = $pg->execute($name, [$n]);
+        assert($result !== false);
+        return (int) $pg->fetchAll($result)[0]['n'];
+    };
+
+    assert($pg->prepare('plus1', 'SELECT $1::int + 1 AS n'));
+    assert($select('plus1', 1) === 2);
+    // the same sql under another name takes the cached statement
+    assert($pg->prepare('plus1_again', 'SELECT $1::int + 1 AS n'));
+    assert($select('plus1_again', 2) === 3);
+
+    // the least recently used statements are evicted and deallocated before the next miss
+    assert($pg->prepare('plus2', 'SELECT $1::int + 2 AS n'));
+    assert($pg->prepare('plus3', 'SELECT $1::int + 3 AS n'));
+    assert($pg->prepare('plus4', 'SELECT $1::int + 4 AS n'));
+    assert($select('plus3', 1) === 4);
+    assert($select('plus4', 1) === 5);
+    // prepared again after its eviction
+    assert($select('plus1', 5) === 6);
+    // the connection is still in sync, plain queries work
+    $result = $pg->query('SELECT 42 AS n');
+    assert((int) $pg->fetchAll($result)[0]['n'] === 42);
+
+    // a failed prepare leaves nothing behind
+    assert($pg->prepare('broken', 'SELECT FROM WHERE') === false);
+    assert($select('plus4', 2) === 6);
+
+    assert($pg->getStatementCacheStats() === ['capacity' => 2, 'hits' => 6, 'misses' => 6]);
+    echo "DONE\n";
+});
+?>
+--EXPECT--
+DONE
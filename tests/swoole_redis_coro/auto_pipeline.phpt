@@ -0,0 +1,36 @@
+--TEST--
+swoole_redis_coro: commands of concurrent coroutines are pipelined on one connection
+--SKIPIF--
+<?php require __DIR__ . '/../include/skipif.inc'; ?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+$redis = new Swoole\Coroutine\Redis(['auto_pipeline' => true]);
+go(function () use ($redis) {
+    assert($redis->connect(REDIS_SERVER_HOST, REDIS_SERVER_PORT));
+    $redis->del('auto_pipeline');
+    for ($c = 0; $c < MAX_CONCURRENCY; $c++) {
+        go(function () use ($redis, $c) {
+            for ($n = 0; $n < MAX_REQUESTS; $n++) {
+                assert($redis->set("auto_pipeline_{$c}", "{$c}_{$n}"));
+                assert($redis->get("auto_pipeline_{$c}") === "{$c}_{$n}");
+                assert($redis->incr('auto_pipeline') > 0);
+            }
+            $redis->del("auto_pipeline_{$c}");
+        });
+    }
+});
+swoole_event_wait();
+
+go(function () use ($redis) {
+    assert((int) $redis->get('auto_pipeline') === MAX_CONCURRENCY * MAX_REQUESTS);
+    //the next batch connects again
+    $redis->close();
+    assert($redis->get('auto_pipeline') !== false);
+    echo "DONE\n";
+});
+swoole_event_wait();
+?>
+--EXPECT--
+DONE
@@ -0,0 +1,30 @@
+--TEST--
+swoole_redis_coro: the commands changing the state of the connection are refused with auto_pipeline
+--SKIPIF--
+<?php require __DIR__ . '/../include/skipif.inc'; ?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+go(function () {
+    $redis = new Swoole\Coroutine\Redis(['auto_pipeline' => true]);
+    assert($redis->connect(REDIS_SERVER_HOST, REDIS_SERVER_PORT));
+    assert($redis->multi() === false);
+    echo $redis->errMsg, "\n";
+    assert($redis->select(1) === false);
+    echo $redis->errMsg, "\n";
+    assert($redis->request(['watch', 'auto_pipeline']) === false);
+    echo $redis->errMsg, "\n";
+    assert($redis->set('auto_pipeline', 'stateful'));
+    assert($redis->get('auto_pipeline') === 'stateful');
+    assert(!isset($redis->setting['database']));
+    $redis->del('auto_pipeline');
+    echo "DONE\n";
+});
+swoole_event_wait();
+?>
+--EXPECT--
+MULTI cannot be used with auto_pipeline.
+SELECT cannot be used with auto_pipeline.
+WATCH cannot be used with auto_pipeline.
+DONE
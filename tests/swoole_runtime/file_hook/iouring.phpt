@@ -0,0 +1,47 @@
+--TEST--
+swoole_runtime: file operations with and without io_uring
+--SKIPIF--
+<?php require __DIR__ . '/../../include/skipif.inc'; ?>
+--FILE--
+<?php
+require __DIR__ . '/../../include/bootstrap.php';
+\Swoole\Runtime::enableCoroutine();
+
+function test_file_ops(string $dir)
+{
+    assert(mkdir($dir));
+    $file = "{$dir}/a.log";
+    $fp = fopen($file, 'w+');
+    for ($i = 0; $i < 100; $i++) {
+        assert(fwrite($fp, "line {$i}\n") > 0);
+    }
+    assert(fstat($fp)['size'] === filesize($file));
+    fclose($fp);
+
+    assert(Co::writeFile($file, "tail\n", FILE_APPEND) === 5);
+    $content = Co::readFile($file);
+    assert(strpos($content, "line 99\ntail\n") !== false);
+    assert($content === file_get_contents($file));
+    assert(Co::readFile($dir) === false);
+    //the write fails with ENOSPC
+    assert(Co::writeFile('/dev/full', 'x') === false);
+
+    assert(rename($file, "{$dir}/b.log"));
+    assert(!file_exists($file));
+    assert(unlink("{$dir}/b.log"));
+    assert(!@unlink("{$dir}/b.log"));
+    assert(rmdir($dir));
+}
+
+foreach ([true, false] as $use_iouring) {
+    swoole_async_set(['use_iouring' => $use_iouring]);
+    go(function () use ($use_iouring) {
+        test_file_ops('/tmp/swoole_iouring_' . (int) $use_iouring);
+        echo "DONE\n";
+    });
+    swoole_event_wait();
+}
+?>
+--EXPECT--
+DONE
+DONE
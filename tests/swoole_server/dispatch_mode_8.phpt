@@ -0,0 +1,51 @@
+--TEST--
+swoole_server: dispatch_mode = 8 [least load, power of two choices]
+--SKIPIF--
+<?php require __DIR__ . '/../include/skipif.inc'; ?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+$pm = new ProcessManager;
+$pm->parentFunc = function ($pid) use ($pm) {
+    $slow = new swoole_client(SWOOLE_SOCK_TCP, SWOOLE_SOCK_SYNC);
+    assert($slow->connect('127.0.0.1', $pm->getFreePort()));
+    $quick = new swoole_client(SWOOLE_SOCK_TCP, SWOOLE_SOCK_SYNC);
+    assert($quick->connect('127.0.0.1', $pm->getFreePort()));
+    assert($slow->send('slow'));
+    usleep(100 * 1000);
+    $workers = [];
+    for ($n = 0; $n < 40; $n++) {
+        assert($quick->send('quick'));
+        $workers[] = (int) $quick->recv();
+    }
+    $slow_worker = (int) $slow->recv();
+    // the busy worker is never picked while it is one of the two choices
+    echo in_array($slow_worker, $workers, true) ? "ERROR\n" : "OK\n";
+    echo count(array_unique($workers)) > 1 ? "OK\n" : "ERROR\n";
+    $pm->kill();
+};
+$pm->childFunc = function () use ($pm) {
+    $server = new swoole_server('127.0.0.1', $pm->getFreePort(), SWOOLE_PROCESS);
+    $server->set([
+        'log_file' => '/dev/null',
+        'worker_num' => 4,
+        'dispatch_mode' => 8,
+    ]);
+    $server->on('workerStart', function ($serv, $wid) use ($pm) {
+        $pm->wakeup();
+    });
+    $server->on('receive', function (swoole_server $server, $fd, $rid, $data) {
+        if ($data === 'slow') {
+            sleep(1);
+        }
+        $server->send($fd, $server->worker_id);
+    });
+    $server->start();
+};
+$pm->childFirst();
+$pm->run();
+?>
+--EXPECT--
+OK
+OK
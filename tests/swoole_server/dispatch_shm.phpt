@@ -0,0 +1,63 @@
+--TEST--
+swoole_server: dispatch big package through shared memory
+--SKIPIF--
+<?php require __DIR__ . '/../include/skipif.inc'; ?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+$port = get_one_free_port();
+
+$pm = new ProcessManager;
+$pm->parentFunc = function ($pid) use ($port)
+{
+    $client = new swoole_client(SWOOLE_SOCK_TCP, SWOOLE_SOCK_SYNC);
+    $client->set([
+        'open_length_check' => true,
+        'package_max_length' => 4 * 1024 * 1024,
+        'package_length_type' => 'N',
+        'package_length_offset' => 0,
+        'package_body_offset' => 4,
+    ]);
+    assert($client->connect(TCP_SERVER_HOST, $port, 1));
+    //the last one does not fit into the 1M ring and takes the pipe
+    foreach ([16 * 1024, 512 * 1024, 2 * 1024 * 1024] as $len) {
+        for ($i = 0; $i < 4; $i++) {
+            $data = random_bytes($len);
+            $client->send(pack('N', $len) . $data);
+            $resp = $client->recv();
+            assert(substr($resp, 4) === md5($data));
+        }
+    }
+    echo "DONE\n";
+    Swoole\Process::kill($pid);
+};
+
+$pm->childFunc = function () use ($pm, $port)
+{
+    $serv = new swoole_server(TCP_SERVER_HOST, $port, SWOOLE_PROCESS);
+    $serv->set([
+        'worker_num' => 2,
+        'log_file' => '/dev/null',
+        'dispatch_shm_size' => 1024 * 1024,
+        'open_length_check' => true,
+        'package_max_length' => 4 * 1024 * 1024,
+        'package_length_type' => 'N',
+        'package_length_offset' => 0,
+        'package_body_offset' => 4,
+    ]);
+    $serv->on("WorkerStart", function (\swoole_server $serv) use ($pm)
+    {
+        $pm->wakeup();
+    });
+    $serv->on("receive", function ($serv, $fd, $rid, $data)
+    {
+        $serv->send($fd, pack('N', 32) . md5(substr($data, 4)));
+    });
+    $serv->start();
+};
+
+$pm->childFirst();
+$pm->run();
+?>
+--EXPECT--
+DONE
@@ -0,0 +1,74 @@
+--TEST--
+swoole_server: the big packages discarded from the pipe buffer are given back to the dispatch ring
+--SKIPIF--
+<?php require __DIR__ . '/../include/skipif.inc'; ?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+const PACKAGE_N = 32;
+const PACKAGE_SIZE = 128 * 1024;
+
+$pm = new ProcessManager;
+$pm->parentFunc = function ($pid) use ($pm) {
+    $client = new swoole_client(SWOOLE_SOCK_TCP, SWOOLE_SOCK_SYNC);
+    $client->set([
+        'open_length_check' => true,
+        'package_length_type' => 'N',
+        'package_length_offset' => 0,
+        'package_body_offset' => 4,
+    ]);
+    assert($client->connect('127.0.0.1', $pm->getFreePort()));
+    for ($n = 0; $n < PACKAGE_N; $n++) {
+        $client->send(pack('N', PACKAGE_SIZE) . str_repeat('x', PACKAGE_SIZE));
+    }
+    // closed by the server while most of the packages still wait in the pipe buffer
+    assert($client->recv() === '');
+    usleep(500 * 1000);
+
+    $client = new swoole_client(SWOOLE_SOCK_TCP, SWOOLE_SOCK_SYNC);
+    $client->set([
+        'open_length_check' => true,
+        'package_length_type' => 'N',
+        'package_length_offset' => 0,
+        'package_body_offset' => 4,
+    ]);
+    assert($client->connect('127.0.0.1', $pm->getFreePort()));
+    $client->send(pack('N', 5) . 'stats');
+    echo substr($client->recv(), 4), "\n";
+    $pm->kill();
+};
+$pm->childFunc = function () use ($pm) {
+    $server = new swoole_server('127.0.0.1', $pm->getFreePort(), SWOOLE_PROCESS);
+    $server->set([
+        'log_file' => '/dev/null',
+        'worker_num' => 1,
+        'dispatch_shm_size' => 8 * 1024 * 1024,
+        'discard_timeout_request' => true,
+        'open_length_check' => true,
+        'package_max_length' => 4 * 1024 * 1024,
+        'package_length_type' => 'N',
+        'package_length_offset' => 0,
+        'package_body_offset' => 4,
+    ]);
+    $server->on('workerStart', function ($serv, $wid) use ($pm) {
+        $pm->wakeup();
+    });
+    $server->on('receive', function (swoole_server $server, $fd, $rid, $data) {
+        if (substr($data, 4) === 'stats') {
+            $body = json_encode($server->stats()['dispatch_shm_num']);
+            $server->send($fd, pack('N', strlen($body)) . $body);
+            return;
+        }
+        if ($server->exist($fd)) {
+            // the reactor queues the other packages meanwhile
+            usleep(300 * 1000);
+            $server->close($fd);
+        }
+    });
+    $server->start();
+};
+$pm->childFirst();
+$pm->run();
+?>
+--EXPECT--
+[0]
@@ -0,0 +1,49 @@
+--TEST--
+swoole_server: the reactor threads close the idle connections
+--SKIPIF--
+<?php
+require __DIR__ . '/../include/skipif.inc';
+skip_if_in_valgrind();
+?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+$pm = new ProcessManager;
+$pm->parentFunc = function ($pid) use ($pm) {
+    $idle = new swoole_client(SWOOLE_SOCK_TCP, SWOOLE_SOCK_SYNC);
+    assert($idle->connect('127.0.0.1', $pm->getFreePort()));
+    $active = new swoole_client(SWOOLE_SOCK_TCP, SWOOLE_SOCK_SYNC);
+    assert($active->connect('127.0.0.1', $pm->getFreePort()));
+    for ($n = 0; $n < 8; $n++) {
+        assert($active->send('ping'));
+        assert($active->recv() === 'pong');
+        usleep(500 * 1000);
+    }
+    // closed by the server
+    assert($idle->recv() === '');
+    echo "DONE\n";
+    $pm->kill();
+};
+$pm->childFunc = function () use ($pm) {
+    $server = new swoole_server('127.0.0.1', $pm->getFreePort(), SWOOLE_PROCESS);
+    $server->set([
+        'log_file' => '/dev/null',
+        'reactor_num' => 2,
+        'worker_num' => 2,
+        'heartbeat_check_interval' => 1,
+        'heartbeat_idle_time' => 2,
+    ]);
+    $server->on('workerStart', function ($serv, $wid) use ($pm) {
+        $pm->wakeup();
+    });
+    $server->on('receive', function (swoole_server $server, $fd, $rid, $data) {
+        $server->send($fd, 'pong');
+    });
+    $server->start();
+};
+$pm->childFirst();
+$pm->run();
+?>
+--EXPECT--
+DONE
@@ -0,0 +1,49 @@
+--TEST--
+swoole_server: the reactor stops reading while the worker is over its pipe backlog budget
+--SKIPIF--
+<?php require __DIR__ . '/../include/skipif.inc'; ?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+const PACKAGE_N = 256;
+const PACKAGE_SIZE = 65536;
+
+$pm = new ProcessManager;
+$pm->parentFunc = function ($pid) use ($pm) {
+    $client = new swoole_client(SWOOLE_SOCK_TCP, SWOOLE_SOCK_SYNC);
+    assert($client->connect('127.0.0.1', $pm->getFreePort()));
+    for ($n = 0; $n < PACKAGE_N; $n++) {
+        assert($client->send(str_pad($n, PACKAGE_SIZE - 2, '-') . "\r\n"));
+    }
+    echo $client->recv();
+    $pm->kill();
+};
+$pm->childFunc = function () use ($pm) {
+    $server = new swoole_server('127.0.0.1', $pm->getFreePort(), SWOOLE_PROCESS);
+    $server->set([
+        'log_file' => '/dev/null',
+        'worker_num' => 1,
+        'open_eof_split' => true,
+        'package_eof' => "\r\n",
+        'pipe_backlog_size' => 256 * 1024,
+    ]);
+    $server->on('workerStart', function ($serv, $wid) use ($pm) {
+        $pm->wakeup();
+    });
+    $server->on('receive', function (swoole_server $server, $fd, $rid, $data) {
+        static $count = 0, $max = 0, $ordered = true;
+        // a slow worker, the packages pile up on the reactor side
+        usleep(5000);
+        $ordered = $ordered && intval($data) === $count;
+        $max = max($max, $server->stats()['pipe_backlog_size'][0]);
+        if (++$count === PACKAGE_N) {
+            $server->send($fd, ($ordered && $max < 2 * 1024 * 1024) ? "OK\n" : "ERROR {$max}\n");
+        }
+    });
+    $server->start();
+};
+$pm->childFirst();
+$pm->run();
+?>
+--EXPECT--
+OK
@@ -0,0 +1,50 @@
+--TEST--
+swoole_server: every reactor thread accepts on a listen socket of its own
+--SKIPIF--
+<?php require __DIR__ . '/../include/skipif.inc'; skip_if_darwin(); ?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+const CLIENT_N = 32;
+const REACTOR_N = 4;
+
+$pm = new ProcessManager;
+$pm->parentFunc = function ($pid) use ($pm) {
+    $clients = [];
+    $server_fds = [];
+    for ($n = 0; $n < CLIENT_N; $n++) {
+        $client = new swoole_client(SWOOLE_SOCK_TCP, SWOOLE_SOCK_SYNC);
+        assert($client->connect('127.0.0.1', $pm->getFreePort()));
+        assert($client->send('info'));
+        list($server_fd, $reactor_id) = explode(' ', $client->recv());
+        assert($reactor_id >= 0 && $reactor_id < REACTOR_N);
+        $server_fds[$server_fd] = true;
+        // keep the connections open, the listen sockets are picked by the kernel
+        $clients[] = $client;
+    }
+    assert(count($server_fds) > 1);
+    $pm->kill();
+    echo "DONE\n";
+};
+$pm->childFunc = function () use ($pm) {
+    $server = new swoole_server('127.0.0.1', $pm->getFreePort(), SWOOLE_PROCESS);
+    $server->set([
+        'log_file' => '/dev/null',
+        'reactor_num' => REACTOR_N,
+        'worker_num' => REACTOR_N,
+        'enable_reuse_port' => true,
+    ]);
+    $server->on('workerStart', function ($serv, $wid) use ($pm) {
+        $pm->wakeup();
+    });
+    $server->on('receive', function (swoole_server $server, $fd, $rid, $data) {
+        $info = $server->getClientInfo($fd);
+        $server->send($fd, "{$info['server_fd']} {$info['reactor_id']}");
+    });
+    $server->start();
+};
+$pm->childFirst();
+$pm->run();
+?>
+--EXPECT--
+DONE
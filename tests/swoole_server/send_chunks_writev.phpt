@@ -0,0 +1,60 @@
+--TEST--
+swoole_server: the queued output chunks are flushed in order with writev
+--SKIPIF--
+<?php require __DIR__ . '/../include/skipif.inc'; ?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+const CHUNK_N = 2048;
+
+function chunk(int $n): string
+{
+    // different sizes, the partial writes stop in the middle of a chunk
+    return str_repeat(chr(ord('a') + $n % 26), 1000 + $n % 7919) . "\n";
+}
+
+$pm = new ProcessManager;
+$pm->parentFunc = function ($pid) use ($pm) {
+    $client = new swoole_client(SWOOLE_SOCK_TCP, SWOOLE_SOCK_SYNC);
+    assert($client->connect('127.0.0.1', $pm->getFreePort()));
+    assert($client->send('start'));
+    // let the chunks pile up in the output buffer of the server
+    usleep(300 * 1000);
+    $expect = '';
+    for ($n = 0; $n < CHUNK_N; $n++) {
+        $expect .= chunk($n);
+    }
+    $data = '';
+    while (strlen($data) < strlen($expect)) {
+        $recv = $client->recv(65536);
+        if (!$recv) {
+            break;
+        }
+        $data .= $recv;
+    }
+    echo $data === $expect ? "OK\n" : "ERROR\n";
+    $pm->kill();
+};
+$pm->childFunc = function () use ($pm) {
+    $server = new swoole_server('127.0.0.1', $pm->getFreePort(), SWOOLE_PROCESS);
+    $server->set([
+        'log_file' => '/dev/null',
+        'worker_num' => 1,
+        'buffer_output_size' => 32 * 1024 * 1024,
+        'socket_buffer_size' => 64 * 1024 * 1024,
+    ]);
+    $server->on('workerStart', function ($serv, $wid) use ($pm) {
+        $pm->wakeup();
+    });
+    $server->on('receive', function (swoole_server $server, $fd, $rid, $data) {
+        for ($n = 0; $n < CHUNK_N; $n++) {
+            assert($server->send($fd, chunk($n)));
+        }
+    });
+    $server->start();
+};
+$pm->childFirst();
+$pm->run();
+?>
+--EXPECT--
+OK
@@ -0,0 +1,56 @@
+--TEST--
+swoole_server: large task payloads in the shared memory arena
+--SKIPIF--
+<?php require __DIR__ . '/../../include/skipif.inc'; ?>
+--FILE--
+<?php
+require __DIR__ . '/../../include/bootstrap.php';
+$pm = new ProcessManager;
+
+$pm->parentFunc = function ($pid) use ($pm) {
+    for ($n = 0; $n < 4; $n++) {
+        $client = new swoole_client(SWOOLE_SOCK_TCP, SWOOLE_SOCK_SYNC);
+        assert($client->connect('127.0.0.1', $pm->getFreePort()));
+        assert($client->send("{$n}"));
+        echo $client->recv();
+    }
+    $pm->kill();
+};
+$pm->childFunc = function () use ($pm) {
+    $server = new swoole_server('127.0.0.1', $pm->getFreePort(), SWOOLE_PROCESS);
+    $server->set([
+        'log_file' => '/dev/null',
+        'worker_num' => 1,
+        'task_worker_num' => 2,
+        // two payloads of 1M at most, the other ones overflow to tmpfiles
+        'task_shm_size' => 2 * 1024 * 1024 + 2 * 65536,
+    ]);
+    $server->on('workerStart', function ($serv, $wid) use ($pm) {
+        $pm->wakeup();
+    });
+    $server->on('receive', function (swoole_server $server, $fd, $rid, $data) {
+        $size = 1024 * 1024 >> (int) $data;
+        $payload = str_repeat(chr(ord('a') + (int) $data), $size);
+        // the result of a task is released once it is read, the arena is reused
+        $results = $server->taskWaitMulti([$payload, $payload, $payload], 5);
+        $ok = count($results) === 3;
+        foreach ($results as $result) {
+            $ok = $ok && $result === strrev($payload);
+        }
+        $ok = $ok && $server->taskwait($payload, 5) === strrev($payload);
+        $server->send($fd, ($ok ? 'OK' : 'ERROR') . " {$size}\n");
+    });
+    $server->on('task', function (swoole_server $server, $task_id, $worker_id, $data) {
+        return strrev($data);
+    });
+    $server->on('finish', function () { });
+    $server->start();
+};
+$pm->childFirst();
+$pm->run();
+?>
+--EXPECT--
+OK 1048576
+OK 524288
+OK 262144
+OK 131072
@@ -0,0 +1,61 @@
+--TEST--
+swoole_server: idle task workers steal the tasks queued on the busy ones
+--SKIPIF--
+<?php require __DIR__ . '/../../include/skipif.inc'; ?>
+--FILE--
+<?php
+require __DIR__ . '/../../include/bootstrap.php';
+$pm = new ProcessManager;
+
+$pm->parentFunc = function ($pid) use ($pm) {
+    $client = new swoole_client(SWOOLE_SOCK_TCP, SWOOLE_SOCK_SYNC);
+    assert($client->connect('127.0.0.1', $pm->getFreePort()));
+    assert($client->send('start'));
+    echo $client->recv();
+    $pm->kill();
+};
+$pm->childFunc = function () use ($pm) {
+    $server = new swoole_server('127.0.0.1', $pm->getFreePort(), SWOOLE_PROCESS);
+    $server->set([
+        'log_file' => '/dev/null',
+        'worker_num' => 1,
+        'task_worker_num' => 2,
+        'task_enable_steal' => true,
+    ]);
+    $server->on('workerStart', function ($serv, $wid) use ($pm) {
+        $pm->wakeup();
+    });
+    $server->on('receive', function (swoole_server $server, $fd, $rid, $data) {
+        $server->fd = $fd;
+        $server->finished = [];
+        // the task worker#0 is held by the slow one, the others queued on it are taken by the task worker#1
+        $server->task('slow', 0);
+        for ($n = 0; $n < 8; $n++) {
+            $server->task("quick{$n}");
+        }
+    });
+    $server->on('task', function (swoole_server $server, $task_id, $worker_id, $data) {
+        if ($data === 'slow') {
+            sleep(1);
+        }
+        return $data;
+    });
+    $server->on('finish', function (swoole_server $server, $task_id, $data) {
+        $finished = $server->finished;
+        $finished[] = $data;
+        $server->finished = $finished;
+        if (count($finished) < 9) {
+            return;
+        }
+        $stats = $server->stats();
+        $ok = end($finished) === 'slow';
+        $ok = $ok && $stats['task_steal_count'] > 0 && $stats['task_queue_depth'] === [0, 0];
+        $server->send($server->fd, $ok ? "OK\n" : "ERROR\n");
+    });
+    $server->start();
+};
+$pm->childFirst();
+$pm->run();
+?>
+--EXPECT--
+OK
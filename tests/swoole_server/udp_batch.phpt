@@ -0,0 +1,65 @@
+--TEST--
+swoole_server: datagrams sent in one event loop round are flushed together in order
+--SKIPIF--
+<?php require __DIR__ . '/../include/skipif.inc'; ?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+const N = 200;
+$port = get_one_free_port();
+
+$pm = new ProcessManager;
+
+$pm->parentFunc = function ($pid) use ($port)
+{
+    $client = new swoole_client(SWOOLE_SOCK_UDP, SWOOLE_SOCK_SYNC);
+    $client->set(['socket_buffer_size' => 4 * 1024 * 1024]);
+    if (!$client->connect('127.0.0.1', $port, 1))
+    {
+        exit("connect failed\n");
+    }
+    for ($i = 0; $i < N; $i++)
+    {
+        $client->send("packet-{$i}");
+    }
+    $next = [];
+    for ($i = 0; $i < N * 2; $i++)
+    {
+        $data = $client->recv();
+        if ($data === false)
+        {
+            exit("recv timeout\n");
+        }
+        list($type, $n) = explode('-', $data);
+        //the two replies of a packet keep their order
+        assert(($next[$n] ?? 'packet') === $type);
+        $next[$n] = $type === 'packet' ? 'ack' : 'done';
+    }
+    assert(count(array_filter($next, function ($v) { return $v === 'done'; })) === N);
+    echo "DONE\n";
+    swoole_process::kill($pid);
+};
+
+$pm->childFunc = function () use ($pm, $port)
+{
+    $serv = new swoole_server('127.0.0.1', $port, SWOOLE_BASE, SWOOLE_SOCK_UDP);
+    $serv->set(['worker_num' => 1, 'log_file' => '/dev/null']);
+    $serv->on("workerStart", function ($serv) use ($pm)
+    {
+        $pm->wakeup();
+    });
+    $serv->on('packet', function ($serv, $data, $client)
+    {
+        assert($serv->sendto('256.0.0.1', $client['port'], $data) === false);
+        $serv->sendto($client['address'], $client['port'], $data);
+        $serv->sendto($client['address'], $client['port'], 'ack-' . explode('-', $data)[1]);
+    });
+    $serv->start();
+};
+
+$pm->childFirst();
+$pm->run();
+?>
+--EXPECT--
+DONE
@@ -0,0 +1,52 @@
+--TEST--
+swoole_server: a datagram rejected at flush time makes the next sendto report the real result
+--SKIPIF--
+<?php require __DIR__ . '/../include/skipif.inc'; ?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+$port = get_one_free_port();
+
+$pm = new ProcessManager;
+
+$pm->parentFunc = function ($pid) use ($port)
+{
+    $client = new swoole_client(SWOOLE_SOCK_UDP, SWOOLE_SOCK_SYNC);
+    if (!$client->connect('127.0.0.1', $port, 1))
+    {
+        exit("connect failed\n");
+    }
+    $client->send('start');
+    echo $client->recv(), "\n";
+    echo $client->recv(), "\n";
+    swoole_process::kill($pid);
+};
+
+$pm->childFunc = function () use ($pm, $port)
+{
+    $serv = new swoole_server('127.0.0.1', $port, SWOOLE_BASE, SWOOLE_SOCK_UDP);
+    $serv->set(['worker_num' => 1, 'log_file' => '/dev/null']);
+    $serv->on("workerStart", function ($serv) use ($pm)
+    {
+        $pm->wakeup();
+    });
+    $serv->on('packet', function ($serv, $data, $client)
+    {
+        //no SO_BROADCAST, the kernel rejects it once the queue is flushed
+        $queued = $serv->sendto('255.255.255.255', $client['port'], $data);
+        swoole_timer_after(100, function () use ($serv, $client, $queued) {
+            $rejected = $serv->sendto('255.255.255.255', $client['port'], 'again') === false;
+            $sent = $serv->sendto($client['address'], $client['port'], 'reply');
+            $serv->sendto($client['address'], $client['port'], json_encode([$queued, $rejected, $sent]));
+        });
+    });
+    $serv->start();
+};
+
+$pm->childFirst();
+$pm->run();
+?>
+--EXPECT--
+reply
+[true,true,true]
@@ -0,0 +1,51 @@
+--TEST--
+swoole_server: the request stays in flight until its coroutine ends
+--SKIPIF--
+<?php require __DIR__ . '/../include/skipif.inc'; ?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+$pm = new ProcessManager;
+$pm->parentFunc = function ($pid) use ($pm) {
+    $slow = new swoole_client(SWOOLE_SOCK_TCP, SWOOLE_SOCK_SYNC);
+    assert($slow->connect('127.0.0.1', $pm->getFreePort()));
+    $client = new swoole_client(SWOOLE_SOCK_TCP, SWOOLE_SOCK_SYNC);
+    assert($client->connect('127.0.0.1', $pm->getFreePort()));
+    assert($slow->send('slow'));
+    usleep(100 * 1000);
+    // the slow one yields in Co::sleep, the stats request counts itself too
+    assert($client->send('stats'));
+    echo $client->recv(), "\n";
+    echo $slow->recv(), "\n";
+    assert($client->send('stats'));
+    echo $client->recv(), "\n";
+    $pm->kill();
+};
+$pm->childFunc = function () use ($pm) {
+    $server = new swoole_server('127.0.0.1', $pm->getFreePort(), SWOOLE_PROCESS);
+    $server->set([
+        'log_file' => '/dev/null',
+        'worker_num' => 1,
+        'enable_coroutine' => true,
+    ]);
+    $server->on('workerStart', function ($serv, $wid) use ($pm) {
+        $pm->wakeup();
+    });
+    $server->on('receive', function (swoole_server $server, $fd, $rid, $data) {
+        if ($data === 'slow') {
+            Co::sleep(0.5);
+            $server->send($fd, 'done');
+            return;
+        }
+        $server->send($fd, json_encode($server->stats()['worker_inflight_num']));
+    });
+    $server->start();
+};
+$pm->childFirst();
+$pm->run();
+?>
+--EXPECT--
+[2]
+done
+[1]
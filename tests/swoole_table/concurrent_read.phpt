@@ -0,0 +1,52 @@
+--TEST--
+swoole_table: read rows while another process writes them
+--SKIPIF--
+<?php require __DIR__ . '/../include/skipif.inc'; ?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+$table = new swoole_table(1024);
+$table->column('a', swoole_table::TYPE_INT);
+$table->column('b', swoole_table::TYPE_INT);
+$table->column('s', swoole_table::TYPE_STRING, 32);
+$table->create();
+
+$writer = new swoole_process(function () use ($table) {
+    for ($i = 1; ; $i++) {
+        $key = 'k' . ($i % 16);
+        $table->set($key, ['a' => $i, 'b' => $i * 2, 's' => str_repeat((string) ($i % 10), $i % 32)]);
+        if ($i % 5 == 0) {
+            $table->del($key);
+        }
+    }
+});
+$writer->start();
+
+$readers = [];
+for ($n = 0; $n < 4; $n++) {
+    $reader = new swoole_process(function () use ($table) {
+        for ($i = 0; $i < 100000; $i++) {
+            $row = $table->get('k' . ($i % 16));
+            if ($row === false) {
+                continue;
+            }
+            if ($row['b'] !== $row['a'] * 2 or $row['s'] !== str_repeat((string) ($row['a'] % 10), $row['a'] % 32)) {
+                echo "torn row\n";
+                exit(1);
+            }
+        }
+    });
+    $reader->start();
+    $readers[] = $reader;
+}
+foreach ($readers as $reader) {
+    $status = swoole_process::wait();
+    assert($status['code'] === 0);
+}
+swoole_process::kill($writer->pid, SIGKILL);
+swoole_process::wait();
+echo "DONE\n";
+?>
+--EXPECT--
+DONE
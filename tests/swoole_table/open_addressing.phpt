@@ -0,0 +1,44 @@
+--TEST--
+swoole_table: open addressing layout
+--SKIPIF--
+<?php require __DIR__ . '/../include/skipif.inc'; ?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+$table = new swoole_table(1024, 0.2, swoole_table::LAYOUT_OPEN_ADDRESSING);
+$table->column('id', swoole_table::TYPE_INT);
+$table->column('name', swoole_table::TYPE_STRING, 32);
+assert($table->create());
+
+//the whole size is usable, not only what the conflict pool happens to allow
+for ($i = 0; $i < $table->size; $i++) {
+    assert($table->set("session_{$i}", ['id' => $i, 'name' => "user_{$i}"]));
+}
+assert(count($table) === $table->size);
+assert(@$table->set('one_more', ['id' => -1]) === false);
+
+assert($table->get('session_1', 'id') === 1);
+assert($table->get('session_') === false);
+assert(!$table->exist('session_1024'));
+$table->incr('session_7', 'id', 10);
+assert($table->get('session_7')['id'] === 17);
+
+for ($i = 0; $i < $table->size; $i += 2) {
+    assert($table->del("session_{$i}"));
+}
+assert(!$table->del('session_0'));
+assert(count($table) === $table->size / 2);
+assert($table->set('one_more', ['id' => -1, 'name' => 'new']));
+assert($table->get('one_more')['name'] === 'new');
+
+$n = 0;
+foreach ($table as $key => $row) {
+    assert($key === 'one_more' or $row['name'] === 'user_' . substr($key, 8));
+    $n++;
+}
+assert($n === count($table));
+echo "DONE\n";
+?>
+--EXPECT--
+DONE
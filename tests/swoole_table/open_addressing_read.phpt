@@ -0,0 +1,52 @@
+--TEST--
+swoole_table: open addressing read while the rows of other keys in the probe are replaced
+--SKIPIF--
+<?php require __DIR__ . '/../include/skipif.inc'; ?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+const KEY_N = 768;
+
+$table = new swoole_table(1024, 0.2, swoole_table::LAYOUT_OPEN_ADDRESSING);
+$table->column('id', swoole_table::TYPE_INT);
+$table->column('name', swoole_table::TYPE_STRING, 32);
+assert($table->create());
+for ($i = 0; $i < KEY_N; $i += 2) {
+    assert($table->set("k{$i}", ['id' => $i, 'name' => "user_{$i}"]));
+}
+
+//the odd keys come and go in the clusters of the even ones
+$writer = new swoole_process(function () use ($table) {
+    for ($n = 0; ; $n++) {
+        $i = ($n % (KEY_N / 2)) * 2 + 1;
+        $table->set("k{$i}", ['id' => $i, 'name' => "user_{$i}"]);
+        $table->del('k' . (($i + KEY_N / 2) % KEY_N | 1));
+    }
+});
+$writer->start();
+
+$readers = [];
+for ($n = 0; $n < 4; $n++) {
+    $reader = new swoole_process(function () use ($table) {
+        for ($i = 0; $i < 200000; $i++) {
+            $k = ($i % (KEY_N / 2)) * 2;
+            $row = $table->get("k{$k}");
+            if ($row === false or $row['id'] !== $k or $row['name'] !== "user_{$k}") {
+                echo "lost row\n";
+                exit(1);
+            }
+        }
+    });
+    $reader->start();
+    $readers[] = $reader;
+}
+foreach ($readers as $reader) {
+    $status = swoole_process::wait();
+    assert($status['code'] === 0);
+}
+swoole_process::kill($writer->pid, SIGKILL);
+swoole_process::wait();
+echo "DONE\n";
+?>
+--EXPECT--
+DONE
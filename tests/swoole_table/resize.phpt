@@ -0,0 +1,67 @@
+--TEST--
+swoole_table: open addressing table grows online up to max_size
+--SKIPIF--
+<?php require __DIR__ . '/../include/skipif.inc'; ?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+
+$table = new swoole_table(1024, 0.2, swoole_table::LAYOUT_OPEN_ADDRESSING, 32768);
+$table->column('id', swoole_table::TYPE_INT);
+$table->column('name', swoole_table::TYPE_STRING, 32);
+assert($table->create());
+
+$writers = [];
+for ($n = 0; $n < 2; $n++) {
+    $writer = new swoole_process(function () use ($table, $n) {
+        for ($i = 0; $i < 12000; $i++) {
+            if (!$table->set("w{$n}_{$i}", ['id' => $i, 'name' => "user_{$i}"])) {
+                echo "set failed\n";
+                exit(1);
+            }
+            if ($i % 3 == 2) {
+                $table->del("w{$n}_" . ($i - 1));
+            }
+        }
+    });
+    $writer->start();
+    $writers[] = $writer;
+}
+$reader = new swoole_process(function () use ($table) {
+    for ($i = 0; $i < 200000; $i++) {
+        $row = $table->get('w' . ($i % 2) . '_' . ($i % 12000));
+        if ($row !== false and $row['name'] !== 'user_' . $row['id']) {
+            echo "torn row\n";
+            exit(1);
+        }
+    }
+});
+$reader->start();
+
+for ($n = 0; $n < 3; $n++) {
+    $status = swoole_process::wait();
+    assert($status['code'] === 0);
+}
+
+assert(count($table) === 16000);
+for ($n = 0; $n < 2; $n++) {
+    for ($i = 0; $i < 12000; $i++) {
+        $row = $table->get("w{$n}_{$i}");
+        assert($i % 3 == 1 ? $row === false : $row['id'] === $i);
+    }
+}
+$n = 0;
+foreach ($table as $key => $row) {
+    $n++;
+}
+assert($n === 16000);
+
+//the chain layout has a fixed size
+$table = @new swoole_table(1024, 0.2, swoole_table::LAYOUT_CHAIN, 32768);
+$table->column('id', swoole_table::TYPE_INT);
+$table->create();
+assert($table->getMemorySize() < 1024 * 1024);
+echo "DONE\n";
+?>
+--EXPECT--
+DONE
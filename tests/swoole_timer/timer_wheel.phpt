@@ -0,0 +1,45 @@
+--TEST--
+swoole_timer: timer wheel backend
+--SKIPIF--
+<?php require __DIR__ . '/../include/skipif.inc'; ?>
+--FILE--
+<?php
+require __DIR__ . '/../include/bootstrap.php';
+swoole_async_set(['use_timer_wheel' => true]);
+
+$fired = [];
+$timers = [];
+foreach ([300, 5, 20, 1, 1000, 20] as $i => $ms) {
+    $timers[$i] = swoole_timer_after($ms, function () use (&$fired, $i, $ms) {
+        $fired[] = "{$i}:{$ms}";
+    });
+}
+assert(swoole_timer_exists($timers[4]));
+assert(swoole_timer_clear($timers[4]));
+assert(!swoole_timer_exists($timers[4]));
+
+$count = 0;
+swoole_timer_tick(10, function ($id) use (&$count) {
+    if (++$count == 5) {
+        swoole_timer_clear($id);
+    }
+});
+
+// a timer never fires early, how late it fires depends on the load of the machine
+$start = microtime(true);
+swoole_timer_after(500, function () use (&$fired, $start) {
+    assert(microtime(true) - $start >= 0.499);
+    $fired[] = "6:500";
+});
+swoole_event_wait();
+echo implode("\n", $fired) . "\n";
+echo "tick: {$count}\n";
+?>
+--EXPECTF--
+3:1
+1:5
+%d:20
+%d:20
+0:300
+6:500
+tick: 5